@@ -16,75 +16,182 @@
 
 #include <allheaders.h>
 
+#include <dlib/threads.h>
+
+#include <algorithm>
 #include <assert.h>
 #include <exception>
+#include <map>
 #include <string>
 #include <vector>
 
+// saves the colored groundtruth and results images that are evaluated
+// (to the groundtruth's coloredImages and results' coloredEval subdirs)
+//#define SAVE_COLORED_EVAL_IMAGES
+
 Evaluator::Evaluator(
     std::string resultsDirPath,
     std::string groundtruthDirPath,
     bool typeSpecificMode)
-: coloredImageSubDirName("coloredImages") {
+: coloredImageSubDirName("coloredImages"),
+  groundtruthRectFileName("groundtruth.rect"),
+  resultsRectFileName("results.rect") {
   this->resultsDirPath = Utils::checkTrailingSlash(resultsDirPath);
   this->groundtruthDirPath = Utils::checkTrailingSlash(groundtruthDirPath);
   this->typeSpecificMode = typeSpecificMode;
+}
 
-  this->coloredGroundtruthImageDirPath = Utils::checkTrailingSlash(this->groundtruthDirPath) + coloredImageSubDirName + std::string("/");
-
-  this->groundtruthRectFilePath = this->groundtruthDirPath + std::string("groundtruth.rect");
-  this->resultsRectFilePath = this->resultsDirPath + std::string("results.rect");
+Evaluator::~Evaluator() {
+  clearRuns();
 }
 
 
 void Evaluator::evaluateSingleRun() {
 
-  // 1. Verify the groundtruth dir and results dir are in the correct formats
-  if(!verifyResultsAndGroundtruthPaths()) {
+  // 1. Verify the groundtruth dir and results dir are in the correct formats,
+  //    then read in the groundtruth and results rectangles for every image.
+  //    The foreground pixels of each input image are colored in memory based
+  //    on these (once for the groundtruth and once for the results). The
+  //    colored pixels are what's used for pixel accurate evaluation.
+  clearRuns();
+  if(!addRun(resultsDirPath, resultsDirPath, groundtruthDirPath)) {
     return;
   }
 
-  // 2. Grab paths to the input images
-   inputImagePaths = DatasetSelectionMenu::findGroundtruthImagePaths(groundtruthDirPath);
-
-  // 3. Copy the original images in the groundtruth dir to a subdir and color
-  //    the foreground pixels of the copies based on the contents of the .rect file
-  //    if not done already. The colored foreground pixels can be used for pixel
-  //    accurate evaluation.
-  //    Create the colored copies of each image if they don't already exist
-  //    This involves coloring the foreground pixels of each input image based on the .rect file contents
-  if(!coloredImageCopiesExist(inputImagePaths)) {
-    if(!colorGroundtruthBlobs()) {
-      return;
-    }
+  // 2. Run the evaluation logic
+  if(!evaluateRuns()) {
+    return;
   }
+  const EvaluationRun& run = runs[0];
+  std::cout << "Finished evaluating images in " << run.resultsDirPath << std::endl;
 
-  // Grab the paths to the colored images
-  coloredGroundtruthImagePaths = DatasetSelectionMenu::findGroundtruthImagePaths(coloredGroundtruthImageDirPath);
-  coloredResultsImagePaths = DatasetSelectionMenu::findGroundtruthImagePaths(
-      Utils::checkTrailingSlash(resultsDirPath) + std::string("coloredEval/"));
+  // 3. Print all the metrics to a file in a subdir of the results directory
+  printRunMetrics(run, getDatasetAverages(run.pageMetrics));
+}
 
-  if(coloredGroundtruthImagePaths.size() != coloredResultsImagePaths.size()) {
-    std::cout << "ERROR there are different numbers of colored images in the groundtruth from the results dirs.\n";
-    return;
+bool Evaluator::addRun(const std::string& name, const std::string& resultsDir,
+    const std::string& groundtruthDir) {
+  const std::string runResultsDirPath = Utils::checkTrailingSlash(resultsDir);
+  const std::string runGroundtruthDirPath = Utils::checkTrailingSlash(groundtruthDir);
+  if(!verifyResultsAndGroundtruthPaths(runResultsDirPath, runGroundtruthDirPath)) {
+    return false;
   }
-
-  if(coloredGroundtruthImagePaths.size() != inputImagePaths.size()) {
-    std::cout << "ERROR there are different numbers of colored images than there are input images.\n";
-    return;
+  runs.push_back(EvaluationRun());
+  const int runIndex = runs.size() - 1;
+  runs[runIndex].name = name;
+  runs[runIndex].resultsDirPath = runResultsDirPath;
+  if(!readRectFile(runResultsDirPath + resultsRectFileName,
+      runs[runIndex].resultsRects)) {
+    return false;
   }
+#ifdef SAVE_COLORED_EVAL_IMAGES
+  Utils::exec(std::string("mkdir -p ") + runResultsDirPath + std::string("coloredEval/"));
+#endif
+
+  // the groundtruth is only read in by the first run that uses it
+  for(int i = 0; i < groundtruthSets.size(); ++i) {
+    if(groundtruthSets[i].groundtruthDirPath == runGroundtruthDirPath) {
+      groundtruthSets[i].runIndices.push_back(runIndex);
+      return true;
+    }
+  }
+  groundtruthSets.push_back(GroundtruthSet());
+  GroundtruthSet& groundtruth = groundtruthSets.back();
+  groundtruth.groundtruthDirPath = runGroundtruthDirPath;
+  groundtruth.runIndices.push_back(runIndex);
+  groundtruth.inputImagePaths =
+      DatasetSelectionMenu::findGroundtruthImagePaths(runGroundtruthDirPath);
+
+  // sanity checks
+  for(int i = 0; i < groundtruth.inputImagePaths.size(); ++i) {
+    if(!checkImNameMatchesIndex(groundtruth.inputImagePaths[i], i)) {
+      std::cout << "One of the input image names doesn't match its index. This would cause problems so exiting.\n";
+      return false;
+    }
+  }
+#ifdef SAVE_COLORED_EVAL_IMAGES
+  const std::string coloredGroundtruthImageDirPath =
+      runGroundtruthDirPath + coloredImageSubDirName + std::string("/");
+  Utils::exec(std::string("rm -rf ") + coloredGroundtruthImageDirPath);
+  Utils::exec(std::string("mkdir -p ") + coloredGroundtruthImageDirPath);
+#endif
+  return readRectFile(runGroundtruthDirPath + groundtruthRectFileName,
+      groundtruth.groundtruthRects);
+}
 
-  // 4. Run the evaluation logic
-  std::vector<std::vector<HypothesisMetrics> > all_dataset_metrics;   // the metrics for each page of the dataset being evaluated
-  for(int i = 0; i < inputImagePaths.size(); ++i) {
+void Evaluator::clearRuns() {
+  for(int i = 0; i < runs.size(); ++i) {
+    destroyRects(runs[i].resultsRects);
+  }
+  for(int i = 0; i < groundtruthSets.size(); ++i) {
+    destroyRects(groundtruthSets[i].groundtruthRects);
+  }
+  runs.clear();
+  groundtruthSets.clear();
+  pageJobs.clear();
+}
 
-    // sanity checks
-    if(!checkImNameMatchesIndex(inputImagePaths[i], i) ||
-        !checkImNameMatchesIndex(coloredGroundtruthImagePaths[i], i) ||
-        !checkImNameMatchesIndex(coloredResultsImagePaths[i], i)) {
-      std::cout << "One of the results/input image names doesn't match its index. This would cause problems so exiting.\n";
-      return;
+bool Evaluator::evaluateRuns() {
+  // Every page of every groundtruth set is a job for the thread pool. Each
+  // run's metrics for a page go in their own slot so they come out in page
+  // order no matter which pages finish first.
+  pageJobs.clear();
+  for(int i = 0; i < groundtruthSets.size(); ++i) {
+    const GroundtruthSet& groundtruth = groundtruthSets[i];
+    const int numPages = groundtruth.inputImagePaths.size();
+    if(numPages == 0) {
+      std::cout << "ERROR: There aren't any images to evaluate in "
+          << groundtruth.groundtruthDirPath << std::endl;
+      return false;
+    }
+    for(int j = 0; j < groundtruth.runIndices.size(); ++j) {
+      runs[groundtruth.runIndices[j]].pageMetrics.assign(
+          numPages, std::vector<HypothesisMetrics>());
+    }
+    for(int j = 0; j < numPages; ++j) {
+      pageJobs.push_back(std::make_pair(i, j));
     }
+  }
+  const int numJobs = pageJobs.size();
+  {
+    dlib::thread_pool threadPool(
+        std::max(1, std::min(Utils::getNumProcessors(), numJobs)));
+    for(int i = 0; i < numJobs; ++i) {
+      threadPool.add_task(*this, &Evaluator::evaluatePage, (long)i);
+    }
+    threadPool.wait_for_all_tasks();
+  }
+  pageJobs.clear();
+  return true;
+}
+
+void Evaluator::evaluatePage(long pageJob) {
+  const GroundtruthSet& groundtruth = groundtruthSets[pageJobs[pageJob].first];
+  const int i = pageJobs[pageJob].second;
+
+  // read in and color the groundtruth for the page once for all of the
+  // runs being evaluated against it
+  Pix* inputImage = readInColorImage(groundtruth.inputImagePaths[i]);
+  Pix* binaryImage = readInBinaryImage(groundtruth.inputImagePaths[i]);
+  Pix* groundtruthImage = colorRectForeground(binaryImage,
+      getPageRects(groundtruth.groundtruthRects, i));
+#ifdef SAVE_COLORED_EVAL_IMAGES
+  pixWrite((groundtruth.groundtruthDirPath + coloredImageSubDirName + std::string("/")
+      + Utils::intToString(i) + ".png").c_str(), groundtruthImage, IFF_PNG);
+#endif
+
+  for(int r = 0; r < groundtruth.runIndices.size(); ++r) {
+    EvaluationRun& run = runs[groundtruth.runIndices[r]];
+
+    // color the run's results for the page, then make the masks that all
+    // of the types are evaluated from with one pass over it
+    Pix* resultsImage = colorRectForeground(binaryImage,
+        getPageRects(run.resultsRects, i));
+#ifdef SAVE_COLORED_EVAL_IMAGES
+    pixWrite((run.resultsDirPath + std::string("coloredEval/")
+        + Utils::intToString(i) + ".png").c_str(), resultsImage, IFF_PNG);
+#endif
+    PageMasks masks(groundtruthImage, resultsImage, inputImage);
 
     // page metrics can be separated out by the type of element being evaluated
     // or all combined together. in the former case there will be multiple metrics
@@ -94,10 +201,12 @@ void Evaluator::evaluateSingleRun() {
     if(typeSpecificMode) {
       // evaluate each type separately
       HypothesisMetrics disp_metrics = getEvaluationMetrics(
-          (std::string)"displayed", i);
+          (std::string)"displayed", groundtruth, run, i, inputImage,
+          groundtruthImage, resultsImage, masks);
       page_metrics.push_back(disp_metrics);
       HypothesisMetrics emb_metrics = getEvaluationMetrics(
-          (std::string)"embedded", i);
+          (std::string)"embedded", groundtruth, run, i, inputImage,
+          groundtruthImage, resultsImage, masks);
       page_metrics.push_back(emb_metrics);
       //HypothesisMetrics label_metrics = getEvaluationMetrics(
      //     (std::string)"label", i);
@@ -106,30 +215,37 @@ void Evaluator::evaluateSingleRun() {
     else {
       // evaluate all of the above types (considering them all the same)
       HypothesisMetrics all_metrics = getEvaluationMetrics(
-          (std::string)"all", i);
+          (std::string)"all", groundtruth, run, i, inputImage,
+          groundtruthImage, resultsImage, masks);
       page_metrics.push_back(all_metrics);
     }
     } catch (std::exception& e) {
       std::cout << "ERROR: Exception caught while running the evaluation.\n";
     }
-    all_dataset_metrics.push_back(page_metrics);
+    pixDestroy(&resultsImage);
+    run.pageMetrics[i] = page_metrics; // only this job touches the run's slot for the page
   }
-  assert(all_dataset_metrics.size() == inputImagePaths.size());
-  std::cout << "Finished evaluating images in " << resultsDirPath << std::endl;
-
-
-
-  std::vector<DatasetMetrics> avg_dataset_metrics = getDatasetAverages(all_dataset_metrics);
+  pixDestroy(&inputImage);
+  pixDestroy(&binaryImage);
+  pixDestroy(&groundtruthImage);
+}
 
-  // print all the metrics to a file in a subdir of the results directory
-  string final_res_dir = resultsDirPath + "eval/";
+void Evaluator::printRunMetrics(const EvaluationRun& run,
+    const std::vector<DatasetMetrics>& run_averages) {
+  string final_res_dir = run.resultsDirPath + "eval/";
   exec("rm -rf " + final_res_dir);
   exec("mkdir " + final_res_dir);
   string final_res_file = final_res_dir + "metrics";
   ofstream metric_stream(final_res_file.c_str());
-  MetricsPrinter::printDatasetMetrics(all_dataset_metrics, metric_stream);
+  MetricsPrinter::printDatasetMetrics(run.pageMetrics, metric_stream);
   metric_stream << "-----------------------------------------\n";
-  MetricsPrinter::printAvgMetrics(avg_dataset_metrics, metric_stream);
+  MetricsPrinter::printAvgMetrics(run_averages, metric_stream);
+}
+
+const std::vector<RectEntry>& Evaluator::getPageRects(
+    const std::map<int, std::vector<RectEntry> >& rects, const int i) const {
+  std::map<int, std::vector<RectEntry> >::const_iterator found = rects.find(i);
+  return (found == rects.end()) ? noRects : found->second;
 }
 
 vector<DatasetMetrics> Evaluator::getDatasetAverages(
@@ -167,6 +283,35 @@ vector<DatasetMetrics> Evaluator::getDatasetAverages(
   return datasetAverages;
 }
 
+vector<DatasetMetrics> Evaluator::getFullAverage(
+    const vector<vector<DatasetMetrics> >& run_averages) {
+  const int num_runs = run_averages.size();
+  const int num_res_types = run_averages[0].size(); // all of the runs are evaluated on the same expression type(s)
+
+  // Initialize the output
+  vector<DatasetMetrics> fullAverages;
+  fullAverages.reserve(num_res_types);
+  for(int i = 0; i < num_res_types; ++i) {
+    DatasetMetrics metric;
+    metric.res_type_name = run_averages[0][i].res_type_name;
+    fullAverages.push_back(metric);
+  }
+
+  // Aggregate each run's averages for each expression type, then divide by the
+  // number of runs. Every run counts the same regardless of how many pages it has.
+  for(int i = 0; i < num_runs; ++i) {
+    assert(run_averages[i].size() == num_res_types);
+    for(int k = 0; k < num_res_types; ++k) {
+      fullAverages[k].appendDatasetMetrics(run_averages[i][k]);
+    }
+  }
+  for(int k = 0; k < num_res_types; ++k) {
+    fullAverages[k].divideMetrics(num_runs);
+  }
+
+  return fullAverages;
+}
+
 
 bool Evaluator::checkImNameMatchesIndex(const std::string& imName, const int index) {
   if(Utils::getNameFromPath(imName) != Utils::intToString(index)) {
@@ -176,36 +321,74 @@ bool Evaluator::checkImNameMatchesIndex(const std::string& imName, const int ind
   return true;
 }
 
-bool Evaluator::coloredImageCopiesExist(const std::vector<std::string>& inputImagePaths) {
-  if(!Utils::existsDirectory(coloredGroundtruthImageDirPath)) {
-    return false;
-  }
-  for(int i = 0; i < inputImagePaths.size(); ++i) {
-    if(!Utils::existsFile(Utils::checkTrailingSlash(coloredGroundtruthImageDirPath) +
-        Utils::intToString(i) + std::string("*"))) {
-      return false;
+void Evaluator::evaluateMultipleRuns() {
+
+  // 1. Find the runs (the subdirectories of the results directory with a
+  //    results .rect file) and the groundtruth each is evaluated against.
+  //    Runs sharing a groundtruth directory share its rectangles and the
+  //    colored groundtruth for each of its pages.
+  clearRuns();
+  const bool sharedGroundtruth =
+      Utils::existsFile(groundtruthDirPath + groundtruthRectFileName);
+  const std::vector<std::string> entries = Utils::getFileList(resultsDirPath);
+  for(int i = 0; i < entries.size(); ++i) {
+    const std::string runDirPath = resultsDirPath + entries[i] + std::string("/");
+    if(!Utils::existsFile(runDirPath + resultsRectFileName)) {
+      continue; // not a run (e.g., the eval subdirectory written below)
+    }
+    const std::string runGroundtruthDirPath = sharedGroundtruth ?
+        groundtruthDirPath : groundtruthDirPath + entries[i] + std::string("/");
+    if(!addRun(entries[i], runDirPath, runGroundtruthDirPath)) {
+      std::cout << "ERROR: Could not evaluate the run in " << runDirPath << std::endl;
+      return;
     }
   }
-  return true;
-}
-
-// Actually may not have time for this... Oh well.
-void Evaluator::evaluateMultipleRuns() {
-//  std::vector<std::string>
+  if(runs.empty()) {
+    std::cout << "ERROR: None of the subdirectories of " << resultsDirPath
+        << " have a " << resultsRectFileName << " file to evaluate.\n";
+    return;
+  }
+  std::cout << "Evaluating " << runs.size() << " runs against "
+      << groundtruthSets.size() << " groundtruth directories.\n";
 
-//  vector<DatasetMetrics> overall_averages = getFullAverage(avg_dataset_metrics);
-//  metric_stream << "-----------------------------------------\n";
-//  printOverallAvg(overall_averages, metric_stream);
-//  cout << "Final metrics were printed to " << final_res_file << endl;
+  // 2. Run the evaluation logic on all of the runs together
+  if(!evaluateRuns()) {
+    return;
+  }
 
+  // 3. Print each run's metrics to its own results directory, then the
+  //    averages for each run along with the average of all of them to the
+  //    results directory
+  std::vector<std::vector<DatasetMetrics> > run_averages;
+  for(int i = 0; i < runs.size(); ++i) {
+    run_averages.push_back(getDatasetAverages(runs[i].pageMetrics));
+    printRunMetrics(runs[i], run_averages.back());
+    std::cout << "Finished evaluating images in " << runs[i].resultsDirPath << std::endl;
+  }
+  vector<DatasetMetrics> overall_averages = getFullAverage(run_averages);
+  string final_res_dir = resultsDirPath + "eval/";
+  exec("rm -rf " + final_res_dir);
+  exec("mkdir " + final_res_dir);
+  string final_res_file = final_res_dir + "metrics";
+  ofstream metric_stream(final_res_file.c_str());
+  for(int i = 0; i < runs.size(); ++i) {
+    metric_stream << "Run " << runs[i].name << ":\n";
+    MetricsPrinter::printAvgMetrics(run_averages[i], metric_stream);
+  }
+  metric_stream << "-----------------------------------------\n";
+  MetricsPrinter::printOverallAvg(overall_averages, metric_stream);
+  cout << "Final metrics were printed to " << final_res_file << endl;
 }
 
+
 /**
  * Throws exception if fails
  */
 HypothesisMetrics Evaluator::getEvaluationMetrics(
-    const std::string typenamespec, const int i) {
-  std::string evalTopDir = resultsDirPath + std::string("MathFinderEvaluationResults/");
+    const std::string typenamespec, const GroundtruthSet& groundtruth,
+    const EvaluationRun& run, const int i, Pix* inputImage,
+    Pix* groundtruthImage, Pix* resultsImage, const PageMasks& masks) {
+  std::string evalTopDir = run.resultsDirPath + std::string("MathFinderEvaluationResults/");
   if(!Utils::existsDirectory(evalTopDir)) {
     Utils::exec((std::string)"mkdir -p " + evalTopDir);
   }
@@ -233,17 +416,19 @@ HypothesisMetrics Evaluator::getEvaluationMetrics(
   }
 
   // The first step is to create the bipartite graph data structure
-  // for the image
+  // for the image (the graph destroys its images when cleared, so it
+  // gets its own references to the page's images)
   GraphInput gi;
 
-  gi.gtboxfile = groundtruthRectFilePath;
-  gi.gtimg = readInColorImage(coloredGroundtruthImagePaths[i]);
-  gi.hypboxfile = resultsRectFilePath;
-  gi.hypimg = readInColorImage(coloredResultsImagePaths[i]);
-  gi.imgname = Utils::getNameFromPath(inputImagePaths[i]);
+  gi.gtrects = &getPageRects(groundtruth.groundtruthRects, i);
+  gi.gtimg = pixClone(groundtruthImage);
+  gi.hyprects = &getPageRects(run.resultsRects, i);
+  gi.hypimg = pixClone(resultsImage);
+  gi.masks = &masks;
+  gi.imgname = Utils::getNameFromPath(groundtruth.inputImagePaths[i]);
   gi.evalTopDir = evalTopDir;
   gi.dbgdir = this_dbgdir;
-  gi.inimg = readInColorImage(inputImagePaths[i]);
+  gi.inimg = pixClone(inputImage);
   BipartiteGraph pixelGraph(typenamespec, gi);
 
   // Now get and print the metrics
@@ -269,142 +454,127 @@ Pix* Evaluator::readInColorImage(const std::string& imagePath) {
 }
 
 
+Pix* Evaluator::readInBinaryImage(const std::string& imagePath) {
+  Pix* image = Utils::leptReadImg(imagePath);
+  tesseract::ImageThresholder imageThresholder; // one per page being evaluated
+  imageThresholder.SetImage(image);
+  if(!imageThresholder.IsBinary()) {
+    pixDestroy(&image); // thresholder clones/copies/converts the input in SetImage, so no need to hold onto the original
+    imageThresholder.ThresholdToPix(&image); // replace original image with the binarized one
+  }
+  imageThresholder.Clear();
+  return image;
+}
+
 /*************************************************************************
-* Reads in the .rect file and the input images in the user-specified groundtruth
-* directory. Colors the foreground pixels of the input images based on the
-* groundtruth data in the .rect file (i.e., color displayed math as red,
-* embedded as blue, label as green). The colored images are stored in a subdir of the
-* specified groundtruth. These colored images allow for pixel-accurate evaluation.
+* Reads in the .rect file at the given path. Each line has the following
+* format:
+*
+*   #.ext type left top right bottom
+*
+* Images without any rectangles can have a single entry with -1's, which
+* isn't included in the map.
 *
 * Returns true on success, false if there's any error
 *************************************************************************/
-bool Evaluator::colorGroundtruthBlobs() {
-
-  // Make sure the directory is fresh
-  if(Utils::existsDirectory(coloredGroundtruthImageDirPath)) {
-    Utils::exec(std::string("rm -rf ") + coloredGroundtruthImageDirPath);
-  }
-  Utils::exec(std::string("mkdir -p ") + coloredGroundtruthImageDirPath);
-
-  // open the groundtruth text file which holds all of the math rectangles
-  std::ifstream gtFileStream;
-  gtFileStream.open(groundtruthRectFilePath.c_str());
-  if(!gtFileStream.is_open()) {
+bool Evaluator::readRectFile(const std::string& rectFilePath,
+    std::map<int, std::vector<RectEntry> >& rects) {
+  std::ifstream rectFileStream;
+  rectFileStream.open(rectFilePath.c_str());
+  if(!rectFileStream.is_open()) {
     std::cout << "ERROR: Could not open the file at "
-         << groundtruthRectFilePath << endl;
+         << rectFilePath << endl;
     return false;
   }
-
-  // Now start reading and coloring
   std::string line;
-
-  int curfilenum = -1;
-  int expectedfilenum = 1;
-  Pix* curimg;
-  int linenum = 1;
-
-
-  while(getline(gtFileStream, line)) {
+  while(getline(rectFileStream, line)) {
     // parse the line
     if(line.empty()) {
       continue;
     }
     std::vector<std::string> splitline = Utils::stringSplit(line);
+    if(splitline.size() < 6) {
+      std::cout << "ERROR: Invalid line in " << rectFilePath << ": " << line << endl;
+      return false;
+    }
     const std::string filename   = splitline[0];
     const std::string recttype   = splitline[1];
     const int rectleft = atoi(splitline[2].c_str());
     const int recttop = atoi(splitline[3].c_str());
     const int rectright = atoi(splitline[4].c_str());
     const int rectbottom = atoi(splitline[5].c_str());
-    int fileNumTmp; // throw-away variable
-    {
-      std::vector<std::string> tmp = Utils::stringSplit(filename, '.');
-      fileNumTmp = atoi(tmp[0].c_str());
-    }
-    const int fileNum = fileNumTmp;
-
-    // open the image if it isn't already opened
-    // save the previous one if applicable
-    if(curfilenum != fileNum) {
-      std::cout << "Coloring groundtruth blobs for image " << fileNum << endl;
-      if(curfilenum != -1) {
-        // save previous and then deallocate it
-        std::string savename = coloredGroundtruthImageDirPath + Utils::intToString(curfilenum) + ".png";
-        pixWrite(savename.c_str(), curimg, IFF_PNG);
-        pixDestroy(&curimg);
-        imageThresholder.Clear();
-      }
-      curimg = Utils::leptReadImg(groundtruthDirPath + filename);
-      imageThresholder.SetImage(curimg);
-      if (!imageThresholder.IsBinary()) {
-        pixDestroy(&curimg); // thresholder clones/copies/converts the input in SetImage, so no need to hold onto the original
-        imageThresholder.ThresholdToPix(&curimg); // replace original image with the binarized one
-      }
-      curimg = pixConvertTo32(curimg);
-      curfilenum = fileNum;
-    }
-    // now color the foreground regions of the image in the
-    // rectangle based on the rectangle's type
+    const int fileNum = atoi(Utils::stringSplit(filename, '.')[0].c_str());
     if(rectleft == -1 || recttop == -1 ||
         rectright == -1 || rectbottom == -1)
       continue; // if the image has nothing then it should have a single entry with -1's
-    BOX* box = boxCreate(rectleft, recttop,
-        rectright - rectleft, rectbottom - recttop);
-    LayoutEval::Color color;
-    if(recttype == "displayed")
-      color = LayoutEval::RED;
-    else if(recttype == "embedded")
-      color = LayoutEval::BLUE;
-    else if(recttype == "label")
-      color = LayoutEval::GREEN;
-    else {
+    if(recttype != "displayed" && recttype != "embedded" && recttype != "label") {
       std::cout << "ERROR: Rectangle of unknown type in .rect file.\n";
       return false;
     }
-    Lept_Utils::fillBoxForeground(curimg, box, color);
-    boxDestroy(&box);
-    linenum++;
+    RectEntry entry;
+    entry.type = recttype;
+    entry.box = boxCreate(rectleft, recttop,
+        rectright - rectleft, rectbottom - recttop);
+    rects[fileNum].push_back(entry);
   }
-
-  // save and destroy the final image
-  const std::string savename = coloredGroundtruthImageDirPath + Utils::intToString(curfilenum) + ".png";
-  pixWrite(savename.c_str(), curimg, IFF_PNG);
-  pixDestroy(&curimg);
-  gtFileStream.close();
+  rectFileStream.close();
   return true; // success
 }
 
-bool Evaluator::verifyResultsAndGroundtruthPaths() {
+void Evaluator::destroyRects(std::map<int, std::vector<RectEntry> >& rects) {
+  for(std::map<int, std::vector<RectEntry> >::iterator it = rects.begin();
+      it != rects.end(); ++it) {
+    for(int i = 0; i < it->second.size(); ++i) {
+      boxDestroy(&(it->second[i].box));
+    }
+  }
+  rects.clear();
+}
+
+Pix* Evaluator::colorRectForeground(Pix* binaryImage,
+    const std::vector<RectEntry>& rects) {
+  Pix* coloredImage = pixConvertTo32(binaryImage);
+  for(int i = 0; i < rects.size(); ++i) {
+    const std::string& recttype = rects[i].type;
+    const LayoutEval::Color color = (recttype == "displayed") ? LayoutEval::RED
+        : (recttype == "embedded") ? LayoutEval::BLUE : LayoutEval::GREEN;
+    Lept_Utils::fillBoxForeground(coloredImage, rects[i].box, color);
+  }
+  return coloredImage;
+}
+
+bool Evaluator::verifyResultsAndGroundtruthPaths(const std::string& resultsDir,
+    const std::string& groundtruthDir) {
 
   // Make sure the folders aren't identical
-  if(resultsDirPath == groundtruthDirPath) {
+  if(resultsDir == groundtruthDir) {
     std::cout << "ERROR: The results directory cannot be the same as the groundtruth one.\n";
     return false;
   }
 
   // Make sure the results dir contains all the results in one .rect file
   // and that the groundtruth dir also contains its groundtruth in one .rect file
-  if(!verifyOneRectFileAt(resultsDirPath) ||
-      !verifyOneRectFileAt(groundtruthDirPath)) {
+  if(!verifyOneRectFileAt(resultsDir) ||
+      !verifyOneRectFileAt(groundtruthDir)) {
     return false;
   }
 
   // Verify the groundtruth .rect file has the expected name
-  if(!Utils::existsFile(groundtruthRectFilePath)) {
+  if(!Utils::existsFile(groundtruthDir + groundtruthRectFileName)) {
     std::cout << "ERROR: The groundtruth .rect file is expected to be named as follows: "
-        << groundtruthRectFilePath << ". A file with that path could not be found.\n";
+        << groundtruthDir + groundtruthRectFileName << ". A file with that path could not be found.\n";
     return false;
   }
 
   // Verify the results .rect file has the expected name
-  if(!Utils::existsFile(resultsRectFilePath)) {
+  if(!Utils::existsFile(resultsDir + resultsRectFileName)) {
     std::cout << "ERROR: The results .rect file is expected to be named as follows: "
-        << resultsRectFilePath << ". A file with that path could not be found.\n";
+        << resultsDir + resultsRectFileName << ". A file with that path could not be found.\n";
     return false;
   }
 
   // Make sure the groundtruth dir is in the expected format
-  return DatasetSelectionMenu::groundtruthDirPathIsGood(groundtruthDirPath);
+  return DatasetSelectionMenu::groundtruthDirPathIsGood(groundtruthDir);
 }
 
 bool Evaluator::verifyOneRectFileAt(const std::string& dirPath) {
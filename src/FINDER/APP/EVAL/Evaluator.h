@@ -9,8 +9,16 @@
 #define EVALUATOR_H_
 
 #include <DatasetMetrics.h>
+#include <PageMasks.h>
 #include <baseapi.h>
 
+#include <allheaders.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 /********************************************************************************
 * Evaluate layout accuracy.                                                     *
 *                                                                               *
@@ -26,6 +34,8 @@
 *                                                                               *
 * Takes the groundtruth data                                                    *
 * and uses it to color the blobs of interest appropriately based on their type. *
+* The results are colored the same way. Both are colored in memory straight     *
+* from the .rect files and the binarized input page.                            *
 *                                                                               *
 ********************************************************************************/
 class Evaluator {
@@ -36,41 +46,110 @@ class Evaluator {
       std::string groundtruthPath,
       bool typeSpecificMode);
 
+  ~Evaluator();
+
   void evaluateSingleRun();
 
+  // evaluates each subdirectory of the results directory that has a
+  // results .rect file as its own run. the runs are all evaluated against
+  // the groundtruth directory if it has a groundtruth .rect file, otherwise
+  // each one is evaluated against the groundtruth subdirectory with its name.
+  // the averages over all of the runs are printed to the results
+  // directory's eval subdirectory.
   void evaluateMultipleRuns();
 
  private:
 
-  bool verifyResultsAndGroundtruthPaths();
+  // a results directory being evaluated, its rectangles, and the metrics
+  // for each of its pages
+  struct EvaluationRun {
+    std::string name;
+    std::string resultsDirPath;
+    std::map<int, std::vector<RectEntry> > resultsRects;
+    std::vector<std::vector<HypothesisMetrics> > pageMetrics;
+  };
+
+  // a groundtruth directory along with the runs evaluated against it. its
+  // rectangles are read in once and each of its pages is read in and colored
+  // once no matter how many runs there are.
+  struct GroundtruthSet {
+    std::string groundtruthDirPath;
+    std::vector<std::string> inputImagePaths;
+    std::map<int, std::vector<RectEntry> > groundtruthRects;
+    std::vector<int> runIndices;
+  };
+
+  bool verifyResultsAndGroundtruthPaths(const std::string& resultsDir,
+      const std::string& groundtruthDir);
   bool verifyOneRectFileAt(const std::string& dirPath);
 
-  bool colorGroundtruthBlobs();
-  bool coloredImageCopiesExist(const std::vector<std::string>& inputImagePaths);
+  // adds a run for the results in the given directory to be evaluated
+  // against the groundtruth in the other, reading in the groundtruth only
+  // if no other run has already used it. returns false if either directory
+  // isn't in the expected format.
+  bool addRun(const std::string& name, const std::string& resultsDir,
+      const std::string& groundtruthDir);
+  void clearRuns();
+
+  // evaluates every page of every run that was added, returns false if
+  // there's any error
+  bool evaluateRuns();
+
+  // reads in all the rectangles in the .rect file at the given path,
+  // mapping each image's number to its rectangles (in file order)
+  bool readRectFile(const std::string& rectFilePath,
+      std::map<int, std::vector<RectEntry> >& rects);
+  void destroyRects(std::map<int, std::vector<RectEntry> >& rects);
+
+  // returns a 32 bpp copy of the binarized page with the foreground pixels
+  // in each of the rectangles colored based on the rectangle's type
+  // (i.e., displayed math as red, embedded as blue, label as green)
+  Pix* colorRectForeground(Pix* binaryImage,
+      const std::vector<RectEntry>& rects);
 
   bool checkImNameMatchesIndex(const std::string& name, const int index);
 
   Pix* readInColorImage(const std::string& imagePath);
+  Pix* readInBinaryImage(const std::string& imagePath);
+
+  // evaluates one page of a groundtruth set for each of the runs using it
+  // and each of the types being evaluated, run on the thread pool in
+  // evaluateRuns
+  void evaluatePage(long pageJob);
+
+  // gets the rectangles for the image at the given index
+  const std::vector<RectEntry>& getPageRects(
+      const std::map<int, std::vector<RectEntry> >& rects,
+      const int imageIndex) const;
 
   HypothesisMetrics getEvaluationMetrics(const std::string typenamespec,
-      const int imageIndex);
+      const GroundtruthSet& groundtruth, const EvaluationRun& run,
+      const int imageIndex, Pix* inputImage, Pix* groundtruthImage,
+      Pix* resultsImage, const PageMasks& masks);
   std::vector<DatasetMetrics> getDatasetAverages(
       const std::vector<std::vector<HypothesisMetrics> >& all_metrics);
 
+  // averages the averages of each run
+  std::vector<DatasetMetrics> getFullAverage(
+      const std::vector<std::vector<DatasetMetrics> >& run_averages);
+
+  // prints the run's metrics for each page and its averages to the eval
+  // subdirectory of its results directory
+  void printRunMetrics(const EvaluationRun& run,
+      const std::vector<DatasetMetrics>& run_averages);
+
   std::string resultsDirPath;
   std::string groundtruthDirPath;
   bool typeSpecificMode;
 
   const std::string coloredImageSubDirName;
-  std::string coloredGroundtruthImageDirPath;
-  std::string groundtruthRectFilePath;
-  std::string resultsRectFilePath;
-
-  std::vector<std::string> inputImagePaths;
-  std::vector<std::string> coloredGroundtruthImagePaths;
-  std::vector<std::string> coloredResultsImagePaths;
+  const std::string groundtruthRectFileName;
+  const std::string resultsRectFileName;
 
-  tesseract::ImageThresholder imageThresholder;
+  std::vector<EvaluationRun> runs;
+  std::vector<GroundtruthSet> groundtruthSets;
+  std::vector<std::pair<int, int> > pageJobs; // groundtruth set and page indices
+  const std::vector<RectEntry> noRects; // for images without any rectangles
 };
 
 
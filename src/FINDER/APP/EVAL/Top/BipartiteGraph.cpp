@@ -46,12 +46,9 @@ BipartiteGraph::BipartiteGraph(string type_, GraphInput input)
   }
   tracker_dir = input.evalTopDir;
   // extract all the info from the GraphInput struct
-  string hypboxfilename = input.hypboxfile;
-  string gtboxfilename  = input.gtboxfile;
-  string imgname    = input.imgname;
-  vector<string> tmp = stringSplit(imgname, '.');
-  filenum = atoi(tmp[0].c_str());
-  filename = imgname;
+  gtrects = input.gtrects;
+  hyprects = input.hyprects;
+  filename = input.imgname;
   hypimg       = input.hypimg;
   gtimg        = input.gtimg;
   inimg        = input.inimg;
@@ -59,18 +56,22 @@ BipartiteGraph::BipartiteGraph(string type_, GraphInput input)
       && hypimg->h == gtimg->h && hypimg->h == inimg->h);
   gt_tracker = pixCreate(gtimg->w, gtimg->h, 32); // TODO: Make the background white!!
   hyp_tracker = pixCreate(gtimg->w, gtimg->h, 32);
-
-  // open both of the files for reading
-  gtfile.open(gtboxfilename.c_str(), ifstream::in);
-  if((gtfile.rdstate() & ifstream::failbit) != 0) {
-    cout << "ERROR: Could not open " << gtboxfilename << endl;
-    assert(false);
-  }
-  hypfile.open(hypboxfilename.c_str(), ifstream::in);
-  if((hypfile.rdstate() & std::ifstream::failbit) != 0 ) {
-    cout << "ERROR: Could not open " << hypboxfilename << endl;
-    assert(false);
+  for(int i = 0; i < LayoutEval::NONE; ++i) {
+    gt_tracker_masks[i] = pixCreate(gtimg->w, gtimg->h, 1);
+    hyp_tracker_masks[i] = pixCreate(gtimg->w, gtimg->h, 1);
   }
+  const PageMasks* masks = input.masks;
+  gt_color_mask = masks->makeGroundTruthColorMask(color, typemode);
+  hyp_color_mask = masks->makeHypothesisColorMask(color, typemode);
+  gt_fg_mask = masks->makeGroundTruthForegroundMask();
+  hyp_fg_mask = masks->makeHypothesisForegroundMask();
+  true_negative_mask = masks->makeTrueNegativeMask(color, typemode);
+  gt_color_hyp_bg_mask = pixSubtract(NULL, gt_color_mask, hyp_fg_mask);
+  in_dark_mask = masks->makeInputDarkMask();
+  gt_fg_integral = pixBlockconvAccum(typemode ? gt_color_mask : gt_fg_mask);
+  hyp_fg_integral = pixBlockconvAccum(typemode ? hyp_color_mask : hyp_fg_mask);
+  edge_grid_w = (gtimg->w + edge_grid_cell_size - 1) / edge_grid_cell_size;
+  edge_grid_h = (gtimg->h + edge_grid_cell_size - 1) / edge_grid_cell_size;
 
   // build and append all the vertices to the groundtruth set and
   // then the hypothesis set
@@ -111,6 +112,19 @@ BipartiteGraph::~BipartiteGraph() {
     pixDestroy(&gt_tracker);
   if(hyp_tracker != NULL)
     pixDestroy(&hyp_tracker);
+  for(int i = 0; i < LayoutEval::NONE; ++i) {
+    pixDestroy(&gt_tracker_masks[i]);
+    pixDestroy(&hyp_tracker_masks[i]);
+  }
+  pixDestroy(&gt_color_mask);
+  pixDestroy(&hyp_color_mask);
+  pixDestroy(&gt_fg_mask);
+  pixDestroy(&hyp_fg_mask);
+  pixDestroy(&true_negative_mask);
+  pixDestroy(&gt_color_hyp_bg_mask);
+  pixDestroy(&in_dark_mask);
+  pixDestroy(&gt_fg_integral);
+  pixDestroy(&hyp_fg_integral);
   destroyVerticesAndEdges(Bipartite::GroundTruth);
   destroyVerticesAndEdges(Bipartite::Hypothesis);
   destroyMetrics();
@@ -150,67 +164,44 @@ void BipartiteGraph::destroyMetrics() {
 }
 
 void BipartiteGraph::makeVertices(Bipartite::GraphChoice graph) {
-  ifstream* file;
-  PIX* img;
+  const vector<RectEntry>* rects;
+  PIX* fgmask;
   vector<Vertex>* set;
   PIX* tracker;
 
+  // when not in typemode all the non-white pixels count as foreground
   if(graph == Bipartite::GroundTruth) {
-    file = &gtfile;
-    img = gtimg;
+    rects = gtrects;
+    fgmask = typemode ? gt_color_mask : gt_fg_mask;
     set = &GroundTruth;
     tracker = gt_tracker;
   } else {
-    file = &hypfile;
-    img = hypimg;
+    rects = hyprects;
+    fgmask = typemode ? hyp_color_mask : hyp_fg_mask;
     set = &Hypothesis;
     tracker = hyp_tracker;
   }
   int idx = 0;
-  int max = 55;
-  char* curline = new char[max];
-  while(!file->eof()) {
-    file->getline(curline, max);
-    string curlinestr = (string)curline;
-  //  if(graph == Bipartite::Hypothesis)
-   //   cout << "hypline: " << curlinestr << endl;
-    assert(curlinestr.length() < max);
-    // parse the line
-    if(curlinestr.empty())
-      continue;
-    vector<string> splitline = stringSplit(curlinestr);
-    string filename   = splitline[0];
-    string recttype   = splitline[1];
-    int rectleft   = atoi(splitline[2].c_str());
-    int recttop    = atoi(splitline[3].c_str());
-    int rectright  = atoi(splitline[4].c_str());
-    int rectbottom = atoi(splitline[5].c_str());
-    vector<string> tmp = stringSplit(filename, '.');
-    int curfilenum = atoi(tmp[0].c_str());
-
-    // .rect file is very specific format where data from
-    // the same file numbers are clustered together
-    // (i.e. all the 1's go before the 2's etc)
-    if(curfilenum < filenum)
-      continue;
-    if(curfilenum > filenum)
-      break;
-    if(recttype != type && typemode)
+  for(int i = 0; i < rects->size(); ++i) {
+    const RectEntry& rect = (*rects)[i];
+    if(rect.type != type && typemode)
       continue;
+    l_int32 rectleft, recttop, rectw, recth;
+    boxGetGeometry(rect.box, &rectleft, &recttop, &rectw, &recth);
+    const l_int32 rectright = rectleft + rectw;
+    const l_int32 rectbottom = recttop + recth;
 
     // now we know we have a vertex so build and append
-    // it to the appropriate vector
-    if(graph == Bipartite::GroundTruth &&
-        (rectleft == -1 || recttop == -1  || rectright == -1 || rectbottom == -1))
-      continue; // empty groundtruth images have an entry like this, just skip it
+    // it to the appropriate vector (the entries of images without
+    // any rectangles, which have -1's, were already left out)
     BOX* box = boxCreate(rectleft, recttop, rectright-rectleft,
         rectbottom-recttop); // create the box
     Vertex vert; // create the vertex
     vert.rect = box; // put the box in the vertex
     // count the foreground pixels and put them in the vertex
     int duplicate_cnt = 0;
-    vert.pix_foreground = countColorPixels(box, img, color, tracker,
-        !typemode, duplicate_cnt);
+    vert.pix_foreground = countColorPixels(box, fgmask, tracker,
+        duplicate_cnt);
     vert.pix_foreground_duplicate = duplicate_cnt;
     vert.setindex = idx;
     vert.area = (rectright-rectleft)*(rectbottom-recttop);
@@ -237,30 +228,47 @@ void BipartiteGraph::makeEdges(Bipartite::GraphChoice graph) {
   vector<Vertex>* make_edges_from; // the set the edges will point to
   PIX* edge_for_pix;
   PIX* edge_from_pix;
-  PIX* edge_for_pix_tracker;
-  PIX* edge_from_pix_tracker;
+  PIX* edge_for_integral;
+  PIX* edge_from_integral;
   if(graph == Bipartite::GroundTruth) {
     make_edges_for = &GroundTruth;
     make_edges_from = &Hypothesis;
     edge_for_pix = gtimg;
     edge_from_pix = hypimg;
-    edge_for_pix_tracker = gt_tracker;
-    edge_from_pix_tracker = hyp_tracker;
+    edge_for_integral = gt_fg_integral;
+    edge_from_integral = hyp_fg_integral;
   } else {
     make_edges_for = &Hypothesis;
     make_edges_from = &GroundTruth;
     edge_for_pix = hypimg;
     edge_from_pix = gtimg;
-    edge_for_pix_tracker = hyp_tracker;
-    edge_from_pix_tracker = gt_tracker;
+    edge_for_integral = hyp_fg_integral;
+    edge_from_integral = gt_fg_integral;
   }
+  // only the vertices in the grid cells a vertex's box touches can intersect it
+  vector<vector<int> > grid;
+  makeVertexGrid(*make_edges_from, grid);
   for(vector<Vertex>::iterator vert = make_edges_for->begin();
       vert != make_edges_for->end(); vert++) {
     // look for intersections of pixels and add an edge for each
     // one that is found
     BOX* vertbox = vert->rect;
-    for(vector<Vertex>::iterator edgevert = make_edges_from->begin();
-        edgevert != make_edges_from->end(); edgevert++) {
+    vector<int> candidates;
+    l_int32 left, top, right, bottom;
+    getGridCells(vertbox, left, top, right, bottom);
+    for(l_int32 i = top; i <= bottom; ++i) {
+      for(l_int32 j = left; j <= right; ++j) {
+        const vector<int>& cell = grid[i * edge_grid_w + j];
+        candidates.insert(candidates.end(), cell.begin(), cell.end());
+      }
+    }
+    // keep the edges in the order of the set they point to
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()),
+        candidates.end());
+    for(vector<int>::iterator candidate = candidates.begin();
+        candidate != candidates.end(); ++candidate) {
+      vector<Vertex>::iterator edgevert = make_edges_from->begin() + *candidate;
       BOX* edgebox = edgevert->rect; // potential edge
       l_int32 intersects = 0;
       boxIntersects(vertbox, edgebox, &intersects);
@@ -268,14 +276,12 @@ void BipartiteGraph::makeEdges(Bipartite::GraphChoice graph) {
         continue;
       // edge found! create the edge and append it to the current
       // vertex's edge list. first need to find the number of pixels
-      // that intersect as well as the area that intersects
+      // that intersect as well as the area that intersects. all of the
+      // foreground pixels in the region of overlap were counted when
+      // making the vertices of both sets, so they're just counted here
       BOX* overlap = boxOverlapRegion(vertbox, edgebox);
-      int intersect1 = 0;
-      int notcounted1 = countColorPixels(overlap, edge_for_pix, color,
-          edge_for_pix_tracker, !typemode, intersect1);
-      int intersect2 = 0;
-      int notcounted2 = countColorPixels(overlap, edge_from_pix, color,
-          edge_from_pix_tracker, !typemode, intersect2);
+      int intersect1 = countIntegralPixels(edge_for_integral, overlap);
+      int intersect2 = countIntegralPixels(edge_from_integral, overlap);
       if(debug) {
         if((intersect1 != intersect2) && !typemode) {
           cout << "edge from " << (make_edges_from == &Hypothesis ? "hypthesis" : "groundtruth")
@@ -306,8 +312,6 @@ void BipartiteGraph::makeEdges(Bipartite::GraphChoice graph) {
       // in which cases it's possible for there to be overlap in the result... but there shouldn't be in the groundtruth...
       if(!typemode) {
         assert(intersect1 == intersect2);
-      // the foreground region of all vertices should have already been counted
-        assert(notcounted1 == 0 && notcounted2 == 0);
       }
       Edge edge;
       edge.vertexptr = &(*edgevert);
@@ -365,14 +369,8 @@ HypothesisMetrics BipartiteGraph::getHypothesisMetrics() {
 
   // make sure that the number of positive pixels counted here is the same as the
   // number of positive ones (color-coded white) in the hyp_tracker image.
-  int hyp_positives = 0;
-  for(int i = 0; i < hypimg->h; ++i) {
-    for(int j = 0; j < hypimg->w; ++j) {
-      l_uint32* curpix = Lept_Utils::getPixelAtXY(hyp_tracker, j, i);
-      if(Lept_Utils::getPixelColor(curpix) == LayoutEval::WHITE)
-        ++hyp_positives;
-    }
-  }
+  l_int32 hyp_positives = 0;
+  pixCountPixels(hyp_tracker_masks[LayoutEval::WHITE], &hyp_positives, NULL);
   assert(hyp_positives == hyp_positive_fg_pix);
 
   // if there aren't any segmented regions in the groundtruth
@@ -599,7 +597,10 @@ HypothesisMetrics BipartiteGraph::getHypothesisMetrics() {
       missedregion.false_positive_pix = 0;
       missedregion.num_gt_overlap = 0;
       missedregion.false_negative_pix = gt_fg_pix;
-      Lept_Utils::fillBoxForeground(hyp_tracker, gt_it->rect, LayoutEval::GREEN, inimg, true);
+      // color the region's foreground from the input image green
+      int filled = 0;
+      countAndTrackPixels(gt_it->rect, in_dark_mask, vector<BOX*>(), false,
+          hyp_tracker, LayoutEval::GREEN, filled);
       hypmetrics.boxes.push_back(missedregion);
       hypmetrics.falsenegatives++;
     }
@@ -836,195 +837,192 @@ HypothesisMetrics BipartiteGraph::getHypothesisMetrics() {
 }
 
 int BipartiteGraph::countTrueNegatives() {
-  int counted_truenegatives = 0;
-  for(l_int32 i = 0; i < gtimg->h; i++) {
-    for(l_int32 j = 0; j < gtimg->w; j++) {
-      l_uint32* cur_gt_pixel = Lept_Utils::getPixelAtXY(gtimg, j, i);
-      l_uint32* cur_hyp_pixel = Lept_Utils::getPixelAtXY(hypimg, j, i);
-      l_uint32* cur_tracker_pixel = Lept_Utils::getPixelAtXY(hyp_tracker, j, i);
-      rgbtype gt_pix_rgb[3];
-      rgbtype hyp_pix_rgb[3];
-      Lept_Utils::getPixelRGB(cur_gt_pixel, gt_pix_rgb);
-      Lept_Utils::getPixelRGB(cur_hyp_pixel, hyp_pix_rgb);
-      LayoutEval::Color colorgt = Lept_Utils::getPixelColor(cur_gt_pixel);
-      if((!Lept_Utils::isColorSignificant(colorgt) && Lept_Utils::isDark(gt_pix_rgb))
-          // ^^checks for an actual negative in the groundtruth that is
-          // simply a foreground pixel. below we check
-          // for a pixel that may be significant but isn't what we are
-          // looking at now (i.e. an embedded pixel when we are evaluating
-          // for displayed expressions <- this doesn't apply when typemode is disabled)
-          || ((Lept_Utils::isColorSignificant(colorgt) && (colorgt != color)) && typemode)) {
-        // negative detected from the groundtruth
-        // if the hypothesis pixel here is also negative then we have
-        // a true negative!
-        LayoutEval::Color colorhyp = Lept_Utils::getPixelColor(cur_hyp_pixel);
-        if((colorgt != color && colorhyp != color && typemode)
-            || (!Lept_Utils::isColorSignificant(colorgt)
-             && !Lept_Utils::isColorSignificant(colorhyp) && !typemode)) {
-          // found a true negative!!!
-          // set the true negative to orange in tracker image and increment if
-          // it hasn't already been counted
-          int duplicates = 0;
-          countAndTrackPixel(j, i, counted_truenegatives,
-              hyp_tracker, LayoutEval::ORANGE, duplicates);
-          assert(duplicates == 0); // there's no reason why anything would be double counted here...
-        }
-      }
-    }
-  }
+  // true negatives are set to orange in the tracker image
+  BOX* fullimgbox = boxCreate(0, 0, (l_int32)gtimg->w, (l_int32)gtimg->h);
+  int duplicates = 0;
+  int counted_truenegatives = countAndTrackPixels(fullimgbox,
+      true_negative_mask, vector<BOX*>(), false, hyp_tracker,
+      LayoutEval::ORANGE, duplicates);
+  boxDestroy(&fullimgbox);
+  assert(duplicates == 0); // there's no reason why anything would be double counted here...
   return counted_truenegatives;
 }
 
 int BipartiteGraph::countFalsePositives(BOX* hypbox, vector<BOX*> gtboxes,
     int& duplicates) {
   assert(duplicates == 0);
-  bool insidegt = false;
-  int falsepositives = 0;
-  l_int32 x1, y1, w1, h1;
-  boxGetGeometry(hypbox, &x1, &y1, &w1, &h1);
-  for(l_int32 i = y1; i < y1+h1; i++) {
-    for(l_int32 j = x1; j < x1+w1; j++) {
-      // if inside one of the groundtruth rectangles then move on
-      insidegt = false;
-      for(vector<Box*>::iterator boxit = gtboxes.begin();
-         boxit != gtboxes.end(); boxit++) {
-        Box* box = *boxit;
-        l_int32 x2, y2, w2, h2;
-        boxGetGeometry(box, &x2, &y2, &w2, &h2);
-        if(j >= x2 && i >= y2 && j < x2+w2 && i < y2+h2) {
-          insidegt = true;
-          break;
-        }
-      }
-      if(insidegt)
-        continue;
-      // otherwise, if we are at a foreground pixel that hasn't
-      // already been counted then increment the counter
-      l_uint32* curpixel = Lept_Utils::getPixelAtXY(hypimg, j, i);
-      if(Lept_Utils::getPixelColor(curpixel) == color
-          || (!typemode &&
-              Lept_Utils::isColorSignificant(Lept_Utils::getPixelColor(curpixel)))) {
-        countAndTrackPixel(j, i, falsepositives, hyp_tracker,
-            LayoutEval::BLUE, duplicates);
-      }
-    }
-  }
-  return falsepositives;
+  // pixels inside one of the groundtruth rectangles aren't counted
+  return countAndTrackPixels(hypbox, hyp_color_mask, gtboxes, false,
+      hyp_tracker, LayoutEval::BLUE, duplicates);
 }
 
 int BipartiteGraph::countTruePositives(BOX* hypbox, vector<BOX*> gtboxes,
     int& duplicates) {
   assert(duplicates == 0);
-  bool insidegt = false;
-  int truepositives = 0;
-  l_int32 x1, y1, w1, h1;
-  boxGetGeometry(hypbox, &x1, &y1, &w1, &h1);
-  for(l_int32 i = y1; i < y1+h1; i++) {
-    for(l_int32 j = x1; j < x1+w1; j++) {
-      // if not inside any of the gtboxes then continue
-      insidegt = false;
-      for(vector<Box*>::iterator gtboxit = gtboxes.begin();
-          gtboxit != gtboxes.end(); gtboxit++) {
-        Box* gtbox = *gtboxit;
-        l_int32 x2, y2, w2, h2;
-        boxGetGeometry(gtbox, &x2, &y2, &w2, &h2);
-        if(x2 <= j && y2 <= i && x2+w2 > j && y2+h2 > i) {
-          insidegt = true;
-          break;
-        }
-      }
-      if(!insidegt)
-        continue;
-      l_uint32* curpixel = Lept_Utils::getPixelAtXY(hypimg, j, i);
-      if(Lept_Utils::getPixelColor(curpixel) == color
-          || (!typemode
-              && Lept_Utils::isColorSignificant(Lept_Utils::getPixelColor(curpixel)))) {
-        countAndTrackPixel(j, i, truepositives, hyp_tracker,
-            LayoutEval::RED, duplicates);
-      }
-    }
-  }
-  return truepositives;
+  // only pixels inside one of the groundtruth rectangles are counted
+  return countAndTrackPixels(hypbox, hyp_color_mask, gtboxes, true,
+      hyp_tracker, LayoutEval::RED, duplicates);
 }
 
 int BipartiteGraph::countFalseNegatives(BOX* gtbox, vector<BOX*> hypboxes,
     int& duplicates) {
-  bool in_hypbox = false;
-  int falseneg = 0;
-  l_int32 x1, y1, w1, h1;
-  boxGetGeometry(gtbox, &x1, &y1, &w1, &h1);
-  for(l_int32 i = y1; i < (y1+h1); i++) {
-    for(l_int32 j = x1; j < (x1+w1); j++) {
-      // if the current pixel is inside of any of the groundtruth
-      // boxes then we ignore it (continue)
-      in_hypbox = false;
-      for(vector<BOX*>::iterator hypboxit = hypboxes.begin();
-          hypboxit != hypboxes.end(); hypboxit++) {
-        BOX* hypbox = *hypboxit;
-        l_int32 x2, y2, w2, h2;
-        boxGetGeometry(hypbox, &x2, &y2, &w2, &h2);
-        if(j >= x2 && i >= y2 && j < (x2+w2) && i < (y2+h2)) {
-          in_hypbox = true;
-          break;
+  // pixels inside one of the hypothesis rectangles aren't counted. the
+  // groundtruth pixels counted here should all be foreground in the
+  // hypothesis as well
+  int unused = 0;
+  assert(countAndTrackPixels(gtbox, gt_color_hyp_bg_mask, hypboxes, false,
+      NULL, LayoutEval::GREEN, unused) == 0);
+  return countAndTrackPixels(gtbox, gt_color_mask, hypboxes, false,
+      hyp_tracker, LayoutEval::GREEN, duplicates);
+}
+
+int BipartiteGraph::countColorPixels(BOX* box, PIX* fgmask, PIX* tracker,
+    int& duplicate_cnt) {
+  assert(duplicate_cnt == 0);
+  return countAndTrackPixels(box, fgmask, vector<BOX*>(), false, tracker,
+      LayoutEval::WHITE, duplicate_cnt);
+}
+
+int BipartiteGraph::countAndTrackPixels(BOX* box, PIX* mask,
+    const vector<BOX*>& regions, bool inside, PIX* tracker,
+    LayoutEval::Color colorcode, int& duplicate_cnt) {
+  l_int32 x, y, w, h;
+  boxGetGeometry(box, &x, &y, &w, &h);
+  const l_int32 left = std::max(x, 0);
+  const l_int32 top = std::max(y, 0);
+  const l_int32 right = std::min(x + w, (l_int32)pixGetWidth(mask));
+  const l_int32 bottom = std::min(y + h, (l_int32)pixGetHeight(mask));
+  if(left >= right || top >= bottom)
+    return 0;
+  vector<l_int32> regiongeom; // x, y, w, h for each region
+  for(vector<BOX*>::const_iterator regionit = regions.begin();
+      regionit != regions.end(); ++regionit) {
+    l_int32 rx, ry, rw, rh;
+    boxGetGeometry(*regionit, &rx, &ry, &rw, &rh);
+    regiongeom.push_back(rx);
+    regiongeom.push_back(ry);
+    regiongeom.push_back(rw);
+    regiongeom.push_back(rh);
+  }
+  const l_int32 wpl = pixGetWpl(mask);
+  l_uint32* const maskdata = pixGetData(mask);
+  l_uint32* trackerdata = NULL;
+  l_int32 trackerwpl = 0;
+  l_uint32* colordata[LayoutEval::NONE];
+  l_uint32 colorval = 0;
+  if(tracker != NULL) {
+    trackerdata = pixGetData(tracker);
+    trackerwpl = pixGetWpl(tracker);
+    PIX** trackermasks = getTrackerMasks(tracker);
+    for(int i = 0; i < LayoutEval::NONE; ++i) {
+      assert(pixGetWpl(trackermasks[i]) == wpl);
+      colordata[i] = pixGetData(trackermasks[i]);
+    }
+    // same values as Lept_Utils::setPixelRGB
+    rgbtype rgb[3] = {0, 0, 0};
+    switch(colorcode) {
+    case LayoutEval::RED : rgb[0] = 255; break;
+    case LayoutEval::GREEN : rgb[1] = 255; break;
+    case LayoutEval::BLUE : rgb[2] = 255; break;
+    case LayoutEval::WHITE : rgb[0] = rgb[1] = rgb[2] = 255; break;
+    case LayoutEval::ORANGE : rgb[0] = 255; rgb[1] = 100; break;
+    default : break;
+    }
+    composeRGBPixel(rgb[0], rgb[1], rgb[2], &colorval);
+  }
+  int count = 0;
+  for(l_int32 i = top; i < bottom; ++i) {
+    for(l_int32 word = left / 32; word <= (right - 1) / 32; ++word) {
+      const l_int32 offset = i * wpl + word;
+      l_uint32 bits = maskdata[offset] & getSpanBits(left, right, word);
+      if(!bits)
+        continue;
+      l_uint32 regionbits = 0;
+      for(int r = 0; r < (int)regiongeom.size(); r += 4) {
+        if(i >= regiongeom[r+1] && i < regiongeom[r+1] + regiongeom[r+3]) {
+          regionbits |= getSpanBits(regiongeom[r],
+              regiongeom[r] + regiongeom[r+2], word);
         }
       }
-      if(in_hypbox)
+      bits &= inside ? regionbits : ~regionbits;
+      if(tracker == NULL) {
+        count += __builtin_popcount(bits);
+        continue;
+      }
+      // pixels already color coded with colorcode have been counted before
+      const l_uint32 counted = bits & ~colordata[colorcode][offset];
+      duplicate_cnt += __builtin_popcount(bits & colordata[colorcode][offset]);
+      if(!counted)
         continue;
-      // otherwise we've detected a false negative if there is
-      // a foreground pixel here!
-      l_uint32* cur_gt_pix = Lept_Utils::getPixelAtXY(gtimg, j, i);
-      if(Lept_Utils::getPixelColor(cur_gt_pix) == color ||
-          (!typemode
-           && Lept_Utils::isColorSignificant(Lept_Utils::getPixelColor(cur_gt_pix)))) {
-        l_uint32* cur_hyp_pix = Lept_Utils::getPixelAtXY(hypimg, j, i);
-        rgbtype hyppixelcolor[3];
-        Lept_Utils::getPixelRGB(cur_hyp_pix, hyppixelcolor);
-        assert(Lept_Utils::isNonWhite(hyppixelcolor));
-        countAndTrackPixel(j, i, falseneg, hyp_tracker,
-            LayoutEval::GREEN, duplicates);
+      count += __builtin_popcount(counted);
+      for(int c = 0; c < LayoutEval::NONE; ++c) {
+        if(c == colorcode)
+          colordata[c][offset] |= counted;
+        else
+          colordata[c][offset] &= ~counted;
+      }
+      // the leftmost pixel of the word is its most significant bit
+      l_uint32* trackerline = trackerdata + i * trackerwpl + word * 32;
+      for(l_uint32 remaining = counted; remaining != 0;) {
+        const int bit = __builtin_clz(remaining);
+        trackerline[bit] = colorval;
+        remaining &= ~(0x80000000 >> bit);
       }
     }
   }
-  return falseneg;
+  return count;
 }
 
-int BipartiteGraph::countColorPixels(BOX* box, PIX* pix,
-    LayoutEval::Color color, PIX* tracker, bool countall_nonwhite,
-    int& duplicate_cnt) {
+int BipartiteGraph::countIntegralPixels(PIX* integral, BOX* box) {
   l_int32 x, y, w, h;
   boxGetGeometry(box, &x, &y, &w, &h);
-  l_uint32* curpixel;
-  rgbtype rgb[3];
-  int foreground_count = 0;
-  assert(duplicate_cnt == 0);
-  for(l_int32 i = y; i < (y+h); i++) {
-    for(l_int32 j = x; j < (x+w); j++) {
-      curpixel = Lept_Utils::getPixelAtXY(pix, j, i);
-      if(!countall_nonwhite) {
-        if(Lept_Utils::getPixelColor(curpixel) == color)
-          countAndTrackPixel(j, i, foreground_count, tracker,
-              LayoutEval::WHITE, duplicate_cnt);
-      } else { // otherwise count any non-white color
-               // (here we assume the background to be white)
-        Lept_Utils::getPixelRGB(curpixel, rgb);
-        if(Lept_Utils::isNonWhite(rgb))
-          countAndTrackPixel(j, i, foreground_count, tracker,
-              LayoutEval::WHITE, duplicate_cnt);
-      }
-    }
-  }
-  return foreground_count;
+  // the last column and row of the box, clipped to the image
+  const l_int32 left = std::max(x, 0);
+  const l_int32 top = std::max(y, 0);
+  const l_int32 right = std::min(x + w, (l_int32)pixGetWidth(integral)) - 1;
+  const l_int32 bottom = std::min(y + h, (l_int32)pixGetHeight(integral)) - 1;
+  if(left > right || top > bottom)
+    return 0;
+  // each value of the integral image is the sum of the pixels above and
+  // to the left of it (inclusive)
+  l_uint32 sum = 0, above = 0, beside = 0, corner = 0;
+  pixGetPixel(integral, right, bottom, &sum);
+  if(top > 0)
+    pixGetPixel(integral, right, top - 1, &above);
+  if(left > 0)
+    pixGetPixel(integral, left - 1, bottom, &beside);
+  if(top > 0 && left > 0)
+    pixGetPixel(integral, left - 1, top - 1, &corner);
+  return (int)(sum - above - beside + corner);
 }
 
-void BipartiteGraph::countAndTrackPixel(l_int32 x, l_int32 y, int& count,
-    PIX* tracker, LayoutEval::Color colorcode, int& duplicate_cnt) {
-  l_uint32* curpixel = Lept_Utils::getPixelAtXY(tracker, x, y);
-  if(Lept_Utils::getPixelColor(curpixel) != colorcode) {
-    Lept_Utils::setPixelRGB(tracker, curpixel, x, y, colorcode);
-    ++count;
+void BipartiteGraph::makeVertexGrid(const vector<Vertex>& set,
+    vector<vector<int> >& grid) {
+  grid.assign(edge_grid_w * edge_grid_h, vector<int>());
+  for(int k = 0; k < set.size(); ++k) {
+    l_int32 left, top, right, bottom;
+    getGridCells(set[k].rect, left, top, right, bottom);
+    for(l_int32 i = top; i <= bottom; ++i)
+      for(l_int32 j = left; j <= right; ++j)
+        grid[i * edge_grid_w + j].push_back(k);
   }
-  else
-    ++duplicate_cnt;
+}
+
+void BipartiteGraph::getGridCells(BOX* box, l_int32& left, l_int32& top,
+    l_int32& right, l_int32& bottom) {
+  // boxes off of the page go in the cells along its border. the padding
+  // makes sure empty boxes are in the cells of anything they intersect
+  l_int32 x, y, w, h;
+  boxGetGeometry(box, &x, &y, &w, &h);
+  left = std::min(std::max(x - 1, 0) / edge_grid_cell_size, edge_grid_w - 1);
+  top = std::min(std::max(y - 1, 0) / edge_grid_cell_size, edge_grid_h - 1);
+  right = std::min(std::max(x + w, 0) / edge_grid_cell_size, edge_grid_w - 1);
+  bottom = std::min(std::max(y + h, 0) / edge_grid_cell_size, edge_grid_h - 1);
+}
+
+PIX** BipartiteGraph::getTrackerMasks(PIX* tracker) {
+  assert(tracker == gt_tracker || tracker == hyp_tracker);
+  return (tracker == gt_tracker) ? gt_tracker_masks : hyp_tracker_masks;
 }
 
 void BipartiteGraph::trackerDrawSegmentations() {
@@ -1076,8 +1074,8 @@ void BipartiteGraph::getGroundTruthMetrics() {
       gt_it != GroundTruth.end(); gt_it++) {
     BOX* gtbox = gt_it->rect;
     int vertex_fg_pixels = 0;
-    int not_counted = countColorPixels(gtbox, gtimg, color, gt_tracker,
-        !typemode, vertex_fg_pixels);
+    int not_counted = countColorPixels(gtbox,
+        typemode ? gt_color_mask : gt_fg_mask, gt_tracker, vertex_fg_pixels);
     assert(not_counted == 0); // should have already been counted while creating vertices
     gtmetrics.total_seg_fg_pixels += vertex_fg_pixels;
     gtmetrics.total_seg_area += (int)gtbox->w * (int)gtbox->h;
@@ -1087,8 +1085,8 @@ void BipartiteGraph::getGroundTruthMetrics() {
   // to the total foreground pixels
   BOX* fullimgbox = boxCreate(0, 0, (l_int32)gtimg->w, (l_int32)gtimg->h);
   int already_counted = 0;
-  gtmetrics.total_nonseg_fg_pixels = countColorPixels(fullimgbox, gtimg, color,
-      gt_tracker, true, already_counted);
+  gtmetrics.total_nonseg_fg_pixels = countColorPixels(fullimgbox, gt_fg_mask,
+      gt_tracker, already_counted);
   boxDestroy(&fullimgbox);
   if(already_counted != gtmetrics.total_seg_fg_pixels) {
     cout << "already counted: " << already_counted << endl;
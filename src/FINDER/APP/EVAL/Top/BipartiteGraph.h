@@ -21,6 +21,7 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <algorithm>
 using namespace std;
 #include <allheaders.h> // leptonica api
 
@@ -28,16 +29,25 @@ using namespace std;
 #include <Utils.h>
 using namespace Utils;
 
+#include <PageMasks.h>
+
 struct Edge; // forward declaration
 
+// a rectangle in a .rect file along with its type
+struct RectEntry {
+  string type;
+  BOX* box;
+};
+
 // this struct holds all of the information necessary
 // for creating a bipartite graph except for the type
 // of block detection it is testing. The type of
 // block detection specifies which rectangles in the
 // box files are of interest
 struct GraphInput {
-  string hypboxfile; // text file holding the hypothesis rectangles
-  string gtboxfile; // text file holding the groundtruth rectangles
+  const vector<RectEntry>* hyprects; // the image's hypothesis rectangles
+  const vector<RectEntry>* gtrects; // the image's groundtruth rectangles
+  const PageMasks* masks; // made from hypimg, gtimg, and inimg
   string imgname; // the name of the image being evaluated
   string evalTopDir; // evaluation directory
   string dbgdir; // the directory to place all debug output
@@ -332,22 +342,49 @@ private:
   // for the given gtbox). False negatives are color coded to green.
   int countFalseNegatives(BOX* gtbox, vector<BOX*> hypboxes, int& duplicates);
 
-  // counts the number of pixels in the Box region of
-  // the given Pix that have the given color. if
-  // countallnonewhite is true then just counts all
-  // colors that are foreground (assumes all background
-  // pixels are white). The tracker image is used to keep track
-  // of what pixels have already been counted and make sure nothing
-  // is double-counted.
-  int countColorPixels(BOX* box, PIX* pix,
-      LayoutEval::Color color, PIX* tracker, bool countallnonewhite,
+  // counts the pixels set in the 1 bpp foreground mask (one of the
+  // masks taken from the PageMasks) within the Box region. The tracker image
+  // is used to keep track of what pixels have already been counted and
+  // make sure nothing is double-counted.
+  int countColorPixels(BOX* box, PIX* fgmask, PIX* tracker,
       int& duplicate_cnt);
 
-  // increments the given count if the pixel at the given x,y coords has not already been
-  // color coded in the given pixel tracker image. this is useful for keeping
-  // track of pixel counts to ensure that pixels are not double-counted.
-  static void countAndTrackPixel(l_int32 x, l_int32 y, int& count, PIX* tracker,
-      LayoutEval::Color colorcode, int& duplicate_cnt);
+  // counts the pixels set in the given 1 bpp mask within box that are
+  // also inside (or outside if inside is false) at least one (or all) of
+  // the given regions. the counted pixels are color coded in the given
+  // tracker image unless they already had that color code, in which case
+  // they're added to duplicate_cnt instead. if the tracker is NULL then
+  // the pixels are just counted. works a 32 pixel word at a time.
+  int countAndTrackPixels(BOX* box, PIX* mask, const vector<BOX*>& regions,
+      bool inside, PIX* tracker, LayoutEval::Color colorcode,
+      int& duplicate_cnt);
+
+  // counts the pixels within the box using an integral image (accumulator)
+  // made from a 1 bpp mask with pixBlockconvAccum
+  static int countIntegralPixels(PIX* integral, BOX* box);
+
+  // buckets the indices of the given set's vertices by the cells of a grid
+  // (edge_grid_cell_size pixels on a side) that their boxes touch, so that
+  // the vertices whose boxes could intersect a given box can be looked up
+  void makeVertexGrid(const vector<Vertex>& set, vector<vector<int> >& grid);
+
+  // gets the range of cells of the vertex grid covering the box, padded by
+  // one pixel on each side
+  void getGridCells(BOX* box, l_int32& left, l_int32& top, l_int32& right,
+      l_int32& bottom);
+
+  // gets the 1 bpp masks of each color code in the given tracker image
+  PIX** getTrackerMasks(PIX* tracker);
+
+  // gets the bits of the given word in a row of a 1 bpp image that lie
+  // within the columns [x1, x2)
+  static inline l_uint32 getSpanBits(l_int32 x1, l_int32 x2, l_int32 word) {
+    const l_int32 lo = std::min(std::max(x1 - word*32, 0), 32);
+    const l_int32 hi = std::min(std::max(x2 - word*32, 0), 32);
+    if(lo >= hi)
+      return 0;
+    return (0xffffffff >> lo) & ~(hi == 32 ? 0 : (0xffffffff >> hi));
+  }
 
   // counts the connected components for the given box in the input image
   inline int countCCs(Box* box) {
@@ -370,9 +407,8 @@ private:
   vector<Vertex> GroundTruth; // the groudtruth set
   vector<Vertex> Hypothesis; // the hypothesis set
 
-  ifstream gtfile;
-  ifstream hypfile;
-  int filenum;
+  const vector<RectEntry>* gtrects;
+  const vector<RectEntry>* hyprects;
   string filename;
   PIX* inimg;
   PIX* hypimg;
@@ -382,6 +418,32 @@ private:
                  // are evaluated
   PIX* gt_tracker; // tracks pixel counts made from groundtruth image
   PIX* hyp_tracker; // tracks pixel counts made from hypothesis image
+  // 1 bpp masks of the pixels having each color code in the tracker images
+  // (indexed by LayoutEval::Color), kept in step with the trackers so that
+  // counting never has to read the colors back out of them
+  PIX* gt_tracker_masks[LayoutEval::NONE];
+  PIX* hyp_tracker_masks[LayoutEval::NONE];
+
+  // 1 bpp masks taken from the page's masks for the type being evaluated so
+  // that all of the pixel counting can be done on packed words rather than
+  // one rgb pixel at a time
+  PIX* gt_color_mask; // groundtruth pixels of the evaluated color (or any
+                      // evaluated color if not in typemode)
+  PIX* hyp_color_mask; // same for the hypothesis
+  PIX* gt_fg_mask; // non-white groundtruth pixels
+  PIX* hyp_fg_mask; // non-white hypothesis pixels
+  PIX* true_negative_mask; // negatives in both the groundtruth and hypothesis
+  PIX* gt_color_hyp_bg_mask; // gt_color_mask pixels that are white in the
+                             // hypothesis (there shouldn't be any)
+  PIX* in_dark_mask; // dark pixels in the input image
+  // integral images of the foreground pixels the groundtruth and hypothesis
+  // vertices count so that the foreground pixels in the overlap of any two
+  // vertices can be counted in constant time
+  PIX* gt_fg_integral;
+  PIX* hyp_fg_integral;
+  static const int edge_grid_cell_size = 64;
+  l_int32 edge_grid_w;
+  l_int32 edge_grid_h;
   string tracker_dir; // directory to place all debug output
 };
 
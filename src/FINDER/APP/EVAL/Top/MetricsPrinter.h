@@ -53,6 +53,15 @@ void printAvgMetrics(const vector<DatasetMetrics>& average_metrics,
   }
 }
 
+void printOverallAvg(const vector<DatasetMetrics>& overall_metrics,
+    ofstream& fout) {
+  fout << "Average Metrics for All Runs:\n";
+  for(int j = 0; j < overall_metrics.size(); ++j) {
+    const DatasetMetrics& overall_type_metrics = overall_metrics[j];
+    overall_type_metrics.printMetrics(2, fout);
+  }
+}
+
 
 }
 
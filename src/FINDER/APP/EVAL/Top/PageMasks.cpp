@@ -0,0 +1,123 @@
+/*
+ * PageMasks.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <PageMasks.h>
+
+#include <assert.h>
+
+PageMasks::PageMasks(PIX* gtimg, PIX* hypimg, PIX* inimg) {
+  assert(LayoutEval::eval_colors == 3);
+  const l_int32 w = pixGetWidth(gtimg);
+  const l_int32 h = pixGetHeight(gtimg);
+  assert(pixGetWidth(hypimg) == w && pixGetWidth(inimg) == w
+      && pixGetHeight(hypimg) == h && pixGetHeight(inimg) == h);
+  for(int i = 0; i < 3; ++i) {
+    gt_color_masks[i] = pixCreate(w, h, 1);
+    hyp_color_masks[i] = pixCreate(w, h, 1);
+  }
+  gt_fg_mask = pixCreate(w, h, 1);
+  hyp_fg_mask = pixCreate(w, h, 1);
+  gt_dark_mask = pixCreate(w, h, 1);
+  in_dark_mask = pixCreate(w, h, 1);
+  const l_int32 maskwpl = pixGetWpl(gt_fg_mask);
+  for(l_int32 i = 0; i < h; ++i) {
+    l_uint32* gtline = pixGetData(gtimg) + i * pixGetWpl(gtimg);
+    l_uint32* hypline = pixGetData(hypimg) + i * pixGetWpl(hypimg);
+    l_uint32* inputline = pixGetData(inimg) + i * pixGetWpl(inimg);
+    const l_int32 maskoffset = i * maskwpl;
+    for(l_int32 j = 0; j < w; ++j) {
+      rgbtype gt_pix_rgb[3];
+      rgbtype hyp_pix_rgb[3];
+      rgbtype in_pix_rgb[3];
+      Lept_Utils::getPixelRGB(gtline + j, gt_pix_rgb);
+      Lept_Utils::getPixelRGB(hypline + j, hyp_pix_rgb);
+      Lept_Utils::getPixelRGB(inputline + j, in_pix_rgb);
+      const LayoutEval::Color colorgt = Lept_Utils::getColor(gt_pix_rgb);
+      const LayoutEval::Color colorhyp = Lept_Utils::getColor(hyp_pix_rgb);
+      if(Lept_Utils::isColorSignificant(colorgt))
+        SET_DATA_BIT(pixGetData(gt_color_masks[colorgt]) + maskoffset, j);
+      if(Lept_Utils::isColorSignificant(colorhyp))
+        SET_DATA_BIT(pixGetData(hyp_color_masks[colorhyp]) + maskoffset, j);
+      if(Lept_Utils::isNonWhite(gt_pix_rgb))
+        SET_DATA_BIT(pixGetData(gt_fg_mask) + maskoffset, j);
+      if(Lept_Utils::isNonWhite(hyp_pix_rgb))
+        SET_DATA_BIT(pixGetData(hyp_fg_mask) + maskoffset, j);
+      if(Lept_Utils::isDark(gt_pix_rgb))
+        SET_DATA_BIT(pixGetData(gt_dark_mask) + maskoffset, j);
+      if(Lept_Utils::isDark(in_pix_rgb))
+        SET_DATA_BIT(pixGetData(in_dark_mask) + maskoffset, j);
+    }
+  }
+  gt_any_color_mask = pixOr(NULL, gt_color_masks[0], gt_color_masks[1]);
+  pixOr(gt_any_color_mask, gt_any_color_mask, gt_color_masks[2]);
+  hyp_any_color_mask = pixOr(NULL, hyp_color_masks[0], hyp_color_masks[1]);
+  pixOr(hyp_any_color_mask, hyp_any_color_mask, hyp_color_masks[2]);
+}
+
+PageMasks::~PageMasks() {
+  for(int i = 0; i < 3; ++i) {
+    pixDestroy(&gt_color_masks[i]);
+    pixDestroy(&hyp_color_masks[i]);
+  }
+  pixDestroy(&gt_any_color_mask);
+  pixDestroy(&hyp_any_color_mask);
+  pixDestroy(&gt_fg_mask);
+  pixDestroy(&hyp_fg_mask);
+  pixDestroy(&gt_dark_mask);
+  pixDestroy(&in_dark_mask);
+}
+
+PIX* PageMasks::makeGroundTruthColorMask(LayoutEval::Color color,
+    bool typemode) const {
+  return makeColorMask(gt_color_masks, gt_any_color_mask, color, typemode);
+}
+
+PIX* PageMasks::makeHypothesisColorMask(LayoutEval::Color color,
+    bool typemode) const {
+  return makeColorMask(hyp_color_masks, hyp_any_color_mask, color, typemode);
+}
+
+PIX* PageMasks::makeGroundTruthForegroundMask() const {
+  return pixClone(gt_fg_mask);
+}
+
+PIX* PageMasks::makeHypothesisForegroundMask() const {
+  return pixClone(hyp_fg_mask);
+}
+
+PIX* PageMasks::makeTrueNegativeMask(LayoutEval::Color color,
+    bool typemode) const {
+  // dark groundtruth pixels that aren't color coded are negatives
+  PIX* negatives = pixSubtract(NULL, gt_dark_mask, gt_any_color_mask);
+  if(typemode) {
+    // so are the pixels of the other evaluated colors, as long as the
+    // hypothesis didn't give them the color being evaluated
+    assert(Lept_Utils::isColorSignificant(color));
+    PIX* othercolors = pixSubtract(NULL, gt_any_color_mask,
+        gt_color_masks[color]);
+    pixOr(negatives, negatives, othercolors);
+    pixDestroy(&othercolors);
+    pixSubtract(negatives, negatives, hyp_color_masks[color]);
+  } else {
+    pixSubtract(negatives, negatives, hyp_any_color_mask);
+  }
+  return negatives;
+}
+
+PIX* PageMasks::makeInputDarkMask() const {
+  return pixClone(in_dark_mask);
+}
+
+PIX* PageMasks::makeColorMask(PIX* const* colormasks, PIX* anycolormask,
+    LayoutEval::Color color, bool typemode) {
+  if(!typemode)
+    return pixClone(anycolormask);
+  // nothing can have a color that isn't evaluated
+  if(!Lept_Utils::isColorSignificant(color))
+    return pixCreateTemplate(anycolormask);
+  return pixClone(colormasks[color]);
+}
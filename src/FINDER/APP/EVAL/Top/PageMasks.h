@@ -0,0 +1,64 @@
+/*
+ * PageMasks.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef PAGEMASKS_H_
+#define PAGEMASKS_H_
+
+#include <allheaders.h> // leptonica api
+
+#include <Lept_Utils.h>
+
+/**
+ * The 1 bpp masks of a page's color coded groundtruth and hypothesis images
+ * (and of its input image) that every type of evaluation on the page counts
+ * pixels from. These are made with a single pass over the page, after which
+ * the masks for any type being evaluated are combined from them a word at a
+ * time. The masks made for a type belong to the caller.
+ */
+class PageMasks {
+ public:
+
+  PageMasks(PIX* gtimg, PIX* hypimg, PIX* inimg);
+
+  ~PageMasks();
+
+  // pixels of the given color (or any evaluated color if not in typemode)
+  PIX* makeGroundTruthColorMask(LayoutEval::Color color, bool typemode) const;
+  PIX* makeHypothesisColorMask(LayoutEval::Color color, bool typemode) const;
+
+  // non-white pixels
+  PIX* makeGroundTruthForegroundMask() const;
+  PIX* makeHypothesisForegroundMask() const;
+
+  // foreground pixels that are negatives for the given color in both the
+  // groundtruth and the hypothesis (any pixel of a different evaluated color
+  // or dark pixel in the groundtruth which isn't of the given color in
+  // the hypothesis. if not in typemode then just the dark groundtruth pixels
+  // that have no evaluated color in either)
+  PIX* makeTrueNegativeMask(LayoutEval::Color color, bool typemode) const;
+
+  // dark pixels in the input image
+  PIX* makeInputDarkMask() const;
+
+ private:
+
+  static PIX* makeColorMask(PIX* const* colormasks, PIX* anycolormask,
+      LayoutEval::Color color, bool typemode);
+
+  // indexed by the evaluated colors in LayoutEval::Color
+  PIX* gt_color_masks[3];
+  PIX* hyp_color_masks[3];
+  PIX* gt_any_color_mask; // pixels of any evaluated color
+  PIX* hyp_any_color_mask;
+  PIX* gt_fg_mask; // non-white
+  PIX* hyp_fg_mask;
+  PIX* gt_dark_mask;
+  PIX* in_dark_mask;
+};
+
+
+#endif /* PAGEMASKS_H_ */
@@ -9,6 +9,7 @@
 
 #include <MathExpressionFinder.h>
 #include <MFinderProvider.h>
+#include <PagePipeline.h>
 #include <Utils.h>
 #include <MainMenu.h>
 #include <Usage.h>
@@ -20,6 +21,7 @@
 #include <allheaders.h> // leptonica
 
 #include <string>
+#include <stdlib.h>
 
 // for testing
 #include <DetMenu.h>
@@ -40,17 +42,30 @@
  */
 int main(int argc, char* argv[]) {
 
+  // Optional number of pages to process in parallel (i.e., -j 16) which
+  // comes before any of the other args
+  int numWorkers = 1;
+  if(argc > 3 && std::string(argv[1]) == std::string("-j")) {
+    numWorkers = atoi(argv[2]);
+    if(numWorkers < 1) {
+      MathExpressionFinderUsage::printUsage();
+      return 0;
+    }
+    argc -= 2;
+    argv += 2;
+  }
+
   if(argc == 2) {
     if(std::string(argv[1]) == std::string("-m")) { // interactive menu
       runInteractiveMenu();
       return 0;
     } else {
-      runFinder(argv[1]); // assume given path as second arg
+      runFinder(argv[1], false, numWorkers); // assume given path as second arg
       return 0;
     }
   } else if(argc == 3) {
     if(std::string(argv[1]) == std::string("-d")) {
-      runFinder(argv[2], true); // assume path is third arg
+      runFinder(argv[2], true, numWorkers); // assume path is third arg
       return 0;
     }
   }
@@ -71,7 +86,11 @@ void runInteractiveMenu() {
   delete mainMenu;
 }
 
-void runFinder(char* path, bool doJustDetection) {
+// Enough pages for each worker to have one being worked on while the next is
+// read in and the last one is written
+static const int maxPagesInFlightPerWorker = 3;
+
+void runFinder(char* path, bool doJustDetection, int numWorkers) {
   const std::string trainedFinderPath =
       FinderTrainingPaths::getTrainedFinderRoot();
   Utils::exec(std::string("mkdir -p ") + trainedFinderPath, true);
@@ -96,27 +115,22 @@ void runFinder(char* path, bool doJustDetection) {
   FinderInfo* finderInfo =
       TrainingInfoFileParser().readInfoFromFile(finderName);
   std::string imagePath = std::string(path);
-  Pixa* images = pixaCreate(0);
+  std::vector<std::string> imagePaths;
   std::vector<std::string> imageNames;
-  // if the image path is a directory, then read in all of the files in that
-  // directory (assumes they are images)
+  // if the image path is a directory, then find all of the files in that
+  // directory (assumes they are images). they're read in one at a time by
+  // the pipeline as it works through them rather than all up front.
   if(Utils::existsDirectory(imagePath)) {
-    std::vector<std::string> imagePaths =
-        DatasetSelectionMenu::findImagePaths(imagePath);
-    for(int i = 0; i < imagePaths.size(); ++i) {
-      std::cout << "image path " << imagePaths[i] << std::endl;;
-      pixaAddPix(images,
-          Utils::leptReadAndBinarizeImg(imagePaths[i]),
-          L_INSERT);
-      imageNames.push_back(DatasetSelectionMenu::getFileNameFromPath(imagePaths[i]));
-    }
+    imagePaths = DatasetSelectionMenu::findImagePaths(imagePath);
   } else if(Utils::existsFile(imagePath)) {
-    pixaAddPix(images, Utils::leptReadAndBinarizeImg(imagePath), L_INSERT);
-    imageNames.push_back(DatasetSelectionMenu::getFileNameFromPath(imagePath));
+    imagePaths.push_back(imagePath);
   } else {
     std::cout << "Unable to read in the image(s) on the given path." << std::endl;
     return MathExpressionFinderUsage::printUsage();
   }
+  for(int i = 0; i < imagePaths.size(); ++i) {
+    imageNames.push_back(DatasetSelectionMenu::getFileNameFromPath(imagePaths[i]));
+  }
 
   GeometryBasedExtractorCategory spatialCategory;
   RecognitionBasedExtractorCategory recognitionCategory;
@@ -124,35 +138,22 @@ void runFinder(char* path, bool doJustDetection) {
       MathExpressionFinderProvider().createMathExpressionFinder(
           &spatialCategory,
           &recognitionCategory,
-          finderInfo);
-
-  std::vector<MathExpressionFinderResults*> results;
-  if(!doJustDetection) {
-    results = finder->findMathExpressions(images, imageNames);
-  } else {
-    results = finder->detectMathExpressions(images, imageNames);
-  }
-
-  pixaDestroy(&images); // destroy finished image(s)
-
-  // Display the results
-  for(int i = 0; i < results.size(); ++i) {
-    results[i]->displaySegmentationResults();
-  }
+          finderInfo,
+          numWorkers);
 
   // Write the results to a directory in the current location (creates
-  // the directory)
+  // the directory). Each page's results are displayed and written as soon
+  // as they're done so that only a few pages are ever held in memory.
   std::string resultsDirName = getResultsNameFromPath(imagePath);
   if(doJustDetection) {
     resultsDirName = resultsDirName + "_detection_only";
   }
-  MathExpressionFinderResults::printResultsToFiles(results,
-      resultsDirName);
-
-  // Destroy results
-  for(int i = 0; i < results.size(); ++i) {
-    delete results[i];
-  }
+  MathExpressionFinderPipeline(finder, maxPagesInFlightPerWorker * numWorkers)
+      .run(doJustDetection ? DETECT : FIND,
+          imagePaths,
+          imageNames,
+          resultsDirName,
+          true);
 
   // Destroy the finder
   delete finder;
@@ -38,7 +38,8 @@ void EvaluatorMenu::doTask() {
       << "\n\n2. If done on multiple groups (the output of multiple program runs), then the results "
       << "and groundtruth paths must be specified as previously mentioned but the results directory "
       << "must instead contain a subdirectory for each group containing the .rect file as previously mentioned. The groundtruth "
-      << "directory must also contain subdirectories with the groundtruth for each group as previously defined.\n";
+      << "directory must either contain the groundtruth shared by every group as previously defined or contain subdirectories "
+      << "with the groundtruth for each group (named the same as the group's results subdirectory).\n";
 
   // Select evaluation mode (single results set or multiple results set)
   std::cout << "Choose one of the below options:\n";
@@ -89,9 +90,7 @@ void EvaluatorMenu::doTask() {
   if(runOptionSelection == singleRunOption) {
     Evaluator(resultsPath, groundtruthPath, typeSpecificMode).evaluateSingleRun();
   } else if(runOptionSelection == multipleRunOption) {
-    std::cout << "Sorry, this option is not supported currently (and probably won't be.. my bad).\n";
-    return;
-    //Evaluator(resultsPath, groundtruthPath, typeSpecificMode).evaluateMultipleRuns();
+    Evaluator(resultsPath, groundtruthPath, typeSpecificMode).evaluateMultipleRuns();
   } else {
     std::cout << "ERROR: Unknown run option selected.\n";
     return;
@@ -18,6 +18,10 @@ void MathExpressionFinderUsage::printUsage() {
       << "containing multiple images.\n\n"
       << "To run with just detection and not segmentation run as follows:\n"
       << "MathFinder -d [path]\n\n"
+      << "Either of the above can be run on multiple pages in parallel by "
+      << "giving the number of pages to process at once first:\n"
+      << "MathFinder -j [workers] [path]\n"
+      << "MathFinder -j [workers] -d [path]\n\n"
       << "For all other options including training, evaluation, groundtruth "
       << "generation, and documentation, there is an interactive menu which can "
       << "be run as follows:\n"
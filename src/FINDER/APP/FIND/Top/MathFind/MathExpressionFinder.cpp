@@ -6,21 +6,29 @@
  */
 #include <MathExpressionFinder.h>
 
+#include <algorithm>
+
 //#define SHOW_GRID
 
 MathExpressionFinder::MathExpressionFinder(
     MathExpressionFeatureExtractor* const mathExpressionFeatureExtractor,
     MathExpressionDetector* const mathExpressionDetector,
     MathExpressionSegmentor* const mathExpressionSegmentor,
-    FinderInfo* const finderInfo) : init(false) {
+    FinderInfo* const finderInfo) : jobRunMode(FIND), jobImages(NULL),
+        nextJobPage(0), init(false) {
   this->mathExpressionFeatureExtractor = mathExpressionFeatureExtractor;
   this->mathExpressionDetector = mathExpressionDetector;
   this->mathExpressionSegmentor = mathExpressionSegmentor;
   this->finderInfo = finderInfo;
+  this->enginePool = TesseractEnginePool::getSharedPool();
 }
 
 
 MathExpressionFinder::~MathExpressionFinder() {
+  for(int i = 0; i < workers.size(); ++i) {
+    delete workers[i];
+  }
+  workers.clear();
   delete mathExpressionFeatureExtractor;
   delete mathExpressionDetector;
   delete mathExpressionSegmentor;
@@ -42,6 +50,20 @@ MathExpressionFeatureExtractor* MathExpressionFinder::getFeatureExtractor() {
   return mathExpressionFeatureExtractor;
 }
 
+void MathExpressionFinder::addWorker(MathExpressionFinder* const worker) {
+  assert(worker != NULL && worker != this);
+  workers.push_back(worker);
+}
+
+int MathExpressionFinder::getNumWorkers() {
+  return workers.size() + 1;
+}
+
+MathExpressionFinder* MathExpressionFinder::getWorker(const int& workerIndex) {
+  assert(workerIndex >= 0 && workerIndex < getNumWorkers());
+  return (workerIndex == 0) ? this : workers[workerIndex - 1];
+}
+
 std::vector<MathExpressionFinderResults*> MathExpressionFinder
 ::getResultsInRunMode(
     RunMode runMode,
@@ -54,93 +76,149 @@ std::vector<MathExpressionFinderResults*> MathExpressionFinder
     return std::vector<MathExpressionFinderResults*>();
   }
 
+  assert(pixaGetCount(images) == imageNames.size());
+
   // Call the finder initialization logic if not already called
+  initialize();
+
+  /**
+   * Get the results for each image, appending them to the vector
+   */
+  if(workers.empty() || images->n < 2) {
+    std::vector<MathExpressionFinderResults*> results;
+    for(int i = 0; i < images->n; ++i) {
+      Pix* image = pixaGetPix(images, i, L_CLONE);
+      results.push_back(getPageResults(runMode, image, imageNames[i]));
+      pixDestroy(&image);
+    }
+    return results;
+  }
+
+  // Parallel run: each worker keeps pulling the next unprocessed page until
+  // they're all done. The results are placed at their image's index so they
+  // come back in the same order as the input regardless of which worker
+  // finishes first.
+  const int numWorkers = std::min(getNumWorkers(), (int)images->n);
+  enginePool->reserveEngines(numWorkers); // one engine per page in flight
+  jobRunMode = runMode;
+  jobImages = images;
+  jobImageNames = imageNames;
+  jobResults.assign(images->n, NULL);
+  nextJobPage = 0;
+  dlib::thread_pool threadPool(numWorkers);
+  for(long i = 0; i < numWorkers; ++i) {
+    threadPool.add_task(*this, &MathExpressionFinder::runWorker, i);
+  }
+  threadPool.wait_for_all_tasks();
+
+  std::vector<MathExpressionFinderResults*> results = jobResults;
+  jobResults.clear();
+  jobImageNames.clear();
+  jobImages = NULL;
+  return results;
+}
+
+void MathExpressionFinder::runWorker(long workerIndex) {
+  MathExpressionFinder* const worker = getWorker(workerIndex);
+  while(true) {
+    jobMutex.lock();
+    const int page = nextJobPage++;
+    jobMutex.unlock();
+    if(page >= jobImages->n) {
+      return;
+    }
+    Pix* image = pixaGetPix(jobImages, page, L_CLONE);
+    MathExpressionFinderResults* const pageResults =
+        worker->getPageResults(jobRunMode, image, jobImageNames[page]);
+    pixDestroy(&image);
+    jobResults[page] = pageResults; // each page's slot is only written once
+  }
+}
+
+void MathExpressionFinder::initialize() {
   if(!init) {
     mathExpressionFeatureExtractor->doFinderInitialization();
     init = true;
   }
+  for(int i = 0; i < workers.size(); ++i) {
+    workers[i]->initialize();
+  }
+}
 
-  assert(pixaGetCount(images) == imageNames.size());
+MathExpressionFinderResults* MathExpressionFinder::getPageResults(
+    RunMode runMode,
+    Pix* const image,
+    const std::string& imageName) {
+
+  MathExpressionFinderResults* results = NULL;
 
-  // Initialize the results vector
-  std::vector<MathExpressionFinderResults*> results;
+  std::cout << "Processing image " << imageName << ".\n";
 
   /**
-   * Get the results for each image, appending them to the vector
+   * ---------------
+   * Stage 1: Run Tesseract OCR and get the data
+   * ---------------
+   * Create a grid containing the connected components in the image and
+   * their character results from running Tesseract's OCR with auto page
+   * segmentation.
    */
-  for(int i = 0; i < images->n; ++i) {
-
-    std::cout << "Processing image " << imageNames[i] << ".\n";
-
-    Pix* image = pixaGetPix(images, i, L_CLONE);
-
-    /**
-     * ---------------
-     * Stage 1: Run Tesseract OCR and get the data
-     * ---------------
-     * Create a grid containing the connected components in the image and
-     * their character results from running Tesseract's OCR with auto page
-     * segmentation.
-     */
-    std::cout << "Creating blob grid.\n";
-    tesseract::TessBaseAPI api;
-    BlobDataGrid* const blobDataGrid =
-        BlobDataGridFactory().createBlobDataGrid(image, &api, Utils::getNameFromPath(imageNames[i]));
+  std::cout << "Creating blob grid.\n";
+  tesseract::TessBaseAPI* const api = enginePool->leaseEngine();
+  BlobDataGrid* const blobDataGrid =
+      BlobDataGridFactory().createBlobDataGrid(image, api, Utils::getNameFromPath(imageName));
 #ifdef SHOW_GRID
-    blobDataGrid->show();
+  blobDataGrid->show();
 #endif
 
-    /**
-     * ---------------
-     * Stage 2: Extract my features from each blob based upon that data
-     * ---------------
-     * Now that I have a grid containing the raw connected components, their basic
-     * data, and recognition data from Tesseract, I am ready to carry out my own
-     * feature extraction. My feature extractor will iterate over each blob and
-     * run whatever feature extractors were set from the command line for them.
-     * The results of the feature extraction are stored within the blob's grid entry
-     * within the grid that is passed into the extraction method.
-     */
-    std::cout << "Extracting features.\n";
-    mathExpressionFeatureExtractor->extractFeatures(blobDataGrid);
-
-    /**
-     * ---------------
-     * Stage 3: Detect low-level math expressions within the blobs using extracted
-     *          features
-     * ---------------
-     * Using the features extracted in the previous stage (along with any other data
-     * already stored in each entry that might be helpful) I now classify each
-     * individual blob as either being math or non-math. Depending on the detector
-     * being used I may also further categorize a blob as being a displayed math,
-     * embedded math, or a label for math.
-     */
-    std::cout << "Running detection.\n";
-    mathExpressionDetector->detectMathExpressions(blobDataGrid);
-    if(runMode == DETECT) {
-      results.push_back(blobDataGrid->getDetectionResults(finderInfo->getFinderName()));
-    }
+  /**
+   * ---------------
+   * Stage 2: Extract my features from each blob based upon that data
+   * ---------------
+   * Now that I have a grid containing the raw connected components, their basic
+   * data, and recognition data from Tesseract, I am ready to carry out my own
+   * feature extraction. My feature extractor will iterate over each blob and
+   * run whatever feature extractors were set from the command line for them.
+   * The results of the feature extraction are stored within the blob's grid entry
+   * within the grid that is passed into the extraction method.
+   */
+  std::cout << "Extracting features.\n";
+  mathExpressionFeatureExtractor->extractFeatures(blobDataGrid);
 
-    /**
-     * ---------------
-     * Stage 4: Segment the detection results into math expressions (also uses
-     *          features extracted)
-     * ---------------
-     * Starting from the detection results from the previous stage, in this stage
-     * I figure out how each result should be segmented into math expressions (or
-     * labels for them if applicable). This involves combining neighboring blobs
-     * into single math expressions which will be the output of the program.
-     */
-    std::cout << "Running segmentation.\n";
-    if(runMode == FIND) {
-      mathExpressionSegmentor->runSegmentation(blobDataGrid);
-      results.push_back(blobDataGrid->getSegmentationResults(finderInfo->getFinderName()));
-    }
+  /**
+   * ---------------
+   * Stage 3: Detect low-level math expressions within the blobs using extracted
+   *          features
+   * ---------------
+   * Using the features extracted in the previous stage (along with any other data
+   * already stored in each entry that might be helpful) I now classify each
+   * individual blob as either being math or non-math. Depending on the detector
+   * being used I may also further categorize a blob as being a displayed math,
+   * embedded math, or a label for math.
+   */
+  std::cout << "Running detection.\n";
+  mathExpressionDetector->detectMathExpressions(blobDataGrid);
+  if(runMode == DETECT) {
+    results = blobDataGrid->getDetectionResults(finderInfo->getFinderName());
+  }
 
-    delete blobDataGrid;
-    pixDestroy(&image);
+  /**
+   * ---------------
+   * Stage 4: Segment the detection results into math expressions (also uses
+   *          features extracted)
+   * ---------------
+   * Starting from the detection results from the previous stage, in this stage
+   * I figure out how each result should be segmented into math expressions (or
+   * labels for them if applicable). This involves combining neighboring blobs
+   * into single math expressions which will be the output of the program.
+   */
+  std::cout << "Running segmentation.\n";
+  if(runMode == FIND) {
+    mathExpressionSegmentor->runSegmentation(blobDataGrid);
+    results = blobDataGrid->getSegmentationResults(finderInfo->getFinderName());
   }
 
+  delete blobDataGrid;
+  enginePool->returnEngine(api); // only once the grid is done with it
+
   return results;
 }
-
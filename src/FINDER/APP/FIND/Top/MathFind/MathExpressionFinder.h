@@ -18,8 +18,12 @@
 #include <BlobDataGridFactory.h>
 #include <BlobDataGrid.h>
 
+#include <TessEnginePool.h>
+
 #include <M_Utils.h>
 
+#include <dlib/threads.h>
+
 #include <vector>
 #include <string>
 #include <assert.h>
@@ -60,6 +64,46 @@ class MathExpressionFinder {
 
   MathExpressionFeatureExtractor* getFeatureExtractor();
 
+  /**
+   * Adds another finder, built from the same FinderInfo as this one, to
+   * process pages alongside this one. Each worker has its own feature
+   * extractor, detector and segmentor so no per-page state is shared between
+   * them. With no workers added the pages are processed one at a time on the
+   * calling thread. The worker is owned by this finder.
+   */
+  void addWorker(MathExpressionFinder* const worker);
+
+  /**
+   * The number of pages that can be processed at once (this finder plus
+   * any workers added to it)
+   */
+  int getNumWorkers();
+
+  /**
+   * Gets the worker at the given index where index 0 is this finder and the
+   * rest are the ones added through addWorker()
+   */
+  MathExpressionFinder* getWorker(const int& workerIndex);
+
+  /**
+   * Calls the finder initialization logic for this finder and each of its
+   * workers if not already called. Needs to be called before
+   * getPageResults().
+   */
+  void initialize();
+
+  /**
+   * Runs all four stages (OCR, feature extraction, detection and, if in FIND
+   * mode, segmentation) on a single page using just this finder (not its
+   * workers), returning the results which are owned by the caller. A finder
+   * may only be working on one page at a time, different workers can be run
+   * on different threads at once though.
+   */
+  MathExpressionFinderResults* getPageResults(
+      RunMode runMode,
+      Pix* const image,
+      const std::string& imageName);
+
   ~MathExpressionFinder();
 
  private:
@@ -70,11 +114,29 @@ class MathExpressionFinder {
       Pixa* const images,
       std::vector<std::string> imageNames);
 
+  // Thread body for parallel runs, keeps taking the next unprocessed page
+  // and running it through the given worker until none are left
+  void runWorker(long workerIndex);
+
   MathExpressionFeatureExtractor* mathExpressionFeatureExtractor;
   MathExpressionDetector* mathExpressionDetector;
   MathExpressionSegmentor* mathExpressionSegmentor;
   FinderInfo* finderInfo;
 
+  // initialized Tesseract engines leased out to each page (not owned)
+  TesseractEnginePool* enginePool;
+
+  // finders processing pages alongside this one (owned)
+  std::vector<MathExpressionFinder*> workers;
+
+  // the pages shared out to the workers during a parallel run
+  RunMode jobRunMode;
+  Pixa* jobImages;
+  std::vector<std::string> jobImageNames;
+  std::vector<MathExpressionFinderResults*> jobResults;
+  int nextJobPage;
+  dlib::mutex jobMutex;
+
   // internal variables/flags
   bool init;
 };
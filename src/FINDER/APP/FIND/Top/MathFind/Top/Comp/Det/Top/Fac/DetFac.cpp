@@ -9,6 +9,7 @@
 #include <Detector.h>
 #include <FinderInfo.h>
 #include <SvmDetector.h>
+#include <ReducedSvmDetector.h>
 
 #include <string>
 #include <iostream>
@@ -17,8 +18,9 @@
 #include <stddef.h>
 
 MathExpressionDetectorFactory::MathExpressionDetectorFactory()
-: svmDetectorName("SVM") {
+: svmDetectorName("SVM"), reducedSvmDetectorName("FastSVM") {
   supportedDetectorNames.push_back(svmDetectorName);
+  supportedDetectorNames.push_back(reducedSvmDetectorName);
 }
 
 MathExpressionDetector* MathExpressionDetectorFactory
@@ -32,6 +34,9 @@ MathExpressionDetector* MathExpressionDetectorFactory
   if(finderInfo->getDetectorName() == svmDetectorName) {
     return new TrainedSvmDetector(detectorDataPath);
   }
+  if(finderInfo->getDetectorName() == reducedSvmDetectorName) {
+    return new ReducedSvmDetector(detectorDataPath);
+  }
 
   std::cout << "Error: Could not find the detector named " << finderInfo->getDetectorName() << "\n";
   assert(false); // Hopefully won't get here....
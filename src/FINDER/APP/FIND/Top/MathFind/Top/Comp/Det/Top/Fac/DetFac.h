@@ -32,6 +32,7 @@ class MathExpressionDetectorFactory {
 
   // Supported detector names
   std::string svmDetectorName;
+  std::string reducedSvmDetectorName; // faster, approximate version of the svm
   std::vector<std::string> supportedDetectorNames; // as a list
 };
 
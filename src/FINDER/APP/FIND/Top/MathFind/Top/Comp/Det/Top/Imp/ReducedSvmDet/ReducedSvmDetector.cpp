@@ -0,0 +1,245 @@
+/*
+ * ReducedSvmDetector.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <ReducedSvmDetector.h>
+
+#include <SvmDetector.h>
+#include <SvmBatchScorer.h>
+#include <BlobDataGrid.h>
+#include <BlobData.h>
+#include <Sample.h>
+#include <Utils.h>
+
+// dlib includes
+#include <dlib/svm_threaded.h>
+
+// standard includes
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <ios>
+#include <stddef.h>
+
+const int ReducedSvmDetector::compressionFactor = 20;
+const int ReducedSvmDetector::minBasisVectors = 10;
+
+ReducedSvmDetector::ReducedSvmDetector(
+    const std::string& detectorDirPath) {
+#ifndef RBF_KERNEL
+  std::cout << "ERROR: The reduced SVM detector only supports the RBF kernel. "
+      << "Enable RBF_KERNEL at the top of SvmDetector.h.\n";
+  assert(false);
+#endif
+  fullDetector = new TrainedSvmDetector(detectorDirPath);
+  predictorPath = fullDetector->getDetectorPath() + "Reduced";
+}
+
+ReducedSvmDetector::~ReducedSvmDetector() {
+  delete fullDetector;
+}
+
+void ReducedSvmDetector::detectMathExpressions(
+    BlobDataGrid* const blobDataGrid) {
+  loadPredictor();
+  TrainedSvmDetector::predictAll(*loadedPredictor, *loadedScorer,
+      TrainedSvmDetector::getBlobs(blobDataGrid));
+}
+
+std::string ReducedSvmDetector::getDetectorPath() {
+  return predictorPath;
+}
+
+bool ReducedSvmDetector::doTraining(
+    const std::vector<std::vector<BLSample*> >& samples) {
+
+  long numFeatures = -1;
+  for(int i = 0; i < samples.size() && numFeatures < 0; ++i) {
+    if(!samples[i].empty()) {
+      numFeatures = samples[i][0]->features.size();
+    }
+  }
+  if(numFeatures < 0) {
+    std::cout << "ERROR: No training samples to compress the SVM with.\n";
+    return false;
+  }
+
+  // Get the full predictor first. One that's already trained is only reused
+  // if it was trained on the same features and the user doesn't want it
+  // retrained on the current samples.
+  const std::string fullPredictorPath = fullDetector->getDetectorPath();
+  bool doFullTraining = true;
+  if(Utils::existsFile(fullPredictorPath)) {
+    const long fullNumFeatures =
+        readPredictor(fullPredictorPath).normalizer.means().size();
+    if(fullNumFeatures != numFeatures) {
+      std::cout << "The full SVM predictor at " << fullPredictorPath
+          << " was trained on " << fullNumFeatures << " features but the "
+          << "samples have " << numFeatures << ", so it will be retrained.\n";
+    } else {
+      std::cout << "A full SVM predictor at " << fullPredictorPath
+          << " has already been trained. Would you like to retrain it on the "
+          << "current samples before compressing it? If you answer no, the "
+          << "old full predictor will be compressed as it is. ";
+      doFullTraining = Utils::promptYesNo();
+    }
+  } else {
+    std::cout << "The full SVM predictor needs to be trained before it can be "
+        << "compressed, training it now.\n";
+  }
+  if(doFullTraining) {
+    if(!fullDetector->doTraining(samples)) {
+      return false;
+    }
+  } else {
+    std::cout << "Compressing the full SVM predictor already trained at "
+        << fullPredictorPath << std::endl;
+  }
+  const RBFSVMNormalizedPredictor fullPredictor =
+      readPredictor(fullPredictorPath);
+  if(fullPredictor.normalizer.means().size() != numFeatures) {
+    std::cout << "ERROR: The full SVM predictor at " << fullPredictorPath
+        << " doesn't have the same number of features as the samples.\n";
+    assert(false);
+  }
+
+  // Convert the samples into format suitable for DLib (normalized the same
+  // way as the full predictor normalizes them)
+  std::vector<sample_type> normalizedSamples;
+  std::vector<double> labels;
+  for(int i = 0; i < samples.size(); ++i) { // iterates through the images
+    for(int j = 0; j < samples[i].size(); ++j) { // iterates the samples in the image
+      BLSample* const s = samples[i][j];
+      assert(s->features.size() == numFeatures);
+      sample_type sample;
+      sample.set_size(s->features.size(), 1);
+      for(int k = 0; k < s->features.size(); ++k) {
+        sample(k) = s->features[k];
+      }
+      normalizedSamples.push_back(dlib::pointwise_multiply(
+          sample - fullPredictor.normalizer.means(),
+          fullPredictor.normalizer.std_devs()));
+      labels.push_back(s->label ? +1 : -1);
+    }
+  }
+
+  const RBFSVMNormalizedPredictor reducedPredictor =
+      compressPredictor(fullPredictor, normalizedSamples);
+  reportAccuracyDelta(fullPredictor, reducedPredictor, normalizedSamples,
+      labels);
+
+  // serialize and save the predictor for later use
+  std::ofstream fout(predictorPath.c_str(), std::ios::binary);
+  serialize(reducedPredictor, fout);
+  fout.close();
+  loadPredictor(true); // replace any older one already in use
+  std::cout << "Training Complete! The reduced predictor has been saved to "
+      << predictorPath << std::endl;
+  return true;
+}
+
+RBFSVMNormalizedPredictor ReducedSvmDetector::compressPredictor(
+    const RBFSVMNormalizedPredictor& fullPredictor,
+    const std::vector<sample_type>& normalizedSamples) {
+  const RBFSVMPredictor& full = fullPredictor.function;
+  const long numFull = full.basis_vectors.size();
+  const long numBasisVectors = std::min(numFull,
+      std::max((long)minBasisVectors, numFull / compressionFactor));
+  std::cout << "Compressing " << numFull << " support vectors down to "
+      << numBasisVectors << " basis vectors.\n";
+
+  // Start from a linearly independent subset of the samples, then optimize
+  // the basis vectors and their weights to match the full function
+  const RBFKernel kernel(full.kernel_function);
+  dlib::linearly_independent_subset_finder<RBFKernel> lisf(kernel,
+      numBasisVectors);
+  dlib::fill_lisf(lisf, normalizedSamples);
+  const dlib::distance_function<RBFKernel> target(full);
+  const dlib::distance_function<RBFKernel> approximation =
+      dlib::approximate_distance_function(
+          dlib::objective_delta_stop_strategy(1e-3), target, lisf);
+
+  RBFSVMNormalizedPredictor reducedPredictor;
+  reducedPredictor.normalizer = fullPredictor.normalizer;
+  reducedPredictor.function = RBFSVMPredictor(approximation.get_alpha(), 0,
+      kernel, approximation.get_basis_vectors());
+
+  // The weights and vectors have all moved, so the bias needs refitting
+  double bias = 0;
+  for(int i = 0; i < normalizedSamples.size(); ++i) {
+    bias += reducedPredictor.function(normalizedSamples[i])
+        - full(normalizedSamples[i]);
+  }
+  reducedPredictor.function.b = bias / normalizedSamples.size();
+  return reducedPredictor;
+}
+
+void ReducedSvmDetector::reportAccuracyDelta(
+    const RBFSVMNormalizedPredictor& fullPredictor,
+    const RBFSVMNormalizedPredictor& reducedPredictor,
+    const std::vector<sample_type>& normalizedSamples,
+    const std::vector<double>& labels) {
+  int fullCorrect = 0;
+  int reducedCorrect = 0;
+  int agree = 0;
+  for(int i = 0; i < normalizedSamples.size(); ++i) {
+    const bool fullResult =
+        (fullPredictor.function(normalizedSamples[i]) >= 0);
+    const bool reducedResult =
+        (reducedPredictor.function(normalizedSamples[i]) >= 0);
+    const bool label = (labels[i] > 0);
+    if(fullResult == label) {
+      ++fullCorrect;
+    }
+    if(reducedResult == label) {
+      ++reducedCorrect;
+    }
+    if(fullResult == reducedResult) {
+      ++agree;
+    }
+  }
+  const double total = normalizedSamples.size();
+  const double fullAccuracy = fullCorrect / total;
+  const double reducedAccuracy = reducedCorrect / total;
+  std::cout << "Accuracy on the " << normalizedSamples.size()
+      << " training samples:\n"
+      << "  full predictor (" << fullPredictor.function.basis_vectors.size()
+      << " support vectors): " << Utils::doubleToString(fullAccuracy, 6)
+      << std::endl
+      << "  reduced predictor ("
+      << reducedPredictor.function.basis_vectors.size()
+      << " basis vectors): " << Utils::doubleToString(reducedAccuracy, 6)
+      << std::endl
+      << "  delta: " << Utils::doubleToString(reducedAccuracy - fullAccuracy, 6)
+      << std::endl
+      << "  predictions in agreement: "
+      << Utils::doubleToString(agree / total, 6) << std::endl;
+}
+
+void ReducedSvmDetector::loadPredictor(const bool& forceReload) {
+  if(loadedPredictor.get() != NULL && !forceReload) {
+    return;
+  }
+  const TrainedSvmDetector::LoadedPredictorFile loadedFile =
+      TrainedSvmDetector::loadPredictorFile(predictorPath, forceReload);
+  loadedPredictor = loadedFile.predictor;
+  loadedScorer = loadedFile.scorer;
+}
+
+RBFSVMNormalizedPredictor ReducedSvmDetector::readPredictor(
+    const std::string& path) {
+  std::ifstream fin(path.c_str(), std::ios::binary);
+  if(!fin.is_open()) {
+    std::cout << "ERROR: Could not open the predictor at " << path << std::endl;
+    assert(false);
+  }
+  RBFSVMNormalizedPredictor predictor;
+  deserialize(predictor, fin);
+  return predictor;
+}
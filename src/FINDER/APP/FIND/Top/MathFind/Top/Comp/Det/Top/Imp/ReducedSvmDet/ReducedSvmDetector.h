@@ -0,0 +1,86 @@
+/*
+ * ReducedSvmDetector.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef REDUCEDSVMDETECTOR_H_
+#define REDUCEDSVMDETECTOR_H_
+
+#include <Detector.h>
+#include <SvmDetector.h>
+#include <SvmBatchScorer.h>
+#include <BlobDataGrid.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * A faster, approximate version of the RBF SVM detector. Scoring a blob
+ * against the full SVM costs one kernel evaluation per support vector, and
+ * the full SVM keeps every support vector the trainer produces. This detector
+ * compresses the full SVM down to a small fraction of that many basis vectors
+ * (chosen from a linearly independent subset of the training samples and then
+ * optimized to approximate the full decision function, same as dlib's
+ * reduced2 trainer does) and detects with the compressed one instead.
+ *
+ * Training first trains the full SVM's predictor, unless one has already
+ * been trained on the same features and the user chooses to keep it, then
+ * compresses it and reports how the compressed predictor's
+ * accuracy on the training samples compares to the full one's.
+ */
+class ReducedSvmDetector : virtual public MathExpressionDetector {
+ public:
+
+  ReducedSvmDetector(const std::string& detectorDirPath);
+
+  ~ReducedSvmDetector();
+
+  /**
+   * See base class for docs
+   */
+  void detectMathExpressions(
+      BlobDataGrid* const featureExtractionOutput);
+
+  std::string getDetectorPath();
+
+  bool doTraining(const std::vector<std::vector<BLSample*> >& samples);
+
+ private:
+
+  // Compresses the full predictor using the given training samples (already
+  // normalized), fitting the bias so that on average the compressed
+  // predictor's decision values match the full one's
+  RBFSVMNormalizedPredictor compressPredictor(
+      const RBFSVMNormalizedPredictor& fullPredictor,
+      const std::vector<sample_type>& normalizedSamples);
+
+  // Prints the accuracy of both predictors on the training samples
+  void reportAccuracyDelta(
+      const RBFSVMNormalizedPredictor& fullPredictor,
+      const RBFSVMNormalizedPredictor& reducedPredictor,
+      const std::vector<sample_type>& normalizedSamples,
+      const std::vector<double>& labels);
+
+  // gets the compressed predictor from the same process-wide store as the
+  // full detector's (only read in from disk the first time)
+  void loadPredictor(const bool& forceReload=false);
+
+  static RBFSVMNormalizedPredictor readPredictor(const std::string& path);
+
+  // the full detector (used for training the full predictor)
+  TrainedSvmDetector* fullDetector;
+
+  // the compressed predictor keeps the full one's support vector count
+  // divided by this (but no fewer than minBasisVectors)
+  static const int compressionFactor;
+  static const int minBasisVectors;
+
+  std::string predictorPath;
+  SharedSVMPredictor loadedPredictor; // null until loaded
+  SharedSVMBatchScorer loadedScorer;
+};
+
+
+#endif /* REDUCEDSVMDETECTOR_H_ */
@@ -0,0 +1,114 @@
+/*
+ * SvmBatchScorer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <SvmBatchScorer.h>
+
+#include <vector>
+#include <assert.h>
+#include <math.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+RBFSVMBatchScorer::RBFSVMBatchScorer(
+    const BatchScoredSVMPredictor& predictor) {
+  numFeatures = predictor.normalizer.means().size();
+  rowStride = ((numFeatures + 3) / 4) * 4;
+  means.assign(rowStride, 0);
+  invStdDevs.assign(rowStride, 0);
+  for(int i = 0; i < numFeatures; ++i) {
+    means[i] = predictor.normalizer.means()(i);
+    invStdDevs[i] = predictor.normalizer.std_devs()(i);
+  }
+
+  numSupportVectors = predictor.function.basis_vectors.size();
+  supportVectors.assign(numSupportVectors * rowStride, 0);
+  alphas.resize(numSupportVectors);
+  for(int i = 0; i < numSupportVectors; ++i) {
+    const dlib::matrix<double, 0, 1>& supportVector = predictor.function.basis_vectors(i);
+    assert(supportVector.size() == numFeatures);
+    for(int j = 0; j < numFeatures; ++j) {
+      supportVectors[i * rowStride + j] = supportVector(j);
+    }
+    alphas[i] = predictor.function.alpha(i);
+  }
+  gamma = predictor.function.kernel_function.gamma;
+  bias = predictor.function.b;
+}
+
+int RBFSVMBatchScorer::getNumFeatures() const {
+  return numFeatures;
+}
+
+int RBFSVMBatchScorer::getRowStride() const {
+  return rowStride;
+}
+
+void RBFSVMBatchScorer::score(std::vector<double>& samples,
+    const int& numSamples, std::vector<double>& scores) const {
+  assert(samples.size() >= numSamples * rowStride);
+
+  // Normalize every sample up front (the padding stays at 0)
+  for(int i = 0; i < numSamples; ++i) {
+    double* const sample = &samples[i * rowStride];
+    for(int j = 0; j < numFeatures; ++j) {
+      sample[j] = (sample[j] - means[j]) * invStdDevs[j];
+    }
+  }
+
+  scores.resize(numSamples);
+  for(int i = 0; i < numSamples; ++i) {
+    const double* const sample = &samples[i * rowStride];
+    double sum = 0;
+    for(int j = 0; j < numSupportVectors; ++j) {
+      const double distance = squaredDistance(sample,
+          &supportVectors[j * rowStride], rowStride);
+      sum += alphas[j] * exp(-gamma * distance);
+    }
+    scores[i] = sum - bias;
+  }
+}
+
+double RBFSVMBatchScorer::squaredDistance(const double* a, const double* b,
+    const int& length) {
+#if defined(__AVX__)
+  __m256d sum = _mm256_setzero_pd();
+  for(int i = 0; i < length; i += 4) {
+    const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + i),
+        _mm256_loadu_pd(b + i));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(diff, diff));
+  }
+  double parts[4];
+  _mm256_storeu_pd(parts, sum);
+  return (parts[0] + parts[1]) + (parts[2] + parts[3]);
+#elif defined(__SSE2__)
+  __m128d sumLow = _mm_setzero_pd();
+  __m128d sumHigh = _mm_setzero_pd();
+  for(int i = 0; i < length; i += 4) {
+    const __m128d diffLow = _mm_sub_pd(_mm_loadu_pd(a + i),
+        _mm_loadu_pd(b + i));
+    const __m128d diffHigh = _mm_sub_pd(_mm_loadu_pd(a + i + 2),
+        _mm_loadu_pd(b + i + 2));
+    sumLow = _mm_add_pd(sumLow, _mm_mul_pd(diffLow, diffLow));
+    sumHigh = _mm_add_pd(sumHigh, _mm_mul_pd(diffHigh, diffHigh));
+  }
+  double parts[4];
+  _mm_storeu_pd(parts, sumLow);
+  _mm_storeu_pd(parts + 2, sumHigh);
+  return (parts[0] + parts[1]) + (parts[2] + parts[3]);
+#else
+  double sum = 0;
+  for(int i = 0; i < length; ++i) {
+    const double diff = a[i] - b[i];
+    sum += diff * diff;
+  }
+  return sum;
+#endif
+}
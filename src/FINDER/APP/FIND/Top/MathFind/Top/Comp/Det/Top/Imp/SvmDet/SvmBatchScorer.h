@@ -0,0 +1,77 @@
+/*
+ * SvmBatchScorer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef SVMBATCHSCORER_H_
+#define SVMBATCHSCORER_H_
+
+#include <dlib/svm_threaded.h>
+
+#include <vector>
+
+// Same as the RBFSVMNormalizedPredictor in SvmDetector.h (which includes this)
+typedef dlib::normalized_function<dlib::decision_function<
+    dlib::radial_basis_kernel<dlib::matrix<double, 0, 1> > > > BatchScoredSVMPredictor;
+
+/**
+ * Scores a whole page's worth of samples against a trained RBF SVM at once
+ * rather than one blob at a time through dlib. The normalizer and support
+ * vectors are copied out of the predictor into flat arrays (each row padded
+ * with zeros out to a multiple of 4 doubles) so that the squared distance
+ * between a sample and each support vector can be computed with SIMD
+ * instructions (AVX when built for it, otherwise SSE2). The scores come out
+ * the same as the dlib predictor's to within rounding, only the order the
+ * sums are accumulated in differs.
+ *
+ * Once constructed the scorer is read-only, so it can be shared by any number
+ * of threads.
+ */
+class RBFSVMBatchScorer {
+ public:
+
+  RBFSVMBatchScorer(const BatchScoredSVMPredictor& predictor);
+
+  int getNumFeatures() const;
+
+  /**
+   * Number of doubles taken up by each sample's row
+   */
+  int getRowStride() const;
+
+  /**
+   * Scores each of the numSamples samples in the given matrix, which holds
+   * one sample per row (getRowStride() doubles apart, anything past the
+   * features should be 0). The samples are normalized in place. The scores
+   * are the predictor's decision values (positive means math).
+   */
+  void score(std::vector<double>& samples, const int& numSamples,
+      std::vector<double>& scores) const;
+
+ private:
+
+  // Squared euclidean distance between two padded rows
+  static double squaredDistance(const double* a, const double* b,
+      const int& length);
+
+  int numFeatures;
+  int rowStride;
+
+  // the normalizer (subtract the mean and multiply by the inverse standard
+  // deviation of each feature)
+  std::vector<double> means;
+  std::vector<double> invStdDevs;
+
+  // one support vector per row, along with its weight
+  int numSupportVectors;
+  std::vector<double> supportVectors;
+  std::vector<double> alphas;
+
+  double gamma;
+  double bias;
+};
+
+
+#endif /* SVMBATCHSCORER_H_ */
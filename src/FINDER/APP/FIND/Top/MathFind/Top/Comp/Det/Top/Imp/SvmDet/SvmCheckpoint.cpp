@@ -0,0 +1,130 @@
+/*
+ * SvmCheckpoint.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <SvmCheckpoint.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+CrossValidationCheckpoint::CrossValidationCheckpoint(const std::string& path,
+    const std::vector<dlib::matrix<double, 0, 1> >& samples,
+    const std::vector<double>& labels)
+: path(path), numResumed(0) {
+  std::ostringstream header;
+  header << "samples " << samples.size() << " " << hashSamples(samples, labels);
+
+  // read in the results from the last run if they were for the same samples
+  std::ifstream old(path.c_str());
+  std::string line;
+  if(old.is_open() && std::getline(old, line) && line == header.str()) {
+    // only complete lines count, the last one may have been cut off
+    while(std::getline(old, line) && !old.eof()) {
+      std::istringstream lineStream(line);
+      int numSamples = 0, folds = 0;
+      double C = 0, gamma = 0;
+      dlib::matrix<double, 1, 2> result;
+      if(lineStream >> numSamples >> folds >> C >> gamma
+          >> result(0, 0) >> result(0, 1)) {
+        results[getKey(numSamples, folds, C, gamma)] = result;
+      }
+    }
+  }
+  old.close();
+  numResumed = results.size();
+
+  // write the file back out fresh with just the complete results
+  file.open(path.c_str(), std::ios::trunc);
+  if(!file.is_open()) {
+    std::cout << "ERROR: Could not open the checkpoint file at " << path
+        << std::endl;
+    assert(false);
+  }
+  file.precision(17);
+  file << header.str() << std::endl;
+  for(std::map<std::string, dlib::matrix<double, 1, 2> >::iterator it =
+      results.begin(); it != results.end(); ++it) {
+    file << it->first << " " << it->second(0, 0) << " "
+        << it->second(0, 1) << std::endl;
+  }
+  file.flush();
+}
+
+CrossValidationCheckpoint::~CrossValidationCheckpoint() {
+  if(file.is_open()) {
+    file.close();
+  }
+}
+
+int CrossValidationCheckpoint::getNumResumed() const {
+  return numResumed;
+}
+
+bool CrossValidationCheckpoint::findResult(const int& numSamples,
+    const int& folds, const double& C, const double& gamma,
+    dlib::matrix<double, 1, 2>& result) {
+  dlib::auto_mutex lock(resultsMutex);
+  std::map<std::string, dlib::matrix<double, 1, 2> >::const_iterator found =
+      results.find(getKey(numSamples, folds, C, gamma));
+  if(found == results.end()) {
+    return false;
+  }
+  result = found->second;
+  return true;
+}
+
+void CrossValidationCheckpoint::addResult(const int& numSamples,
+    const int& folds, const double& C, const double& gamma,
+    const dlib::matrix<double, 1, 2>& result) {
+  dlib::auto_mutex lock(resultsMutex);
+  const std::string key = getKey(numSamples, folds, C, gamma);
+  results[key] = result;
+  file << key << " " << result(0, 0) << " " << result(0, 1) << std::endl;
+  file.flush();
+}
+
+void CrossValidationCheckpoint::remove() {
+  dlib::auto_mutex lock(resultsMutex);
+  file.close();
+  ::remove(path.c_str());
+}
+
+// the parameters are written out with enough digits to be read back in
+// exactly, so the same parameters always give the same key
+std::string CrossValidationCheckpoint::getKey(const int& numSamples,
+    const int& folds, const double& C, const double& gamma) {
+  std::ostringstream key;
+  key.precision(17);
+  key << numSamples << " " << folds << " " << C << " " << gamma;
+  return key.str();
+}
+
+// FNV-1a over the bytes of every feature and label
+unsigned long long CrossValidationCheckpoint::hashSamples(
+    const std::vector<dlib::matrix<double, 0, 1> >& samples,
+    const std::vector<double>& labels) {
+  assert(samples.size() == labels.size());
+  unsigned long long hash = 14695981039346656037ULL;
+  for(size_t i = 0; i < samples.size(); ++i) {
+    for(long j = 0; j <= samples[i].size(); ++j) {
+      const double value = (j < samples[i].size()) ? samples[i](j) : labels[i];
+      unsigned char bytes[sizeof(double)];
+      memcpy(bytes, &value, sizeof(double));
+      for(size_t k = 0; k < sizeof(double); ++k) {
+        hash ^= bytes[k];
+        hash *= 1099511628211ULL;
+      }
+    }
+  }
+  return hash;
+}
@@ -0,0 +1,96 @@
+/*
+ * SvmCheckpoint.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef SVMCHECKPOINT_H_
+#define SVMCHECKPOINT_H_
+
+#include <dlib/matrix.h>
+#include <dlib/threads.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Every cross validation result computed while searching for the optimal SVM
+ * parameters, written to a file as soon as it's computed so that a training
+ * run that gets interrupted can pick up where it left off. Each line of the
+ * file is one result:
+ *
+ *   <number of samples> <folds> <C> <gamma> <positive accuracy> <negative accuracy>
+ *
+ * after a first line identifying the training samples the results were
+ * computed on:
+ *
+ *   samples <number of samples> <hash of the samples and labels>
+ *
+ * If the file is for different samples (or there isn't one) then it's started
+ * over. Since the samples are shuffled the same way every run and the search
+ * is deterministic, a resumed search asks for the same results in the same
+ * order and gets the checkpointed ones back without redoing them, including
+ * the BOBYQA search which replays its steps up to where it was interrupted.
+ * Anything after the last complete line (e.g., if the process was killed
+ * mid-write) is ignored.
+ *
+ * Results can be looked up and added from any number of threads at once.
+ */
+class CrossValidationCheckpoint {
+ public:
+
+  /**
+   * Opens the checkpoint file at the given path for the given samples and
+   * labels, reading in any results already in it
+   */
+  CrossValidationCheckpoint(const std::string& path,
+      const std::vector<dlib::matrix<double, 0, 1> >& samples,
+      const std::vector<double>& labels);
+
+  ~CrossValidationCheckpoint();
+
+  /**
+   * Gets the number of results that were read in from a previous run
+   */
+  int getNumResumed() const;
+
+  /**
+   * Looks up the result of cross validating the first numSamples samples
+   * with the given parameters. Returns false if it hasn't been computed.
+   */
+  bool findResult(const int& numSamples, const int& folds, const double& C,
+      const double& gamma, dlib::matrix<double, 1, 2>& result);
+
+  /**
+   * Adds the result and writes it to the file
+   */
+  void addResult(const int& numSamples, const int& folds, const double& C,
+      const double& gamma, const dlib::matrix<double, 1, 2>& result);
+
+  /**
+   * Closes and deletes the file, once the search is done and its results
+   * aren't needed anymore (so that a later search starts from scratch)
+   */
+  void remove();
+
+ private:
+
+  static std::string getKey(const int& numSamples, const int& folds,
+      const double& C, const double& gamma);
+
+  static unsigned long long hashSamples(
+      const std::vector<dlib::matrix<double, 0, 1> >& samples,
+      const std::vector<double>& labels);
+
+  std::string path;
+  std::ofstream file;
+  std::map<std::string, dlib::matrix<double, 1, 2> > results;
+  int numResumed;
+  dlib::mutex resultsMutex;
+};
+
+
+#endif /* SVMCHECKPOINT_H_ */
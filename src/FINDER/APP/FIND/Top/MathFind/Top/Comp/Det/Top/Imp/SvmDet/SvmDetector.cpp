@@ -7,6 +7,9 @@
 
 #include <SvmDetector.h>
 
+#include <SvmBatchScorer.h>
+#include <SvmDistanceCache.h>
+#include <SvmCheckpoint.h>
 #include <BlobDataGrid.h>
 #include <BlobData.h>
 #include <M_Utils.h>
@@ -18,26 +21,40 @@
 
 // dlib includes
 #include <dlib/svm_threaded.h>
+#include <dlib/threads.h>
 
 // standard includes
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <assert.h>
 #include <ios>
+#include <map>
+#include <math.h>
+#include <time.h>
+#include <sys/stat.h>
 
 //#define SHOW_GRID
+//#define DBG_CHECK_BATCH_SCORES
 
 #define PROGRESS_TO_FILE
+//#define NEGATIVE_SUBSAMPLING // train on a subset of the negatives, see subsampleNegatives()
 //#define RUNNING_BACKGROUND
 
+std::map<std::string, TrainedSvmDetector::LoadedPredictorFile>
+TrainedSvmDetector::loadedPredictorFiles;
+dlib::mutex TrainedSvmDetector::loadedPredictorFilesMutex;
+
 // ***********
 // Note see http://dlib.net/svm_ex.cpp.html
 // Much of this is copied from that example.
 // ************
 TrainedSvmDetector::TrainedSvmDetector(
-    const std::string& detectorDirPath) {
+    const std::string& detectorDirPath)
+: jobPoints(NULL), jobFolds(0), jobThreadsPerPoint(1), heldOutChunkSize(1),
+  distanceCache(NULL), checkpoint(NULL) {
   std::string classifierName =
 #ifdef RBF_KERNEL
       (std::string)"RBFSVM";
@@ -66,15 +83,20 @@ TrainedSvmDetector::TrainedSvmDetector(
 void TrainedSvmDetector::detectMathExpressions(
     BlobDataGrid* const blobDataGrid) {
 
-  // Start up the predictor
+  // Get the predictor (only read in from disk the first time, after that
+  // this picks up the one already in memory including any reloaded one)
   loadPredictor();
 
   // Run the predictor on each blob
-  BlobData* blob = NULL;
-  BlobDataGridSearch bdgs(blobDataGrid);
-  bdgs.StartFullSearch();
-  while((blob = bdgs.NextFullSearch()) != NULL) {
-    blob->setMathExpressionDetectionResult(predict(blob->getExtractedFeatures()));
+  const std::vector<BlobData*> blobs = getBlobs(blobDataGrid);
+  if(loadedScorer.get() != NULL) {
+    predictAll(*loadedPredictor, *loadedScorer, blobs);
+  } else {
+    for(int i = 0; i < blobs.size(); ++i) {
+      blobs[i]->setMathExpressionDetectionResult(
+          predict(blobs[i]->getExtractedFeatures(),
+              blobs[i]->getNumExtractedFeatures()));
+    }
   }
 
 #ifdef SHOW_GRID
@@ -114,12 +136,12 @@ bool TrainedSvmDetector::doTraining(const std::vector<std::vector<BLSample*> >&
     for(int j = 0; j < samples[i].size(); ++j) { // iterates the samples in the image
       BLSample* const s = samples[i][j];
       // add the sample (the feature vector)
-      std::vector<DoubleFeature*> features = s->features;
+      const std::vector<double>& features = s->features;
       assert(features.size() == num_features);
       sample_type sample;
       sample.set_size(num_features, 1);
       for(int k = 0; k < num_features; ++k) {
-        sample(k) = features[k]->getFeature();
+        sample(k) = features[k];
       }
       training_samples.push_back(sample);
       // add the corresponding label
@@ -155,6 +177,10 @@ bool TrainedSvmDetector::doTraining(const std::vector<std::vector<BLSample*> >&
     training_samples[i] = normalizer(training_samples[i]);
   outputProgress("done normalizing each sample\n");
 
+#ifdef NEGATIVE_SUBSAMPLING
+  subsampleNegatives();
+#endif
+
   // Now ready to find the optimal C and Gamma parameters through a coarse
   // grid search then through a finer one. Once the "optimal" C and Gamma
   // parameters are found, the SVM is trained on these to give the final
@@ -175,14 +201,40 @@ bool TrainedSvmDetector::doTraining(const std::vector<std::vector<BLSample*> >&
 #endif
   }
   if(doParamCalc) {
+    // Pick up from where the last run left off if it was interrupted
+    checkpoint = new CrossValidationCheckpoint(predictorPath + "_checkpoint",
+        training_samples, labels);
+    if(checkpoint->getNumResumed() > 0) {
+      outputProgress(std::string("Resuming from ") +
+          Utils::intToString(checkpoint->getNumResumed()) +
+          std::string(" cross validation results checkpointed by a previous run\n"));
+    }
+#ifdef RBF_KERNEL
+    // Every gamma tried during cross validation needs the same distances
+    // between the samples, so they're computed once here for all of them
+    distanceCache = new SquaredDistanceCache(training_samples,
+        distanceCacheMaxBytes);
+    outputProgress(std::string("Cached the distances between the first ") +
+        Utils::intToString(distanceCache->getNumCached()) + std::string(" of the ") +
+        Utils::intToString(training_samples.size()) + std::string(" samples\n"));
+#endif
     doCoarseCVTraining(10);
     doFineCVTraining(10);
     saveOptParams();
+    delete distanceCache;
+    distanceCache = NULL;
+    checkpoint->remove(); // done, the next search starts from scratch
+    delete checkpoint;
+    checkpoint = NULL;
   }
   outputProgress("about to do training\n");
   trainFinalClassifier();
   outputProgress("done with trainFinalClassifier\n");
+#ifdef NEGATIVE_SUBSAMPLING
+  mineHardNegatives();
+#endif
   savePredictor();
+  loadPredictor(true); // replace any older one already in use
   outputProgress("done with savePredictor\n");
   outputProgress(std::string("Training Complete! The predictor has been saved to ")
        + predictorPath + std::string("\n"));
@@ -227,62 +279,159 @@ void TrainedSvmDetector::doCoarseCVTraining(int folds) {
   //    is the corresponding gamma part. Each index represents a pair on the
   //    grid, just they are on two separate rows. and the column is the entire
   //    grid.
-  dlib::matrix<double> best_result(2,1);
-  best_result = 0;
+  std::vector<GridPoint> points(grid.nc());
   for(int i = 0; i < grid.nc(); i++) {
-    // grab the current pair
-    const double C = grid(0, i);
+    points[i].C = grid(0, i);
 #ifdef RBF_KERNEL
-    const double gamma = grid(1, i);
+    points[i].gamma = grid(1, i);
 #endif
-    // set up C_SVC trainer using the current parameters
+#ifdef LINEAR_KERNEL
+    points[i].gamma = 0;
+#endif
+  }
 
+  //    Rather than cross validating every pair on all of the samples, the
+  //    search is done by successive halving: every pair is first cross
+  //    validated on a small subset of the (already randomized) samples,
+  //    then only the best third of them go on to the next round on a subset
+  //    three times as big, and so on until the last round where the few pairs
+  //    left are cross validated on all of the samples. Pairs that do poorly
+  //    on the small subsets are dropped before they cost a full cross
+  //    validation. Ties go to the pair that comes first on the grid.
+  for(int round = 0; ; ++round) {
+    const int numSamples = getHalvingRoundSize(round, folds);
+    outputProgress(std::string("Coarse search round ") +
+        Utils::intToString(round) + std::string(": cross validating ") +
+        Utils::intToString(points.size()) + std::string(" pairs on ") +
+        Utils::intToString(numSamples) + std::string(" of the ") +
+        Utils::intToString(training_samples.size()) + std::string(" samples\n"));
+    crossValidateGridPoints(points, numSamples, folds);
+    std::stable_sort(points.begin(), points.end(), &isBetterGridPoint);
+    if(numSamples == training_samples.size()) {
+      break;
+    }
+    points.resize((points.size() + 2) / 3);
+  }
+  const dlib::matrix<double, 1, 2> best_result = points[0].result;
+#ifdef RBF_KERNEL
+  gamma_optimal = points[0].gamma;
+#endif
+  C_optimal = points[0].C;
 #ifdef RBF_KERNEL
-    dlib::svm_c_trainer<RBFKernel> trainer;
-    trainer.set_kernel(RBFKernel(gamma));
+  outputProgress(std::string("Best Result: (positive, negative)") +
+      Utils::doubleToString(best_result(0,0)) + std::string(", ") +
+      Utils::doubleToString(best_result(0,1)) + std::string("\n") +
+      std::string(". Gamma = ") + Utils::doubleToString(gamma_optimal, 11) +
+       std::string(". C = ") + Utils::doubleToString(C_optimal, 11) + std::string("\n"));
 #endif
 #ifdef LINEAR_KERNEL
-    svm_c_trainer<LinearKernel> trainer;
+  std::cout << "Best Result: " << best_result
+       << ", C = " << std::setw(11) << C_optimal << std::endl;
 #endif
-    trainer.set_c(C);
-    // do the cross validation
-    outputProgress(std::string("Running cross validation for ") +
-        std::string("C: ") + Utils::doubleToString(C, 11) +
+}
+
+void TrainedSvmDetector::crossValidateGridPoints(
+    std::vector<GridPoint>& points, const int& numSamples, const int& folds) {
+  jobPoints = &points;
 #ifdef RBF_KERNEL
-         std::string("  Gamma: ") + Utils::doubleToString(gamma, 11) +
-         std::string("\n"));
+  jobSampleIndices = SquaredDistanceCache::getSampleIndices(numSamples);
 #endif
 #ifdef LINEAR_KERNEL
-         std::string("\n"));
+  jobSamples.assign(training_samples.begin(),
+      training_samples.begin() + numSamples);
+#endif
+  jobLabels.assign(labels.begin(), labels.begin() + numSamples);
+  jobFolds = folds;
+
+  // Split the thread budget between the points first, giving each point's
+  // cross validation more than one thread (up to one per fold) only once
+  // there are fewer points than threads
+  const int numThreads = Utils::getNumProcessors();
+  jobThreadsPerPoint =
+      std::max(1, std::min(folds, numThreads / (int)points.size()));
+  const int numConcurrent = std::max(1,
+      std::min((int)points.size(), numThreads / jobThreadsPerPoint));
+  dlib::thread_pool threadPool(numConcurrent);
+  for(int i = 0; i < points.size(); ++i) {
+    threadPool.add_task(*this, &TrainedSvmDetector::crossValidateGridPoint, i);
+  }
+  threadPool.wait_for_all_tasks();
+
+  jobPoints = NULL;
+#ifdef RBF_KERNEL
+  jobSampleIndices.clear();
 #endif
-    dlib::matrix<double> result = cross_validate_trainer_threaded(trainer, training_samples,
-        labels, folds, folds); // last arg is the number of threads (using same as folds)
-    outputProgress(std::string("C: ") +  Utils::doubleToString(C, 11) +
+#ifdef LINEAR_KERNEL
+  jobSamples.clear();
+#endif
+  jobLabels.clear();
+}
+
+void TrainedSvmDetector::crossValidateGridPoint(long pointIndex) {
+  GridPoint& point = (*jobPoints)[pointIndex]; // only touched by this task
+  // set up C_SVC trainer using the current parameters
 #ifdef RBF_KERNEL
-         std::string("  Gamma: ") + Utils::doubleToString(gamma, 11) +
+  dlib::svm_c_trainer<CachedRBFKernel> trainer;
+  trainer.set_kernel(CachedRBFKernel(distanceCache, point.gamma));
 #endif
-         std::string("  cross validation accuracy (positive, negative): ") +
-         Utils::doubleToString(result(0,0), 11) + std::string(", ") +
-         Utils::doubleToString(result(0,1), 11) + std::string("\n"));
-    if(sum(result) > sum(best_result)) {
-      best_result = result;
+#ifdef LINEAR_KERNEL
+  dlib::svm_c_trainer<LinearKernel> trainer;
+#endif
+  trainer.set_c(point.C);
+  // do the cross validation (unless a previous run already did)
+  if(!checkpoint->findResult(jobLabels.size(), jobFolds, point.C, point.gamma,
+      point.result)) {
+    outputProgress(std::string("Running cross validation for ") +
+        std::string("C: ") + Utils::doubleToString(point.C, 11) +
 #ifdef RBF_KERNEL
-      gamma_optimal = gamma;
+         std::string("  Gamma: ") + Utils::doubleToString(point.gamma, 11) +
 #endif
-      C_optimal = C;
-    }
-  }
+         std::string("\n"));
 #ifdef RBF_KERNEL
-  outputProgress(std::string("Best Result: (positive, negative)") +
-      Utils::doubleToString(best_result(0,0)) + std::string(", ") +
-      Utils::doubleToString(best_result(0,1)) + std::string("\n") +
-      std::string(". Gamma = ") + Utils::doubleToString(gamma_optimal, 11) +
-       std::string(". C = ") + Utils::doubleToString(C_optimal, 11) + std::string("\n"));
+    point.result = cross_validate_trainer_threaded(trainer, jobSampleIndices,
+        jobLabels, jobFolds, jobThreadsPerPoint);
 #endif
 #ifdef LINEAR_KERNEL
-  std::cout << "Best Result: " << best_result
-       << ", C = " << std::setw(11) << C_optimal << std::endl;
+    point.result = cross_validate_trainer_threaded(trainer, jobSamples,
+        jobLabels, jobFolds, jobThreadsPerPoint);
 #endif
+    checkpoint->addResult(jobLabels.size(), jobFolds, point.C, point.gamma,
+        point.result);
+  }
+  outputProgress(std::string("C: ") +  Utils::doubleToString(point.C, 11) +
+#ifdef RBF_KERNEL
+       std::string("  Gamma: ") + Utils::doubleToString(point.gamma, 11) +
+#endif
+       std::string("  cross validation accuracy (positive, negative) on ") +
+       Utils::intToString(jobLabels.size()) + std::string(" samples: ") +
+       Utils::doubleToString(point.result(0,0), 11) + std::string(", ") +
+       Utils::doubleToString(point.result(0,1), 11) + std::string("\n"));
+}
+
+int TrainedSvmDetector::getHalvingRoundSize(const int& round,
+    const int& folds) {
+  const int numHalvingRounds = 4; // 100 pairs -> 34 -> 12 -> 4
+  const int numSamples = training_samples.size();
+  int size = numSamples;
+  for(int i = round; i < numHalvingRounds - 1 && size > 0; ++i) {
+    size /= 3;
+  }
+  int numPositive = 0, numNegative = 0;
+  for(int i = 0; i < numSamples; ++i) {
+    if(i >= size && numPositive >= folds && numNegative >= folds) {
+      return i;
+    }
+    if(labels[i] > 0)
+      ++numPositive;
+    else
+      ++numNegative;
+  }
+  return numSamples;
+}
+
+bool TrainedSvmDetector::isBetterGridPoint(const GridPoint& point1,
+    const GridPoint& point2) {
+  return sum(point1.result) > sum(point2.result);
 }
 
 // assumes that C_optimal and gamma_optimal have already
@@ -322,7 +471,8 @@ void TrainedSvmDetector::doFineCVTraining(int folds) {
   upperbound = dlib::log(upperbound);
 
   double best_score = dlib::find_max_bobyqa(
-      cross_validation_objective(training_samples, labels, folds, &progressFile), // Function to maximize
+      cross_validation_objective(training_samples, labels, folds, &progressFile,
+          distanceCache, checkpoint), // Function to maximize
       opt_params,                                      // starting point
       opt_params.size()*2 + 1,                         // See BOBYQA docs, generally size*2+1 is a good setting for this
       lowerbound,                                 // lower bound
@@ -353,11 +503,18 @@ void TrainedSvmDetector::doFineCVTraining(int folds) {
   outputProgress(std::string("Running cross validation again on optimal c and gamma") +
       std::string(" to get the true positive and true negative rate (should sum") +
       std::string(" up to the score above.\n"));
-  dlib::svm_c_trainer<RBFKernel> trainer;
-  trainer.set_kernel(RBFKernel(gamma_optimal));
+  dlib::svm_c_trainer<CachedRBFKernel> trainer;
+  trainer.set_kernel(CachedRBFKernel(distanceCache, gamma_optimal));
   trainer.set_c(C_optimal);
-  dlib::matrix<double> result = cross_validate_trainer_threaded(trainer, training_samples,
-      labels, folds, folds); // last arg is the number of threads (using same as folds)
+  dlib::matrix<double, 1, 2> result;
+  if(!checkpoint->findResult(labels.size(), folds, C_optimal, gamma_optimal,
+      result)) {
+    result = cross_validate_trainer_threaded(trainer,
+        SquaredDistanceCache::getSampleIndices(training_samples.size()),
+        labels, folds, folds); // last arg is the number of threads (using same as folds)
+    checkpoint->addResult(labels.size(), folds, C_optimal, gamma_optimal,
+        result);
+  }
   outputProgress(std::string("C: ") +  Utils::doubleToString(C_optimal, 11) +
        std::string("  Gamma: ") + Utils::doubleToString(gamma_optimal, 11) +
        std::string("  cross validation accuracy (positive, negative): ") +
@@ -425,35 +582,225 @@ void TrainedSvmDetector::trainFinalClassifier() {
       std::string("\n"));
 }
 
+void TrainedSvmDetector::subsampleNegatives() {
+  // the samples are already in random order so the first negatives are as
+  // good a random subset as any (and the same one every run)
+  int numPositive = 0;
+  for(int i = 0; i < labels.size(); ++i) {
+    if(labels[i] > 0)
+      ++numPositive;
+  }
+  const int maxNegatives = numPositive * negativeRatio;
+  std::vector<sample_type> keptSamples;
+  std::vector<double> keptLabels;
+  int numNegative = 0;
+  for(int i = 0; i < training_samples.size(); ++i) {
+    if(labels[i] < 0 && numNegative++ >= maxNegatives) {
+      heldOutNegatives.push_back(training_samples[i]);
+    } else {
+      keptSamples.push_back(training_samples[i]);
+      keptLabels.push_back(labels[i]);
+    }
+  }
+  training_samples.swap(keptSamples);
+  labels.swap(keptLabels);
+  outputProgress(std::string("Training on all ") + Utils::intToString(numPositive) +
+      std::string(" positive samples and ") +
+      Utils::intToString(training_samples.size() - numPositive) +
+      std::string(" negative samples, holding out the other ") +
+      Utils::intToString(heldOutNegatives.size()) + std::string(" negative samples\n"));
+}
+
+void TrainedSvmDetector::mineHardNegatives() {
+  for(int round = 0; round < numHardNegativeRounds && !heldOutNegatives.empty();
+      ++round) {
+    // score every held out negative with the classifier just trained
+    const int numThreads = Utils::getNumProcessors();
+    const long numChunks = numThreads * 4;
+    heldOutChunkSize = (heldOutNegatives.size() + numChunks - 1) / numChunks;
+    heldOutScores.assign(heldOutNegatives.size(), 0);
+    dlib::thread_pool threadPool(numThreads);
+    for(long i = 0; i < numChunks; ++i) {
+      threadPool.add_task(*this, &TrainedSvmDetector::scoreHeldOutNegatives, i);
+    }
+    threadPool.wait_for_all_tasks();
+
+    // move the ones it got wrong into the training set
+    std::vector<sample_type> stillHeldOut;
+    int numHard = 0;
+    for(int i = 0; i < heldOutNegatives.size(); ++i) {
+      if(heldOutScores[i] >= 0) {
+        training_samples.push_back(heldOutNegatives[i]);
+        labels.push_back(-1);
+        ++numHard;
+      } else {
+        stillHeldOut.push_back(heldOutNegatives[i]);
+      }
+    }
+    outputProgress(std::string("Hard negative mining round ") +
+        Utils::intToString(round) + std::string(": ") + Utils::intToString(numHard) +
+        std::string(" of the ") + Utils::intToString(heldOutNegatives.size()) +
+        std::string(" held out negative samples were misclassified\n"));
+    heldOutNegatives.swap(stillHeldOut);
+    if(numHard == 0) {
+      break;
+    }
+    outputProgress(std::string("Retraining on ") +
+        Utils::intToString(training_samples.size()) + std::string(" samples\n"));
+    trainFinalClassifier();
+  }
+  heldOutNegatives.clear();
+  heldOutScores.clear();
+}
+
+void TrainedSvmDetector::scoreHeldOutNegatives(long chunk) {
+  const long begin = chunk * heldOutChunkSize;
+  const long end = std::min(begin + heldOutChunkSize, (long)heldOutNegatives.size());
+  for(long i = begin; i < end; ++i) {
+    // already normalized so only the decision function is needed
+    heldOutScores[i] = final_predictor.function(heldOutNegatives[i]);
+  }
+}
+
 void TrainedSvmDetector::savePredictor() {
   std::ofstream fout(predictorPath.c_str(), std::ios::binary);
   serialize(final_predictor, fout);
   fout.close();
 }
 
-void TrainedSvmDetector::loadPredictor() {
-  std::ifstream fin(predictorPath.c_str(), std::ios::binary);
+void TrainedSvmDetector::loadPredictor(const bool& forceReload) {
+  const LoadedPredictorFile loadedFile =
+      loadPredictorFile(predictorPath, forceReload);
+  loadedPredictor = loadedFile.predictor;
+  loadedScorer = loadedFile.scorer;
+}
+
+TrainedSvmDetector::LoadedPredictorFile TrainedSvmDetector::loadPredictorFile(
+    const std::string& path, const bool& forceReload) {
+  dlib::auto_mutex lock(loadedPredictorFilesMutex);
+  std::map<std::string, LoadedPredictorFile>::iterator loaded =
+      loadedPredictorFiles.find(path);
+  if(loaded != loadedPredictorFiles.end() && !forceReload) {
+    return loaded->second;
+  }
+  std::ifstream fin(path.c_str(), std::ios::binary);
   if(!fin.is_open()) {
-    std::cout << "ERROR: Could not open the predictor at " << predictorPath << std::endl;
+    std::cout << "ERROR: Could not open the predictor at " << path << std::endl;
     assert(false);
   }
-  deserialize(final_predictor, fin);
-  std::cout << "Predictor at " << predictorPath << " was successfully loaded!\n";
+  TrainedSVMPredictor* const predictor = new TrainedSVMPredictor;
+  deserialize(*predictor, fin);
+  LoadedPredictorFile loadedFile;
+  loadedFile.predictor = SharedSVMPredictor(predictor);
+#ifdef RBF_KERNEL
+  loadedFile.scorer = SharedSVMBatchScorer(new RBFSVMBatchScorer(*predictor));
+#endif
+  loadedFile.modifiedTime = getModifiedTime(path);
+  loadedPredictorFiles[path] = loadedFile;
+  std::cout << "Predictor at " << path << " was successfully loaded!\n";
+  return loadedFile;
+}
+
+bool TrainedSvmDetector::reloadPredictorIfChanged() {
+  bool changed = false;
+  {
+    dlib::auto_mutex lock(loadedPredictorFilesMutex);
+    std::map<std::string, LoadedPredictorFile>::iterator loaded =
+        loadedPredictorFiles.find(predictorPath);
+    if(loaded == loadedPredictorFiles.end()) {
+      // never loaded, will be read in fresh on the first page
+      return false;
+    }
+    changed = (getModifiedTime(predictorPath) != loaded->second.modifiedTime);
+    if(!changed) {
+      // may have already been reloaded through another detector
+      loadedPredictor = loaded->second.predictor;
+      loadedScorer = loaded->second.scorer;
+    }
+  }
+  if(changed) {
+    loadPredictor(true);
+  }
+  return changed;
 }
 
-bool TrainedSvmDetector::predict(const std::vector<DoubleFeature*>& sample) {
+time_t TrainedSvmDetector::getModifiedTime(const std::string& path) {
+  struct stat fileStat;
+  if(stat(path.c_str(), &fileStat) != 0) {
+    return 0;
+  }
+  return fileStat.st_mtime;
+}
+
+bool TrainedSvmDetector::predict(const double* const sample,
+    const int& numFeatures) {
+  assert(sample != NULL);
   sample_type sample_;
-  sample_.set_size(sample.size(), 1);
-  for(int i = 0; i < sample.size(); ++i)
-    sample_(i) = sample[i]->getFeature();
-  double result = final_predictor(sample_);
+  sample_.set_size(numFeatures, 1);
+  for(int i = 0; i < numFeatures; ++i)
+    sample_(i) = sample[i];
+  // Normalize here rather than through the predictor's normalizer since
+  // that writes its result to a member and the predictor is shared across
+  // threads
+  const sample_type normalized = dlib::pointwise_multiply(
+      sample_ - loadedPredictor->normalizer.means(),
+      loadedPredictor->normalizer.std_devs());
+  double result = loadedPredictor->function(normalized);
   if(result < 0)
     return false;
   else
     return true;
 }
 
+std::vector<BlobData*> TrainedSvmDetector::getBlobs(
+    BlobDataGrid* const blobDataGrid) {
+  std::vector<BlobData*> blobs;
+  BlobData* blob = NULL;
+  BlobDataGridSearch bdgs(blobDataGrid);
+  bdgs.StartFullSearch();
+  while((blob = bdgs.NextFullSearch()) != NULL) {
+    blobs.push_back(blob);
+  }
+  return blobs;
+}
+
+void TrainedSvmDetector::predictAll(const TrainedSVMPredictor& predictor,
+    const RBFSVMBatchScorer& scorer, const std::vector<BlobData*>& blobs) {
+  // Gather all of the blobs' features into one matrix, a row per blob
+  const int rowStride = scorer.getRowStride();
+  std::vector<double> samples(blobs.size() * rowStride, 0);
+  for(int i = 0; i < blobs.size(); ++i) {
+    const double* const features = blobs[i]->getExtractedFeatures();
+    assert(features != NULL
+        && blobs[i]->getNumExtractedFeatures() == scorer.getNumFeatures());
+    std::copy(features, features + scorer.getNumFeatures(),
+        samples.begin() + i * rowStride);
+  }
+
+  std::vector<double> scores;
+  scorer.score(samples, blobs.size(), scores);
+  for(int i = 0; i < blobs.size(); ++i) {
+#ifdef DBG_CHECK_BATCH_SCORES
+    sample_type sample_;
+    sample_.set_size(scorer.getNumFeatures(), 1);
+    for(int j = 0; j < sample_.size(); ++j)
+      sample_(j) = blobs[i]->getExtractedFeatures()[j];
+    // normalized here for the same reason as in predict()
+    const double expected = predictor.function(dlib::pointwise_multiply(
+        sample_ - predictor.normalizer.means(),
+        predictor.normalizer.std_devs()));
+    if(fabs(expected - scores[i]) > 1e-9 * (1 + fabs(expected))) {
+      std::cout << "ERROR: Batch score " << scores[i]
+          << " doesn't match the predictor's " << expected << std::endl;
+      assert(false);
+    }
+#endif
+    blobs[i]->setMathExpressionDetectionResult(scores[i] >= 0);
+  }
+}
+
 void TrainedSvmDetector::outputProgress(std::string progressStr) {
+  dlib::auto_mutex lock(progressMutex);
 
   std::cout << progressStr << std::endl;
 
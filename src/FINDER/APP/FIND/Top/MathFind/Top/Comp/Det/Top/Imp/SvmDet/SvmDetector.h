@@ -10,12 +10,19 @@
 
 #include <Detector.h>
 #include <BlobDataGrid.h>
+#include <SvmBatchScorer.h>
+#include <SvmDistanceCache.h>
+#include <SvmCheckpoint.h>
 
 #include <dlib/svm_threaded.h>
+#include <dlib/threads.h>
+#include <dlib/smart_pointers_thread_safe.h>
 
 #include <iostream>
 #include <vector>
 #include <string>
+#include <map>
+#include <time.h>
 
 #define PROGRESS_TO_FILE_OBJECTIVE
 
@@ -36,17 +43,34 @@ typedef dlib::linear_kernel<sample_type> LinearKernel;
 typedef dlib::decision_function<LinearKernel> LinearSVMPredictor;
 typedef dlib::normalized_function<LinearSVMPredictor> LinearSVMNormalizedPredictor;
 
+// The predictor for whichever kernel is enabled
+#ifdef RBF_KERNEL
+typedef RBFSVMNormalizedPredictor TrainedSVMPredictor;
+#endif
+#ifdef LINEAR_KERNEL
+typedef LinearSVMNormalizedPredictor TrainedSVMPredictor;
+#endif
+typedef dlib::shared_ptr_thread_safe<const TrainedSVMPredictor> SharedSVMPredictor;
+typedef dlib::shared_ptr_thread_safe<const RBFSVMBatchScorer> SharedSVMBatchScorer;
+
 // Copied from dlib's model_selection_ex.cpp with the following modifications:
 // - Divides the data into a variable number of subsets for cross validation.
 // - Uses C-SVM rather than Nu-SVM
 // - Uses multiple threads (one for each fold of cross validation)
+// - Uses the RBF kernel over the cached squared distances between the samples
+// - Checkpoints each result (and reuses the checkpointed one if there is one)
 // - TODO: Modify cross validation return value to be maximized.
 class cross_validation_objective {
  public:
   cross_validation_objective (const std::vector<sample_type>& samples_,
       const std::vector<double>& labels_, int folds_,
-      std::ofstream* const progressFile) :
-        samples(samples_), labels(labels_), folds(folds_) {
+      std::ofstream* const progressFile,
+      const SquaredDistanceCache* const distanceCache_,
+      CrossValidationCheckpoint* const checkpoint_) :
+        samples(samples_), labels(labels_), folds(folds_),
+        distanceCache(distanceCache_),
+        sampleIndices(SquaredDistanceCache::getSampleIndices(samples_.size())),
+        checkpoint(checkpoint_) {
     this->progressFile = progressFile;
   }
 
@@ -59,10 +83,11 @@ class cross_validation_objective {
     const double gamma    = std::exp(params(1));
 
     // Make an SVM trainer and tell it what the parameters are supposed to be.
-    dlib::svm_c_trainer<RBFKernel> trainer;
-    trainer.set_kernel(RBFKernel(gamma));
+    dlib::svm_c_trainer<CachedRBFKernel> trainer;
+    trainer.set_kernel(CachedRBFKernel(distanceCache, gamma));
 #endif
 #ifdef LINEAR_KERNEL
+    const double gamma = 0; // not a parameter of the linear kernel
     dlib::svm_c_trainer<LinearKernel> trainer;
 #endif
     trainer.set_c(C);
@@ -72,7 +97,16 @@ class cross_validation_objective {
     cout << "Running cross validation on Linear Kernel SVM with ";
     cout << "C: " << setw(11) << C << endl;
 #endif
-    dlib::matrix<double> result = dlib::cross_validate_trainer_threaded(trainer, samples, labels, folds, folds);
+    dlib::matrix<double, 1, 2> result;
+    if(!checkpoint->findResult(labels.size(), folds, C, gamma, result)) {
+#ifdef RBF_KERNEL
+      result = dlib::cross_validate_trainer_threaded(trainer, sampleIndices, labels, folds, folds);
+#endif
+#ifdef LINEAR_KERNEL
+      result = dlib::cross_validate_trainer_threaded(trainer, samples, labels, folds, folds);
+#endif
+      checkpoint->addResult(labels.size(), folds, C, gamma, result);
+    }
 #ifdef RBF_KERNEL
     outputProgress(std::string("C: ") + Utils::doubleToString(C, 11) +
         std::string("  gamma: ") + Utils::doubleToString(gamma, 11) +
@@ -98,6 +132,9 @@ class cross_validation_objective {
   const std::vector<sample_type>& samples;
   const std::vector<double>& labels;
   int folds;
+  const SquaredDistanceCache* distanceCache;
+  std::vector<unsigned long> sampleIndices; // what the cached kernel takes
+  CrossValidationCheckpoint* checkpoint;
 
   std::ofstream* progressFile;
   void outputProgress(std::string progressStr) const {
@@ -124,9 +161,86 @@ class TrainedSvmDetector : virtual public MathExpressionDetector {
 
   bool doTraining(const std::vector<std::vector<BLSample*> >& samples);
 
+  /**
+   * Hook for long-running processes: reads the predictor back in from disk if
+   * its file has changed since it was loaded (i.e., the detector has been
+   * retrained). Every detector using the same predictor file picks up the new
+   * one on its next page, pages already being worked on finish with the old
+   * one. Returns true if the predictor was reloaded.
+   */
+  bool reloadPredictorIfChanged();
+
+  /**
+   * A predictor read in from disk along with its batch scorer (null unless
+   * the kernel is RBF) and the modification time of its file
+   */
+  struct LoadedPredictorFile {
+    SharedSVMPredictor predictor;
+    SharedSVMBatchScorer scorer;
+    time_t modifiedTime;
+  };
+
+  /**
+   * Gets the predictor saved at the given path, only reading it in from disk
+   * the first time (or when forced to). Every detector in the process using
+   * the same file shares the one in memory.
+   */
+  static LoadedPredictorFile loadPredictorFile(const std::string& path,
+      const bool& forceReload=false);
+
+  /**
+   * Gets all of the blobs in the grid in the order the full search returns
+   * them
+   */
+  static std::vector<BlobData*> getBlobs(BlobDataGrid* const blobDataGrid);
+
+  /**
+   * Runs the predictor on all of the blobs at once through its batch scorer
+   * and sets their detection results
+   */
+  static void predictAll(const TrainedSVMPredictor& predictor,
+      const RBFSVMBatchScorer& scorer, const std::vector<BlobData*>& blobs);
+
  private:
 
   void doCoarseCVTraining(int folds); // coarse grid search to find starting params for doFineCVTraining
+
+  // A (C, gamma) pair on the coarse grid along with its cross validation
+  // accuracy (positive, negative) on the samples it was last run on
+  struct GridPoint {
+    double C;
+    double gamma; // unused with the linear kernel
+    dlib::matrix<double, 1, 2> result;
+  };
+
+  // Cross validates each of the grid points on the first numSamples training
+  // samples, running as many of them at once as the thread budget allows
+  void crossValidateGridPoints(std::vector<GridPoint>& points,
+      const int& numSamples, const int& folds);
+
+  // run by the thread pool for the point at the given index
+  void crossValidateGridPoint(long pointIndex);
+
+  // Gets the number of samples to cross validate on for the given round of
+  // the coarse search's successive halving. Each round has 3 times as many
+  // as the one before and the last round has all of them. The number is
+  // raised if need be so that every fold gets samples of both classes.
+  int getHalvingRoundSize(const int& round, const int& folds);
+
+  static bool isBetterGridPoint(const GridPoint& point1,
+      const GridPoint& point2);
+
+  // state shared with the thread pool during a round of the coarse search
+  std::vector<GridPoint>* jobPoints;
+#ifdef RBF_KERNEL
+  std::vector<unsigned long> jobSampleIndices;
+#endif
+#ifdef LINEAR_KERNEL
+  std::vector<sample_type> jobSamples;
+#endif
+  std::vector<double> jobLabels;
+  int jobFolds;
+  int jobThreadsPerPoint;
   void doFineCVTraining(int folds); // uses BOBYQA to get final optimized params
 
   void saveOptParams(); // save optimal parameters for later use
@@ -135,10 +249,31 @@ class TrainedSvmDetector : virtual public MathExpressionDetector {
 
   void trainFinalClassifier();
 
+  // Nearly every blob is a negative (non-math) one and most of them are easy
+  // to get right, so with NEGATIVE_SUBSAMPLING enabled (at the top of
+  // SvmDetector.cpp) rather than training on all of them the SVM is trained
+  // on all of the positives and only negativeRatio times as many negatives.
+  // The rest of the negatives are held out and each of a few rounds of hard
+  // negative mining adds the held out ones the classifier gets wrong back in
+  // and retrains it.
+  void subsampleNegatives();
+  void mineHardNegatives();
+
+  // run by the thread pool, scores a chunk of the held out negatives with
+  // the final predictor
+  void scoreHeldOutNegatives(long chunk);
+
+  static const int negativeRatio = 3;
+  static const int numHardNegativeRounds = 3;
+  std::vector<sample_type> heldOutNegatives; // normalized like the training samples
+  std::vector<double> heldOutScores;
+  long heldOutChunkSize;
+
   void savePredictor(); // serialize and save the predictor for later use
-  void loadPredictor(); // read in a previously serialized predictor
+  void loadPredictor(const bool& forceReload=false); // get the previously serialized predictor,
+                                                     // only read in from disk if not already
 
-  bool predict(const std::vector<DoubleFeature*>& sample);
+  bool predict(const double* const sample, const int& numFeatures);
 
   // the training samples and their corresponding labels
   // obviously these two vectors should be the same size
@@ -147,6 +282,16 @@ class TrainedSvmDetector : virtual public MathExpressionDetector {
 
   dlib::vector_normalizer<sample_type> normalizer;
 
+  // the squared distances between the normalized training samples, only
+  // exists while cross validating to find the optimal parameters
+  SquaredDistanceCache* distanceCache;
+  static const size_t distanceCacheMaxBytes = (size_t)2 << 30;
+
+  // every cross validation result computed while finding the optimal
+  // parameters so an interrupted run can be resumed, only exists while
+  // finding them
+  CrossValidationCheckpoint* checkpoint;
+
   // the optimal gamma and C parameters for the SVM
 #ifdef RBF_KERNEL
   double gamma_optimal;
@@ -162,10 +307,21 @@ class TrainedSvmDetector : virtual public MathExpressionDetector {
   LinearSVMNormalizedPredictor final_predictor;
 #endif
 
+  // the saved predictor used for detection, shared read-only with every
+  // other detector in the process using the same file (null until loaded)
+  SharedSVMPredictor loadedPredictor;
+  SharedSVMBatchScorer loadedScorer; // null unless the kernel is RBF
+
+  // The predictors read in so far, keyed on the predictor path
+  static std::map<std::string, LoadedPredictorFile> loadedPredictorFiles;
+  static dlib::mutex loadedPredictorFilesMutex;
+  static time_t getModifiedTime(const std::string& path);
+
   std::string predictorPath;
 
   std::string progressFilePath;
   std::ofstream progressFile;
+  dlib::mutex progressMutex; // progress can come from several threads at once
   void outputProgress(std::string progressStr);
 };
 
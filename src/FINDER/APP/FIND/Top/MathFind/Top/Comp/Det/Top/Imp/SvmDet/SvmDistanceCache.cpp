@@ -0,0 +1,88 @@
+/*
+ * SvmDistanceCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <SvmDistanceCache.h>
+
+#include <Utils.h>
+
+#include <dlib/threads.h>
+
+#include <algorithm>
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+
+SquaredDistanceCache::SquaredDistanceCache(
+    const std::vector<DistanceCachedSample>& samples, const size_t& maxBytes)
+: samples(samples), numCached(0) {
+  // cache as many of the first samples as the triangle fits in the budget for
+  const size_t maxDistances = maxBytes / sizeof(double);
+  numCached = samples.size();
+  while(numCached > 0 && getRowOffset(numCached) > maxDistances) {
+    --numCached;
+  }
+  distances.resize(getRowOffset(numCached));
+
+  const long numTileRows = (numCached + tileSize - 1) / tileSize;
+  dlib::thread_pool threadPool(
+      std::max(1L, std::min((long)Utils::getNumProcessors(), numTileRows)));
+  for(long i = 0; i < numTileRows; ++i) {
+    threadPool.add_task(*this, &SquaredDistanceCache::computeTileRow, i);
+  }
+  threadPool.wait_for_all_tasks();
+}
+
+double SquaredDistanceCache::getSquaredDistance(const unsigned long& i,
+    const unsigned long& j) const {
+  const unsigned long row = std::max(i, j);
+  const unsigned long col = std::min(i, j);
+  if(row < numCached) {
+    return distances[getRowOffset(row) + col];
+  }
+  assert(row < samples.size());
+  return computeSquaredDistance(samples[row], samples[col]);
+}
+
+long SquaredDistanceCache::getNumCached() const {
+  return numCached;
+}
+
+std::vector<unsigned long> SquaredDistanceCache::getSampleIndices(
+    const int& numSamples) {
+  std::vector<unsigned long> indices(numSamples);
+  for(int i = 0; i < numSamples; ++i) {
+    indices[i] = i;
+  }
+  return indices;
+}
+
+// each tile is the distances between tileSize rows and tileSize columns so
+// the column samples get reused while they're still in the cpu's cache
+void SquaredDistanceCache::computeTileRow(long tileRow) {
+  const long rowBegin = tileRow * tileSize;
+  const long rowEnd = std::min(rowBegin + tileSize, numCached);
+  for(long colBegin = 0; colBegin <= rowBegin; colBegin += tileSize) {
+    for(long row = rowBegin; row < rowEnd; ++row) {
+      const long colEnd = std::min(colBegin + tileSize, row + 1);
+      double* const rowDistances = &distances[getRowOffset(row)];
+      for(long col = colBegin; col < colEnd; ++col) {
+        rowDistances[col] = computeSquaredDistance(samples[row], samples[col]);
+      }
+    }
+  }
+}
+
+// the same as dlib's radial_basis_kernel
+double SquaredDistanceCache::computeSquaredDistance(
+    const DistanceCachedSample& a, const DistanceCachedSample& b) {
+  const double d = trans(a-b)*(a-b);
+  return d;
+}
+
+size_t SquaredDistanceCache::getRowOffset(const unsigned long& row) {
+  return ((size_t)row * (row + 1)) / 2;
+}
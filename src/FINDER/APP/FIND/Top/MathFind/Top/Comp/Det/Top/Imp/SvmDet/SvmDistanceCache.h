@@ -0,0 +1,102 @@
+/*
+ * SvmDistanceCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef SVMDISTANCECACHE_H_
+#define SVMDISTANCECACHE_H_
+
+#include <dlib/svm_threaded.h>
+
+#include <vector>
+#include <math.h>
+#include <stddef.h>
+
+// Same as the sample_type in SvmDetector.h (which includes this)
+typedef dlib::matrix<double, 0, 1> DistanceCachedSample;
+
+/**
+ * The squared euclidean distance between every pair of (normalized) training
+ * samples, computed once up front so that cross validating an RBF SVM for
+ * another gamma doesn't mean computing them all over again for every fold.
+ * The distances are kept as the lower triangle of the distance matrix for as
+ * many of the first samples as fit in the given number of bytes, computed a
+ * tile of rows and columns at a time by a thread pool. Distances involving a
+ * sample past those are computed when asked for. Each distance is computed
+ * exactly the way dlib's radial_basis_kernel does it, so kernel values (and so
+ * cross validation results) come out the same as they would without the cache.
+ *
+ * The samples must outlive the cache. Once constructed the cache is read-only
+ * so it can be shared by any number of threads.
+ */
+class SquaredDistanceCache {
+ public:
+
+  SquaredDistanceCache(const std::vector<DistanceCachedSample>& samples,
+      const size_t& maxBytes);
+
+  double getSquaredDistance(const unsigned long& i,
+      const unsigned long& j) const;
+
+  /**
+   * Number of samples (from the first one on) whose distances to each other
+   * are all cached
+   */
+  long getNumCached() const;
+
+  /**
+   * Gets the indices of the first numSamples samples, which are what the
+   * CachedRBFKernel takes in place of the samples themselves
+   */
+  static std::vector<unsigned long> getSampleIndices(const int& numSamples);
+
+ private:
+
+  // computes the distances for every tile in the given row of tiles (run by
+  // the thread pool)
+  void computeTileRow(long tileRow);
+
+  static double computeSquaredDistance(const DistanceCachedSample& a,
+      const DistanceCachedSample& b);
+
+  static size_t getRowOffset(const unsigned long& row);
+
+  static const long tileSize = 256;
+
+  const std::vector<DistanceCachedSample>& samples;
+  long numCached;
+  std::vector<double> distances; // row i starts at getRowOffset(i)
+};
+
+/**
+ * An RBF kernel over the indices of the samples in a SquaredDistanceCache
+ * rather than over the samples themselves, so each kernel evaluation is just
+ * an exp() of a cached distance
+ */
+class CachedRBFKernel {
+ public:
+  typedef unsigned long sample_type;
+  typedef double scalar_type;
+  typedef dlib::default_memory_manager mem_manager_type;
+
+  CachedRBFKernel() : cache(NULL), gamma(0.1) {}
+  CachedRBFKernel(const SquaredDistanceCache* const cache,
+      const scalar_type& gamma) : cache(cache), gamma(gamma) {}
+
+  scalar_type operator() (const sample_type& a, const sample_type& b) const {
+    return std::exp(-gamma * cache->getSquaredDistance(a, b));
+  }
+
+  bool operator== (const CachedRBFKernel& k) const {
+    return cache == k.cache && gamma == k.gamma;
+  }
+
+ private:
+  const SquaredDistanceCache* cache;
+  scalar_type gamma;
+};
+
+
+#endif /* SVMDISTANCECACHE_H_ */
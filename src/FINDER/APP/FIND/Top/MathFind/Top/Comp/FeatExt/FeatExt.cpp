@@ -8,9 +8,13 @@
 #include <FeatExt.h>
 
 #include <BlobDataGrid.h>
+#include <FeatureMatrix.h>
 #include <Utils.h>
 #include <M_Utils.h>
 
+#include <vector>
+#include <assert.h>
+
 //#define DBG_FEAT_EXT
 //#define DBG_AFTER_EXTRACTION
 //#define DBG_FEAT_EXT_WAIT
@@ -18,9 +22,20 @@
 
 MathExpressionFeatureExtractor::MathExpressionFeatureExtractor(
     FinderInfo* finderInfo,
-    std::vector<BlobFeatureExtractor*> blobFeatureExtractors) {
+    std::vector<BlobFeatureExtractor*> blobFeatureExtractors,
+    std::vector<BlobFeatureExtractorFactory*> blobFeatureExtractorFactories) {
+  assert(blobFeatureExtractors.size() == blobFeatureExtractorFactories.size());
   this->finderInfo = finderInfo;
   this->blobFeatureExtractors = blobFeatureExtractors;
+  this->blobFeatureExtractorFactories = blobFeatureExtractorFactories;
+
+  // Lay out the extractors' columns one after the other
+  numFeatures = 0;
+  for(int i = 0; i < blobFeatureExtractors.size(); ++i) {
+    blobFeatureExtractors[i]->resolveFeatureColumns();
+    firstFeatureColumns.push_back(numFeatures);
+    numFeatures += blobFeatureExtractors[i]->getNumFeatureColumns();
+  }
 }
 
 void MathExpressionFeatureExtractor::doFinderInitialization() {
@@ -44,6 +59,18 @@ void MathExpressionFeatureExtractor::doTrainerInitialization() {
   }
 }
 
+MathExpressionFeatureExtractor* MathExpressionFeatureExtractor::createTrainingWorker() {
+  std::vector<BlobFeatureExtractor*> workerExtractors;
+  for(int i = 0; i < blobFeatureExtractorFactories.size(); ++i) {
+    BlobFeatureExtractor* const workerExtractor =
+        blobFeatureExtractorFactories[i]->create(finderInfo);
+    workerExtractor->doWorkerInitialization(blobFeatureExtractors[i]);
+    workerExtractors.push_back(workerExtractor);
+  }
+  return new MathExpressionFeatureExtractor(finderInfo, workerExtractors,
+      blobFeatureExtractorFactories);
+}
+
 void MathExpressionFeatureExtractor::extractFeatures(BlobDataGrid* const blobDataGrid) {
 
   // For each feature extractor, first do any necessary preprocessing
@@ -60,45 +87,28 @@ void MathExpressionFeatureExtractor::extractFeatures(BlobDataGrid* const blobDat
 #endif
   }
 
-  // Now, for each blob on the grid, run all of the blob feature extraction logic
+  // Now give each blob on the grid a row in the page's feature matrix
+  std::vector<BlobData*> blobs;
   BlobDataGridSearch search(blobDataGrid);
   search.StartFullSearch();
   BlobData* blob = NULL;
   while((blob = search.NextFullSearch()) != NULL) {
-    for(int i = 0; i < blobFeatureExtractors.size(); ++i) {
-      // Do the feature extraction
-      std::vector<DoubleFeature*> unorderedBlobFeatures =
-          blobFeatureExtractors[i]->extractFeatures(blob);
-      assert(unorderedBlobFeatures.size() > 0);
-
-      // If it's just one feature then go ahead and append it to the blob's extracted feature list
-      if(unorderedBlobFeatures.size() == 1) {
-        blob->appendExtractedFeatures(unorderedBlobFeatures);
-        continue;
-      }
-
-      // If there are multiple features here then they were extracted based
-      // on multiple flags within the same extractor. If so, need to make sure
-      // these flag-based extracted features are added to the blob in the same
-      // order they were specified in based on this Finder's info.
-      std::vector<DoubleFeature*> orderedFlagFeatures;
-      std::vector<FeatureExtractorFlagDescription*> orderedFlagDescriptions = blobFeatureExtractors[i]->getEnabledFlagDescriptions();
-      for(int j = 0; j < orderedFlagDescriptions.size(); ++j) {
-        bool found = false;
-        for(int k = 0; k < unorderedBlobFeatures.size(); ++k) {
-          if(unorderedBlobFeatures[k]->getFlagDescription()->getName() == orderedFlagDescriptions[j]->getName()) {
-            orderedFlagFeatures.push_back(unorderedBlobFeatures[k]);
-            found = true;
-            break;
-          }
-        }
-        assert(found); // sanity
-      }
-      assert(orderedFlagFeatures.size() > 1); // sanity
-      blob->appendExtractedFeatures(orderedFlagFeatures);
+    blob->setFeatureRow(blobs.size());
+    blobs.push_back(blob);
+  }
+  FeatureMatrix* const featureMatrix = new FeatureMatrix(blobs.size(), numFeatures);
+  blobDataGrid->setFeatureMatrix(featureMatrix);
+
+  // Then run all of the blob feature extraction logic, each extractor filling in
+  // its own columns of the blob's row
+  for(int i = 0; i < blobs.size(); ++i) {
+    double* const row = featureMatrix->getRow(i);
+    for(int j = 0; j < blobFeatureExtractors.size(); ++j) {
+      blobFeatureExtractors[j]->extractFeatures(blobs[i],
+          row + firstFeatureColumns[j]);
     }
 #ifdef DBG_FEATURE_ORDERING
-      dbgShowFeatureOrdering(blob);
+    dbgShowFeatureOrdering(blobs[i]);
 #endif
   }
 }
@@ -107,6 +117,10 @@ std::vector<BlobFeatureExtractor*> MathExpressionFeatureExtractor::getBlobFeatur
   return blobFeatureExtractors;
 }
 
+int MathExpressionFeatureExtractor::getNumFeatures() {
+  return numFeatures;
+}
+
 FinderInfo* MathExpressionFeatureExtractor::getFinderInfo() {
   return finderInfo;
 }
@@ -122,10 +136,15 @@ MathExpressionFeatureExtractor::~MathExpressionFeatureExtractor() {
 void MathExpressionFeatureExtractor::dbgShowFeatureOrdering(
     BlobData* const blobData) {
   std::cout << "Finished adding features for the displayed blob. Here are the features (format -> [featurName]_[featureFlag]):\n";
-  for(int j = 0; j < blobData->getExtractedFeatures().size(); ++j) {
-    std::cout << blobData->getExtractedFeatures()[j]->getFeatureExtractorDescription()->getName()
-        << "_" << blobData->getExtractedFeatures()[j]->getFlagDescription()->getName()
-        << ": " << blobData->getExtractedFeatures()[j]->getFeature() << std::endl;
+  const double* const features = blobData->getExtractedFeatures();
+  for(int i = 0; i < blobFeatureExtractors.size(); ++i) {
+    const std::vector<FeatureExtractorFlagDescription*> flags =
+        blobFeatureExtractors[i]->getEnabledFlagDescriptions();
+    for(int j = 0; j < blobFeatureExtractors[i]->getNumFeatureColumns(); ++j) {
+      std::cout << blobFeatureExtractors[i]->getFeatureExtractorDescription()->getName()
+          << "_" << (flags.empty() ? std::string("") : flags[j]->getName())
+          << ": " << features[firstFeatureColumns[i] + j] << std::endl;
+    }
   }
   M_Utils::dbgDisplayBlob(blobData);
 }
@@ -9,6 +9,7 @@
 #define MATHEXPRESSIONFEATUREEXTRACTOR_H_
 
 #include <BlobFeatExt.h>
+#include <BlobFeatExtFac.h>
 
 #include <FinderInfo.h>
 
@@ -28,10 +29,14 @@ class MathExpressionFeatureExtractor {
    * Takes a list of blob feature extractors which are utilized. Both the pre-processing
    * and the individual blob feature extraction are invoked for all extractors provided
    * for each blob in the image. The results of the feature extractions are stored in the
-   * blobs.
+   * grid's FeatureMatrix. Each extractor's columns in that matrix are laid out here, so
+   * all of the extractors' flags must already be enabled. The factories are the
+   * ones the extractors were created with (in the same order), kept for
+   * creating training workers.
    */
   MathExpressionFeatureExtractor(FinderInfo* finderInfo,
-      std::vector<BlobFeatureExtractor*> blobFeatureExtractors);
+      std::vector<BlobFeatureExtractor*> blobFeatureExtractors,
+      std::vector<BlobFeatureExtractorFactory*> blobFeatureExtractorFactories);
 
   /**
    * Initialization to be invoked when in Finder mode
@@ -44,20 +49,35 @@ class MathExpressionFeatureExtractor {
    */
   void doTrainerInitialization();
 
+  /**
+   * Creates another extractor with the same blob feature extractors as this
+   * one (which has to have already had its trainer initialization done) for
+   * extracting the features from other training pages at the same time. The
+   * extractors keep state for the page they're on, so each thread needs its
+   * own, but the worker shares whatever this one computed while initializing.
+   * Owned by the caller.
+   */
+  MathExpressionFeatureExtractor* createTrainingWorker();
+
   /**
    * Extracts features from the given grid of connected components (groups of connected
    * pixels) that will be used for mathematical expression detection and segmentation.
-   * The provided grid is updated so that each entry contains its extracted features. The
-   * extracted features are represented by a vector containing the features as double
-   * values in the expected order depending on which feature extraction technique is
-   * used for the subsequent detection and segmentation phases. Other values
-   * and data structures may be required depending on the detection and segmentation
-   * technique being utilized.
+   * The provided grid is given a FeatureMatrix holding a row of features for each of its
+   * entries, and each entry is told its row. The features in a row are double values in
+   * the expected order depending on which feature extraction technique is used for the
+   * subsequent detection and segmentation phases. Other values and data structures may
+   * be required depending on the detection and segmentation technique being utilized.
    */
   void extractFeatures(BlobDataGrid* const blobDataGrid);
 
   std::vector<BlobFeatureExtractor*> getBlobFeatureExtractors();
 
+  /**
+   * Gets the number of features extracted from each blob (the number of columns in
+   * the FeatureMatrix)
+   */
+  int getNumFeatures();
+
   ~MathExpressionFeatureExtractor(); // delete the dependencies
 
   FinderInfo* getFinderInfo();
@@ -67,6 +87,12 @@ class MathExpressionFeatureExtractor {
   FinderInfo* finderInfo;
 
   std::vector<BlobFeatureExtractor*> blobFeatureExtractors;
+  std::vector<BlobFeatureExtractorFactory*> blobFeatureExtractorFactories;
+
+  // the first column in the FeatureMatrix belonging to each of the blob feature
+  // extractors
+  std::vector<int> firstFeatureColumns;
+  int numFeatures;
 
   //dbg
   void dbgShowFeatureOrdering(
@@ -11,7 +11,9 @@
 #include <BlobData.h>
 #include <FeatExtFlagDesc.h>
 
+#include <iostream>
 #include <vector>
+#include <assert.h>
 
 BlobFeatureExtractor::BlobFeatureExtractor() {}
 
@@ -44,9 +46,36 @@ void BlobFeatureExtractor::doTrainerInitialization() {}
  */
 void BlobFeatureExtractor::doFinderInitialization() {}
 
+/**
+ * Called instead of the trainer initialization on an extractor working on
+ * other training pages alongside the given, already initialized, one.
+ */
+void BlobFeatureExtractor::doWorkerInitialization(
+    BlobFeatureExtractor* const initialized) {}
+
 std::vector<FeatureExtractorFlagDescription*> BlobFeatureExtractor::getEnabledFlagDescriptions() {
   return std::vector<FeatureExtractorFlagDescription*>();
 }
 
+void BlobFeatureExtractor::resolveFeatureColumns() {
+  columnFlags = getEnabledFlagDescriptions();
+}
+
+int BlobFeatureExtractor::getNumFeatureColumns() {
+  return columnFlags.empty() ? 1 : columnFlags.size();
+}
+
+int BlobFeatureExtractor::getFlagColumn(FeatureExtractorFlagDescription* const flag) {
+  for(int i = 0; i < columnFlags.size(); ++i) {
+    if(columnFlags[i] == flag) {
+      return i;
+    }
+  }
+  std::cout << "ERROR: The " << flag->getName() << " flag isn't enabled for the "
+      << getFeatureExtractorDescription()->getName() << " feature extractor.\n";
+  assert(false);
+  return -1;
+}
+
 BlobFeatureExtractor::~BlobFeatureExtractor() {}
 
@@ -9,9 +9,9 @@
 #define BLOBFEATUREEXTRACTOR_H_
 
 #include <BlobDataGrid.h>
-#include <DoubleFeature.h>
 #include <BlobData.h>
 #include <BlobFeatExtDesc.h>
+#include <FeatExtFlagDesc.h>
 
 #include <vector>
 
@@ -34,6 +34,14 @@ class BlobFeatureExtractor {
    */
   virtual void doFinderInitialization();
 
+  /**
+   * Called instead of doTrainerInitialization() on an extractor that will be
+   * run on other training pages alongside the given one (created by the same
+   * factory and already initialized for training). Shares whatever the given
+   * one computed during its initialization rather than computing it again.
+   */
+  virtual void doWorkerInitialization(BlobFeatureExtractor* const initialized);
+
   /**
    * Does any processing that requires looking at an entire page up front
    */
@@ -42,12 +50,13 @@ class BlobFeatureExtractor {
   /**
    * Extracts the features from the given blob while persisting any data
    * that may be needed later into the blob's variable data vector. The
-   * feature extracted are formatted as a vector of double values normalized
-   * for later use by a binary classifier in the detection stage. The persisted
-   * data may be needed by the segmentation stage. Returns the extracted features
-   * as a vector of doubles.
+   * features extracted are double values normalized for later use by a
+   * binary classifier in the detection stage, written into this extractor's
+   * columns of the blob's row in the page's FeatureMatrix (columns points
+   * at the first of them, see getFlagColumn()). The persisted data may be
+   * needed by the segmentation stage.
    */
-  virtual std::vector<DoubleFeature*> extractFeatures(BlobData* const blob) = 0;
+  virtual void extractFeatures(BlobData* const blob, double* const columns) = 0;
 
   /**
    * Gets the description of this feature extractor. The memory pointed at
@@ -57,9 +66,27 @@ class BlobFeatureExtractor {
 
   virtual std::vector<FeatureExtractorFlagDescription*> getEnabledFlagDescriptions();
 
+  /**
+   * Lays out this extractor's columns in the FeatureMatrix, one for each of
+   * its enabled flags in the order they were enabled (or just the one if it
+   * has no flags). Called once all of the flags have been enabled.
+   */
+  void resolveFeatureColumns();
+
+  /**
+   * Gets the number of columns this extractor fills in for each blob
+   */
+  int getNumFeatureColumns();
+
   virtual ~BlobFeatureExtractor();
 
  protected:
+  /**
+   * Gets the column (relative to this extractor's first column) the feature
+   * for the given enabled flag goes in.
+   */
+  int getFlagColumn(FeatureExtractorFlagDescription* const flag);
+
   /**
    * Determines the index in each blob's variable data vector where this
    * feature extractor will place its data. This is done by just getting
@@ -71,6 +98,10 @@ class BlobFeatureExtractor {
    */
   int findOpenBlobDataIndex(BlobDataGrid* const blobDataGrid);
 
+ private:
+
+  // the enabled flags, in the order of their columns
+  std::vector<FeatureExtractorFlagDescription*> columnFlags;
 };
 
 
@@ -61,18 +61,15 @@ void NumAlignedBlobsFeatureExtractor::doPreprocessing(BlobDataGrid* const blobDa
     assert(blobDataKey == blob->appendNewVariableData(data));
     if(rightwardFeatureEnabled) {
       const int count = countCoveredBlobs(blob, blobDataGrid, BlobSpatial::RIGHT);
-      data->setRhabcCount(count)
-          ->setRhabcFeature(M_Utils::expNormalize(count));
+      data->setRhabcCount(count);
     }
     if(upwardFeatureEnabled) {
       const int count = countCoveredBlobs(blob, blobDataGrid, BlobSpatial::UP);
-      data->setUvabcCount(count)
-          ->setUvabcFeature(M_Utils::expNormalize(count));
+      data->setUvabcCount(count);
     }
     if(downwardFeatureEnabled) {
       const int count = countCoveredBlobs(blob, blobDataGrid, BlobSpatial::DOWN);
-      data->setDvabcCount(count)
-          ->setDvabcFeature(M_Utils::expNormalize(count));
+      data->setDvabcCount(count);
     }
   }
 
@@ -84,7 +81,8 @@ void NumAlignedBlobsFeatureExtractor::doPreprocessing(BlobDataGrid* const blobDa
 #endif
 }
 
-std::vector<DoubleFeature*> NumAlignedBlobsFeatureExtractor::extractFeatures(BlobData* const blob) {
+void NumAlignedBlobsFeatureExtractor::extractFeatures(BlobData* const blob,
+    double* const columns) {
 
   NumAlignedBlobsData* const data = (NumAlignedBlobsData*)(blob->getVariableDataAt(blobDataKey));
 
@@ -102,7 +100,18 @@ std::vector<DoubleFeature*> NumAlignedBlobsFeatureExtractor::extractFeatures(Blo
     M_Utils::dbgDisplayBlob(blob);
 #endif
 
-  return data->getExtractedFeatures();
+  if(rightwardFeatureEnabled) {
+    columns[getFlagColumn(description->getRightwardFlagDescription())] =
+        M_Utils::expNormalize(data->getRhabcCount());
+  }
+  if(upwardFeatureEnabled) {
+    columns[getFlagColumn(description->getUpwardFlagDescription())] =
+        M_Utils::expNormalize(data->getUvabcCount());
+  }
+  if(downwardFeatureEnabled) {
+    columns[getFlagColumn(description->getDownwardFlagDescription())] =
+        M_Utils::expNormalize(data->getDvabcCount());
+  }
 }
 
 
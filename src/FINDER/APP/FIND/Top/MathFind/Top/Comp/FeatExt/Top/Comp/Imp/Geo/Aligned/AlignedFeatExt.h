@@ -11,7 +11,6 @@
 #include <BlobFeatExt.h>
 #include <AlignedDesc.h>
 #include <BlobDataGrid.h>
-#include <DoubleFeature.h>
 #include <BlobData.h>
 #include <BlobFeatExtDesc.h>
 #include <FeatExtFlagDesc.h>
@@ -29,7 +28,7 @@ class NumAlignedBlobsFeatureExtractor : public virtual BlobFeatureExtractor {
 
   void doPreprocessing(BlobDataGrid* const blobDataGrid);
 
-  std::vector<DoubleFeature*> extractFeatures(BlobData* const blob);
+  void extractFeatures(BlobData* const blob, double* const columns);
 
   BlobFeatureExtractorDescription* getFeatureExtractorDescription();
 
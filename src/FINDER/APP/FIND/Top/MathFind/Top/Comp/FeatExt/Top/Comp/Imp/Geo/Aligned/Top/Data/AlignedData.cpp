@@ -7,17 +7,12 @@
 
 #include <AlignedData.h>
 
-#include <DoubleFeature.h>
 
 NumAlignedBlobsData::NumAlignedBlobsData(
     NumAlignedBlobsFeatureExtractorDescription* const description) {
   this->description = description;
 }
 
-NumAlignedBlobsData* NumAlignedBlobsData::setRhabcFeature(const double feature) {
-  appendExtractedFeature(new DoubleFeature(description, feature, description->getRightwardFlagDescription()));
-  return this;
-}
 NumAlignedBlobsData* NumAlignedBlobsData::setRhabcCount(const int rhabcCount) {
   this->rhabcCount = rhabcCount;
   return this;
@@ -26,10 +21,6 @@ int NumAlignedBlobsData::getRhabcCount() {
   return rhabcCount;
 }
 
-NumAlignedBlobsData* NumAlignedBlobsData::setUvabcFeature(const double feature) {
-  appendExtractedFeature(new DoubleFeature(description, feature, description->getUpwardFlagDescription()));
-  return this;
-}
 NumAlignedBlobsData* NumAlignedBlobsData::setUvabcCount(const int uvabcCount) {
   this->uvabcCount = uvabcCount;
   return this;
@@ -38,10 +29,6 @@ int NumAlignedBlobsData::getUvabcCount() {
   return uvabcCount;
 }
 
-NumAlignedBlobsData* NumAlignedBlobsData::setDvabcFeature(const double feature) {
-  appendExtractedFeature(new DoubleFeature(description, feature, description->getDownwardFlagDescription()));
-  return this;
-}
 NumAlignedBlobsData* NumAlignedBlobsData::setDvabcCount(const int dvabcCount) {
   this->dvabcCount = dvabcCount;
   return this;
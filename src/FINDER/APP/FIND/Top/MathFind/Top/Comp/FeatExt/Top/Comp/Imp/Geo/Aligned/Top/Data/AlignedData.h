@@ -22,15 +22,12 @@ class NumAlignedBlobsData : public BlobFeatureExtractionData {
 
   NumAlignedBlobsData(NumAlignedBlobsFeatureExtractorDescription* const description);
 
-  NumAlignedBlobsData* setRhabcFeature(const double feature);
   NumAlignedBlobsData* setRhabcCount(const int rhabcCount);
   int getRhabcCount();
 
-  NumAlignedBlobsData* setUvabcFeature(const double feature);
   NumAlignedBlobsData* setUvabcCount(const int uvabcCount);
   int getUvabcCount();
 
-  NumAlignedBlobsData* setDvabcFeature(const double feature);
   NumAlignedBlobsData* setDvabcCount(const int dvabcCount);
   int getDvabcCount();
 
@@ -14,7 +14,6 @@
 #include <BlobDataGrid.h>
 #include <BlobData.h>
 #include <NestedData.h>
-#include <DoubleFeature.h>
 #include <M_Utils.h>
 #include <FinderInfo.h>
 #include <Utils.h>
@@ -56,13 +55,9 @@ void NumCompletelyNestedBlobsFeatureExtractor::doPreprocessing(BlobDataGrid* con
     // Add the data to the blob's variable data array
     assert(blobDataKey == blob->appendNewVariableData(data));
 
-    // Extract the feature put it in this feature's data (also adding any other necessary
-    // info to the feature's data).
-    data->appendExtractedFeature(
-        new DoubleFeature(description,
-            M_Utils::expNormalize(
-                countNestedBlobs(blob,
-                    blobDataGrid))));
+    // Count the nested blobs and put the count in this feature's data (the
+    // feature itself is just the normalized count).
+    data->setNestedBlobsCount(countNestedBlobs(blob, blobDataGrid));
   }
 
 #ifdef DBG_WRITE_NESTED
@@ -93,9 +88,12 @@ void NumCompletelyNestedBlobsFeatureExtractor::doPreprocessing(BlobDataGrid* con
 #endif
 }
 
-std::vector<DoubleFeature*> NumCompletelyNestedBlobsFeatureExtractor::extractFeatures(BlobData* const blobData) {
-  // Already did the extraction during preprocessing, so just return result
-  return blobData->getVariableDataAt(blobDataKey)->getExtractedFeatures();
+void NumCompletelyNestedBlobsFeatureExtractor::extractFeatures(BlobData* const blobData,
+    double* const columns) {
+  // Already counted the nested blobs during preprocessing, so just normalize the result
+  NumCompletelyNestedBlobsData* const data =
+      (NumCompletelyNestedBlobsData*)blobData->getVariableDataAt(blobDataKey);
+  columns[0] = M_Utils::expNormalize((double)data->getNestedBlobsCount());
 }
 
 int NumCompletelyNestedBlobsFeatureExtractor::countNestedBlobs(BlobData* const blob,
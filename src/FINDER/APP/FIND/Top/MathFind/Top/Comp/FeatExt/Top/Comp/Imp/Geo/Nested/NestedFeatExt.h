@@ -13,7 +13,6 @@
 #include <BlobDataGrid.h>
 #include <BlobData.h>
 #include <BlobFeatExtDesc.h>
-#include <DoubleFeature.h>
 #include <FinderInfo.h>
 
 #include <vector>
@@ -29,7 +28,7 @@ class NumCompletelyNestedBlobsFeatureExtractor
 
   void doPreprocessing(BlobDataGrid* const blobDataGrid);
 
-  virtual std::vector<DoubleFeature*> extractFeatures(BlobData* const blob);
+  virtual void extractFeatures(BlobData* const blob, double* const columns);
 
   BlobFeatureExtractorDescription* getFeatureExtractorDescription();
 
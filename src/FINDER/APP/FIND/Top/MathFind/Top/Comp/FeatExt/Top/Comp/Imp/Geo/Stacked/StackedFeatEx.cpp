@@ -12,7 +12,6 @@
 #include <BlobData.h>
 #include <StackedData.h>
 #include <Direction.h>
-#include <DoubleFeature.h>
 #include <M_Utils.h>
 #include <Utils.h>
 
@@ -64,12 +63,6 @@ void NumVerticallyStackedBlobsFeatureExtractor::doPreprocessing(BlobDataGrid* co
     data->setHasBeenProcessed(true); // probably not relevant but keeping for now
 
     data->setStackedBlobsCount(stacked_count);
-
-    data->appendExtractedFeature(
-        new DoubleFeature(
-            description,
-            M_Utils::expNormalize(
-                (double)stacked_count)));
   }
 #ifdef DBG_SHOW_STACKED_FEATURE
   gridSearch.StartFullSearch();
@@ -106,9 +99,12 @@ void NumVerticallyStackedBlobsFeatureExtractor::doPreprocessing(BlobDataGrid* co
 
 }
 
-std::vector<DoubleFeature*> NumVerticallyStackedBlobsFeatureExtractor::extractFeatures(BlobData* const blobData) {
-  // Already did the extraction during preprocessing, so just return result
-  return blobData->getVariableDataAt(blobDataKey)->getExtractedFeatures();
+void NumVerticallyStackedBlobsFeatureExtractor::extractFeatures(BlobData* const blobData,
+    double* const columns) {
+  // Already counted the stacked blobs during preprocessing, so just normalize the result
+  NumVerticallyStackedBlobsData* const data =
+      (NumVerticallyStackedBlobsData*)blobData->getVariableDataAt(blobDataKey);
+  columns[0] = M_Utils::expNormalize((double)data->getStackedBlobsCount());
 }
 
 int NumVerticallyStackedBlobsFeatureExtractor::countStacked(BlobData* const blob,
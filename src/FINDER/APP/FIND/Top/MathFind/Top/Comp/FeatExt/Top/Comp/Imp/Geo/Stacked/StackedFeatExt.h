@@ -11,7 +11,6 @@
 #include <BlobFeatExt.h>
 #include <StackedDesc.h>
 #include <BlobDataGrid.h>
-#include <DoubleFeature.h>
 #include <BlobData.h>
 #include <BlobFeatExtDesc.h>
 #include <StackedData.h>
@@ -40,7 +39,7 @@ class NumVerticallyStackedBlobsFeatureExtractor
 
   void doPreprocessing(BlobDataGrid* const blobDataGrid);
 
-  std::vector<DoubleFeature*> extractFeatures(BlobData* const blob);
+  void extractFeatures(BlobData* const blob, double* const columns);
 
   BlobFeatureExtractorDescription* getFeatureExtractorDescription();
 
@@ -11,12 +11,12 @@
 #include <FinderInfo.h>
 #include <NGram.h>
 #include <NGramRanker.h>
+#include <NGramIndex.h>
 #include <Utils.h>
 #include <NGProfile.h>
 #include <BlobDataGrid.h>
 #include <SentenceData.h>
 #include <M_Utils.h>
-#include <DoubleFeature.h>
 #include <BlobData.h>
 #include <BlockData.h>
 #include <WordData.h>
@@ -26,6 +26,7 @@
 #include <baseapi.h>
 
 #include <iostream>
+#include <sstream>
 #include <stddef.h>
 #include <assert.h>
 #include <vector>
@@ -34,6 +35,7 @@
 //#define DBG_SHOW_NGRAMS
 //#define DBG_SHOW_EACH_SENTENCE_NGRAM_FEATURE
 //#define DBG_WRITE_EACH_SENTENCE_NGRAM_FEATURE
+//#define DBG_WRITE_SENTENCE_NGRAMS
 
 SentenceNGramsFeatureExtractor::SentenceNGramsFeatureExtractor(
      SentenceNGramsFeatureExtractorDescription* const description,
@@ -50,14 +52,11 @@ SentenceNGramsFeatureExtractor::SentenceNGramsFeatureExtractor(
 
 SentenceNGramsFeatureExtractor::~SentenceNGramsFeatureExtractor() {
   delete ngramRanker;
-
-  // Delete the ngram profile if non-empty
-  NGramRanker::destroyNGramVecs(mathNGramProfile);
 }
 
 void SentenceNGramsFeatureExtractor
 ::doTrainerInitialization() {
-  mathNGramProfile =
+  RankedNGramVecs mathNGramProfile =
       NGramProfileGenerator(finderInfo, ngramRanker, ngramdir)
       .generateMathNGrams();
 #ifdef DBG_DISPLAY_NG_PROFILE
@@ -72,19 +71,37 @@ void SentenceNGramsFeatureExtractor
     }
   }
 #endif
+  compileNGramProfile(mathNGramProfile);
 }
 
 void SentenceNGramsFeatureExtractor::doFinderInitialization() {
-  mathNGramProfile =
+  RankedNGramVecs mathNGramProfile =
       NGramProfileGenerator(finderInfo, ngramRanker, ngramdir)
       .readInOldNGrams(ngramdir);
+  compileNGramProfile(mathNGramProfile);
+}
+
+void SentenceNGramsFeatureExtractor::doWorkerInitialization(
+    BlobFeatureExtractor* const initialized) {
+  SentenceNGramsFeatureExtractor* const other =
+      dynamic_cast<SentenceNGramsFeatureExtractor*>(initialized);
+  assert(other != NULL && other->mathNGramIndex.get() != NULL);
+  mathNGramIndex = other->mathNGramIndex;
+}
+
+void SentenceNGramsFeatureExtractor::compileNGramProfile(
+    RankedNGramVecs& profile) {
+  mathNGramIndex = dlib::shared_ptr_thread_safe<const NGramProfileIndex>(
+      new NGramProfileIndex(profile));
+  NGramRanker::destroyNGramVecs(profile);
 }
 
 void SentenceNGramsFeatureExtractor::doPreprocessing(
     BlobDataGrid* const blobDataGrid) {
+  assert(mathNGramIndex.get() != NULL); // initialization has to have been done
 
   // Determine the N-Gram features for each sentence
-  // -- first get the ranked ngram vectors for each sentence
+  // -- first find the n-grams in each sentence that could be in the profile
   std::vector<TesseractSentenceData*> page_sentences = blobDataGrid->getAllRecognizedSentences();
   for(int i = 0; i < page_sentences.size(); ++i) {
     TesseractSentenceData* cursentence = page_sentences[i];
@@ -92,13 +109,25 @@ void SentenceNGramsFeatureExtractor::doPreprocessing(
       std::cout << "in null sentence at sentence " << i+1 << " of " << page_sentences.size() << std::endl;
     }
     assert(cursentence->sentence_txt != NULL); // shouldn't have been added in the first place if empty
-    RankedNGramVecs* sentence_ngrams = new RankedNGramVecs;
-    *sentence_ngrams = ngramRanker->generateSentenceNGrams(cursentence, ngramdir);
-    cursentence->setNGramCounts(sentence_ngrams); // store the n-grams in the sentence
+    NGramKeyVecs sentence_ngrams;
+    ngramRanker->findNGramKeys(cursentence, blobDataGrid->getTessBaseAPI(),
+        *mathNGramIndex, sentence_ngrams);
+    cursentence->setNGramKeys(sentence_ngrams); // store the n-grams in the sentence
+#ifdef DBG_WRITE_SENTENCE_NGRAMS
+    // each sentence's n-grams go in their own directory so pages processed
+    // in parallel don't write over each other's
+    std::stringstream sentenceDir;
+    sentenceDir << ngramdir << "Sentence-NGrams/" << blobDataGrid->getImageName()
+        << "/" << i << "/";
+    Utils::exec("mkdir -p " + sentenceDir.str());
+    RankedNGramVecs allSentenceNGrams = ngramRanker->generateSentenceNGrams(
+        cursentence, blobDataGrid->getTessBaseAPI(), sentenceDir.str());
+    NGramRanker::destroyNGramVecs(allSentenceNGrams);
+#endif
 #ifdef DBG_SHOW_NGRAMS
     std::cout << "Displaying the N-Grams found for the following sentence:\n"
         << cursentence->sentence_txt << std::endl;
-    dbgDisplayNGrams(*(cursentence->ngrams));
+    dbgDisplayNGrams(cursentence->getNGramKeys());
     M_Utils m;
     m.waitForInput();
 #endif
@@ -134,8 +163,8 @@ void SentenceNGramsFeatureExtractor::doPreprocessing(
 #endif
 }
 
-std::vector<DoubleFeature*> SentenceNGramsFeatureExtractor
-::extractFeatures(BlobData* const blob) {
+void SentenceNGramsFeatureExtractor
+::extractFeatures(BlobData* const blob, double* const columns) {
   double unigram = (double)0, bigram = (double)0, trigram = (double)0;
   TesseractSentenceData* blob_sentence = getBlobSentence(blob);
   if(blob_sentence != NULL) {
@@ -146,19 +175,15 @@ std::vector<DoubleFeature*> SentenceNGramsFeatureExtractor
     trigram = sentence_ngram_features[2];
   }
 
-  std::vector<DoubleFeature*> fv;
-
   if(isUnigramFlagEnabled) {
-    fv.push_back(new DoubleFeature(description, unigram, description->getUnigramFlag()));
+    columns[getFlagColumn(description->getUnigramFlag())] = unigram;
   }
   if(isBigramFlagEnabled) {
-    fv.push_back(new DoubleFeature(description, bigram, description->getBigramFlag()));
+    columns[getFlagColumn(description->getBigramFlag())] = bigram;
   }
   if(isTrigramFlagEnabled) {
-    fv.push_back(new DoubleFeature(description, trigram, description->getTrigramFlag()));
+    columns[getFlagColumn(description->getTrigramFlag())] = trigram;
   }
-
-  return fv;
 }
 
 TesseractSentenceData* SentenceNGramsFeatureExtractor::getBlobSentence(
@@ -194,10 +219,11 @@ double SentenceNGramsFeatureExtractor::getNGFeature(
   assert(gram > 0 && gram < 4); // only uni, bi, and tri-grams supported
   double ng_feat = 0;
   const int gramindex = gram - 1; // zero-based index
-  RankedNGramVecs ngramsvec = *sentence->ngrams;
-  RankedNGramVec ngrams = ngramsvec[gramindex];
+  // each occurrence adds its n-gram's profile frequency (the same as
+  // multiplying each distinct n-gram's count by it)
+  const NGramKeyVec& ngrams = sentence->getNGramKeys()[gramindex];
   for(int i = 0; i < ngrams.length(); ++i) {
-    ng_feat += findNGProfileMatch(ngrams[i], mathNGramProfile[gramindex], gram);
+    ng_feat += findNGProfileMatch(ngrams[i], gram);
   }
 #ifdef DBG_SHOW_EACH_SENTENCE_NGRAM_FEATURE
   std::cout << "Sentence:\n" << sentence->sentence_txt << std::endl;
@@ -208,7 +234,7 @@ double SentenceNGramsFeatureExtractor::getNGFeature(
   dbgfs << "The unscaled " << gram << "-gram feature for the above sentence: "
       << ng_feat << std::endl;
 #endif
-  ng_feat = scaleNGramFeature(ng_feat, mathNGramProfile[gramindex]);
+  ng_feat = scaleNGramFeature(ng_feat, gram);
 #ifdef DBG_SHOW_EACH_SENTENCE_NGRAM_FEATURE
   std::cout << "The scaled " << gram << "-gram feature: " << ng_feat << std::endl;
 #endif
@@ -227,33 +253,24 @@ double SentenceNGramsFeatureExtractor::getNGFeature(
 }
 
 double SentenceNGramsFeatureExtractor::findNGProfileMatch(
-    NGramFrequency* const ngramfreq,
-    RankedNGramVec profile,
+    const NGramKey& ngram,
     const int gram) {
-  NGram* ngram = ngramfreq->ngram;
-  double ngram_count = ngramfreq->frequency;
-  assert(ngram->length() == gram);
-  for(int i = 0; i < profile.length(); ++i) {
-    NGram* p_ngram = profile[i]->ngram;
-    double p_ngram_count = profile[i]->frequency;
-    assert(p_ngram->length() == gram);
-    if(*p_ngram == *ngram) {
+  const double p_ngram_count = mathNGramIndex->findFrequency(gram, ngram);
 #ifdef DBG_SHOW_EACH_SENTENCE_NGRAM_FEATURE
-      std::cout << "Matching profile ngram: " << *p_ngram << ", occurs " << p_ngram_count
-          << " times on profile and " << ngram_count << " times in sentence\n";
-#endif
-      return ngram_count * p_ngram_count;
-    }
+  if(p_ngram_count != 0) {
+    std::cout << "Matching profile ngram: " << mathNGramIndex->keyToString(ngram)
+        << ", occurs " << p_ngram_count << " times on profile\n";
   }
-  return (double)0;
+#endif
+  return p_ngram_count;
 }
 
 double SentenceNGramsFeatureExtractor::scaleNGramFeature(
     double ng_feat,
-    RankedNGramVec profile) {
+    const int gram) {
   double upperbound = (double)5;
   double scaled_feat = ng_feat;
-  double top_profile_freq = profile[0]->frequency;
+  double top_profile_freq = mathNGramIndex->getTopFrequency(gram);
   if(top_profile_freq > upperbound)
     scaled_feat /= (double)10;
   if(scaled_feat > upperbound)
@@ -261,12 +278,11 @@ double SentenceNGramsFeatureExtractor::scaleNGramFeature(
   return scaled_feat;
 }
 
-void SentenceNGramsFeatureExtractor::dbgDisplayNGrams(const RankedNGramVecs& ngrams) {
+void SentenceNGramsFeatureExtractor::dbgDisplayNGrams(const NGramKeyVecs& ngrams) {
   for(int i = 0; i < ngrams.length(); i++) {
     std::cout << i + 1 << "-grams:\n";
     for(int j = 0; j < ngrams[i].length(); j++) {
-      std::cout << *(ngrams[i][j]->ngram) << " : "
-          << ngrams[i][j]->frequency << std::endl;
+      std::cout << mathNGramIndex->keyToString(ngrams[i][j]) << std::endl;
     }
   }
 }
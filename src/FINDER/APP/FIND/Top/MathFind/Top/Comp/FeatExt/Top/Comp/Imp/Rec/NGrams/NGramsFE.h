@@ -12,16 +12,18 @@
 #include <NGDesc.h>
 #include <FinderInfo.h>
 #include <BlobDataGrid.h>
-#include <DoubleFeature.h>
 #include <BlobData.h>
 #include <BlobFeatExtDesc.h>
 #include <FeatExtFlagDesc.h>
 #include <NGram.h>
 #include <SentenceData.h>
 #include <NGramRanker.h>
+#include <NGramIndex.h>
 #include <StopwordHelper.h>
 #include <NGDesc.h>
 
+#include <dlib/smart_pointers_thread_safe.h>
+
 #include <vector>
 #include <string>
 
@@ -39,9 +41,11 @@ class SentenceNGramsFeatureExtractor : public BlobFeatureExtractor {
 
   void doFinderInitialization();
 
+  void doWorkerInitialization(BlobFeatureExtractor* const initialized);
+
   void doPreprocessing(BlobDataGrid* const blobDataGrid);
 
-  std::vector<DoubleFeature*> extractFeatures(BlobData* const blob);
+  void extractFeatures(BlobData* const blob, double* const columns);
 
   BlobFeatureExtractorDescription* getFeatureExtractorDescription();
 
@@ -53,20 +57,23 @@ class SentenceNGramsFeatureExtractor : public BlobFeatureExtractor {
 
  private:
 
-  void dbgDisplayNGrams(const RankedNGramVecs& ngrams);
+  // compiles the profile into the index used to look n-grams up in it
+  // and then destroys it
+  void compileNGramProfile(RankedNGramVecs& profile);
+
+  void dbgDisplayNGrams(const NGramKeyVecs& ngrams);
 
   double getNGFeature(
       TesseractSentenceData* const sentence,
       const int gram);
 
   double findNGProfileMatch(
-      NGramFrequency* const ngramfreq,
-      RankedNGramVec profile,
+      const NGramKey& ngram,
       const int gram);
 
   double scaleNGramFeature(
       double ng_feat,
-      RankedNGramVec profile);
+      const int gram);
 
   TesseractSentenceData* getBlobSentence(
       BlobData* const blobData);
@@ -74,7 +81,8 @@ class SentenceNGramsFeatureExtractor : public BlobFeatureExtractor {
   FinderInfo* finderInfo;
   NGramRanker* ngramRanker;
   StopwordFileReader* stopwordHelper;
-  RankedNGramVecs mathNGramProfile;
+  // read-only once compiled, so shared with any training workers
+  dlib::shared_ptr_thread_safe<const NGramProfileIndex> mathNGramIndex;
   std::string ngramdir;
   SentenceNGramsFeatureExtractorDescription* description;
   std::vector<FeatureExtractorFlagDescription*> enabledFlagDescriptions;
@@ -27,15 +27,21 @@
 #include <BlobDataGridFactory.h>
 #include <M_Utils.h>
 #include <SentenceData.h>
-#include <GTParser.h>
+#include <GTIndex.h>
 #include <WordData.h>
 #include <Lept_Utils.h>
 #include <BlockData.h>
+#include <TessEnginePool.h>
 
 #include <baseapi.h>
 
 #include <allheaders.h>
 
+#include <dlib/threads.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <iostream>
 #include <assert.h>
@@ -45,7 +51,8 @@
 NGramProfileGenerator::NGramProfileGenerator(
     FinderInfo* const finderInfo,
     NGramRanker* const ngramRanker,
-    const std::string& ngramdir) {
+    const std::string& ngramdir)
+: groundtruthIndex(NULL), nextJobImage(0), jobImageDone(jobMutex) {
   this->finderInfo = finderInfo;
   this->ngramRanker = ngramRanker;
   this->ngramdir = ngramdir;
@@ -145,10 +152,6 @@ RankedNGramVecs NGramProfileGenerator::readInOldNGrams(const std::string& ngramd
 RankedNGramVecs NGramProfileGenerator::generateNewNGrams() {
   std::cout << "Generating Math N-Gram Profile.\n";
 
-  // initialize the filestreams used to write ngrams to files
-  std::ofstream math_streams[3];
-  std::ofstream nonmath_streams[3];
-
   // initialize the directories in which the n-grams will
   // be stored. if files already exists delete them so they
   // will be made anew.
@@ -169,79 +172,72 @@ RankedNGramVecs NGramProfileGenerator::generateNewNGrams() {
     Utils::exec("mkdir " + nonmath_ngramdir);
   }
 
+  // initialize the filestreams used to write ngrams to files. There's a
+  // subdir for math and a subdir for non-math both contain 3 files named as
+  // follows: unigrams, bigrams, and trigrams. It will save a lot of memory
+  // to write them to files and only load in one file at a time as needed.
+  std::ofstream math_streams[3];
+  std::ofstream nonmath_streams[3];
+  for(int i = 0; i < 3; ++i) {
+    const std::string filename = NGramRanker::getNGramFileName(i + 1);
+    math_streams[i].open((math_ngramdir + filename).c_str());
+    nonmath_streams[i].open((nonmath_ngramdir + filename).c_str());
+    if(!math_streams[i].is_open() || !nonmath_streams[i].is_open()) {
+      std::cout << "ERROR: Could not open the " << filename << " files in "
+          << ngramdir << " for writing!\n";
+      assert(false);
+    }
+  }
+
   // Get the number of training images
   int img_num = finderInfo->getGroundtruthImagePaths().size();
 
-  // Iterate through half of the training images and generate the n-gram profile from their OCR results
-  int mathsentence_cnt = 0;
-  int nonmathsentence_cnt = 0;
-  for(int i = 0; i < img_num/2; ++i) {
-    tesseract::TessBaseAPI api;
-    std::string trainingImagePath = finderInfo->getGroundtruthImagePaths()[i];
-    Pix* trainingImage = Utils::leptReadImg(trainingImagePath);
-    BlobDataGrid* blobDataGrid = BlobDataGridFactory().createBlobDataGrid(trainingImage, &api, Utils::getNameFromPath(trainingImagePath));
-
+  // Generate the n-gram profile from the OCR results of half of the training
+  // images. The images are recognized and have their n-grams found in
+  // parallel (each worker on its own engine) while this thread appends each
+  // image's n-grams to the files in image order, so the files come out the
+  // same as if the images had been done one after another.
+  groundtruthIndex = new GroundTruthIndex(groundtruthFilePath);
+  jobNGrams.assign(img_num/2, ImageNGrams());
+  nextJobImage = 0;
 #ifdef DBG_NGRAM_INIT
-    bool showgrid = true;
-    if(showgrid) {
-      std::string winname = "(ngrams)BlobInfoGrid for Image " + Utils::intToString(i);
-      ScrollView* gridviewer = blobDataGrid->MakeWindow(100, 100, winname.c_str());
-      blobDataGrid->DisplayBoxes(gridviewer);
-      Utils::waitForInput();
-      delete gridviewer;
-      gridviewer = NULL;
-    }
-#endif
-    // Grab all the sentences from the grid
-    std::vector<TesseractSentenceData*> sentences = blobDataGrid->getAllRecognizedSentences();
-
-    // Based upon the bounding boxes for each sentence and the manually
-    // generated groundtruth, assign each sentence to either math or
-    // non-math. A sentence is a math sentence if it overlaps any region
-    // of the groundtruth for the given page, otherwise it is a non-math
-    // sentence.
-    for(int j = 0; j < sentences.size(); ++j) {
-      sentences[j]->setIsMath(isSentenceMath(sentences[j], i));
-    }
-    std::cout << "Done checking sentences for math.\n";
-#ifdef DBG_NGRAM_INIT_SHOW_SENTENCE_LABELS
-    dbgShowSentenceLabels(trainingImage, blobDataGrid, trainingImagePath);
+  const int numWorkers = 1; // the debugging isn't meant for more than one
+#else
+  const int numWorkers =
+      std::max(1, std::min(Utils::getNumProcessors(), img_num/2));
 #endif
+  TesseractEnginePool::getSharedPool()->reserveEngines(numWorkers);
+  dlib::thread_pool threadPool(numWorkers);
+  for(int i = 0; i < numWorkers; ++i) {
+    threadPool.add_task(*this, &NGramProfileGenerator::extractImageNGrams);
+  }
 
-    // Separate the sentences out into two separate vectors
-    // one for math and the other for non-math
-    GenericVector<TesseractSentenceData*> math_sentences;
-    GenericVector<TesseractSentenceData*> nonmath_sentences;
-    for(int j = 0; j < sentences.size(); j++) {
-      TesseractSentenceData* s = sentences[j];
-      if(s->getIsMath()) {
-        math_sentences.push_back(s);
-        ++mathsentence_cnt;
-      }
-      else {
-        nonmath_sentences.push_back(s);
-        ++nonmathsentence_cnt;
-      }
+  int mathsentence_cnt = 0;
+  int nonmathsentence_cnt = 0;
+  for(int i = 0; i < jobNGrams.size(); ++i) {
+    jobMutex.lock();
+    while(!jobNGrams[i].done) {
+      jobImageDone.wait();
     }
-    assert(math_sentences.length() + nonmath_sentences.length()
-        == sentences.size());
-
-#ifdef DBG_NGRAM_INIT
-    dbgWriteMathNonMathFiles(math_sentences, nonmath_sentences);
-#endif
-
-    // Now write the uni, bi, and tri -grams each to their own file in the
-    // n-grams directory. There's a subdir for math and a subdir for non-math
-    // both contain 3 files named as follows: unigrams, bigrams, and trigrams.
-    // It will save a lot of memory to write them to files and only load in
-    // one file at a time as needed.
-    ngramRanker->writeNGramFiles(math_sentences, math_ngramdir, math_streams);
-    ngramRanker->writeNGramFiles(nonmath_sentences, nonmath_ngramdir, nonmath_streams);
-
-    delete blobDataGrid;
-    pixDestroy(&trainingImage);
+    jobMutex.unlock();
+    ImageNGrams& ngrams = jobNGrams[i]; // no longer touched by the workers
+    for(int j = 0; j < 3; ++j) {
+      math_streams[j] << ngrams.math[j];
+      nonmath_streams[j] << ngrams.nonmath[j];
+    }
+    mathsentence_cnt += ngrams.numMathSentences;
+    nonmathsentence_cnt += ngrams.numNonMathSentences;
+    ngrams = ImageNGrams(); // done with them
     std::cout << "Finished processing image " << i << std::endl;
   }
+  threadPool.wait_for_all_tasks();
+  jobNGrams.clear();
+  delete groundtruthIndex;
+  groundtruthIndex = NULL;
+  for(int i = 0; i < 3; ++i) {
+    math_streams[i].close();
+    nonmath_streams[i].close();
+  }
 
   std::cout << "Total math sentences: " << mathsentence_cnt << std::endl;
   std::cout << "Total non-math sentences: " << nonmathsentence_cnt << std::endl;
@@ -261,6 +257,92 @@ RankedNGramVecs NGramProfileGenerator::generateNewNGrams() {
   return ranked_math;
 }
 
+void NGramProfileGenerator::extractImageNGrams() {
+  while(true) {
+    jobMutex.lock();
+    const int i = nextJobImage++;
+    jobMutex.unlock();
+    if(i >= jobNGrams.size()) {
+      return;
+    }
+    ImageNGrams ngrams;
+    findImageNGrams(i, ngrams);
+    ngrams.done = true;
+    dlib::auto_mutex lock(jobMutex);
+    jobNGrams[i] = ngrams; // each image's slot is only written once
+    jobImageDone.broadcast();
+  }
+}
+
+void NGramProfileGenerator::findImageNGrams(const int& i,
+    ImageNGrams& ngrams) {
+  tesseract::TessBaseAPI* const api = TesseractEnginePool::getSharedPool()->leaseEngine();
+  std::string trainingImagePath = finderInfo->getGroundtruthImagePaths()[i];
+  Pix* trainingImage = Utils::leptReadImg(trainingImagePath);
+  BlobDataGrid* blobDataGrid = BlobDataGridFactory().createBlobDataGrid(trainingImage, api, Utils::getNameFromPath(trainingImagePath));
+
+#ifdef DBG_NGRAM_INIT
+  bool showgrid = true;
+  if(showgrid) {
+    std::string winname = "(ngrams)BlobInfoGrid for Image " + Utils::intToString(i);
+    ScrollView* gridviewer = blobDataGrid->MakeWindow(100, 100, winname.c_str());
+    blobDataGrid->DisplayBoxes(gridviewer);
+    Utils::waitForInput();
+    delete gridviewer;
+    gridviewer = NULL;
+  }
+#endif
+  // Grab all the sentences from the grid
+  std::vector<TesseractSentenceData*> sentences = blobDataGrid->getAllRecognizedSentences();
+
+  // Based upon the bounding boxes for each sentence and the manually
+  // generated groundtruth, assign each sentence to either math or
+  // non-math. A sentence is a math sentence if it overlaps any region
+  // of the groundtruth for the given page, otherwise it is a non-math
+  // sentence.
+  for(int j = 0; j < sentences.size(); ++j) {
+    sentences[j]->setIsMath(isSentenceMath(sentences[j], i));
+  }
+#ifdef DBG_NGRAM_INIT_SHOW_SENTENCE_LABELS
+  dbgShowSentenceLabels(trainingImage, blobDataGrid, trainingImagePath);
+#endif
+
+  // Separate the sentences out into two separate vectors
+  // one for math and the other for non-math
+  GenericVector<TesseractSentenceData*> math_sentences;
+  GenericVector<TesseractSentenceData*> nonmath_sentences;
+  for(int j = 0; j < sentences.size(); j++) {
+    TesseractSentenceData* s = sentences[j];
+    if(s->getIsMath())
+      math_sentences.push_back(s);
+    else
+      nonmath_sentences.push_back(s);
+  }
+  assert(math_sentences.length() + nonmath_sentences.length()
+      == sentences.size());
+  ngrams.numMathSentences = math_sentences.length();
+  ngrams.numNonMathSentences = nonmath_sentences.length();
+
+#ifdef DBG_NGRAM_INIT
+  dbgWriteMathNonMathFiles(math_sentences, nonmath_sentences);
+#endif
+
+  // Now find the uni, bi, and tri -grams of each. The words are checked
+  // against the dictionary of the engine that already recognized the page.
+  for(int gram = 1; gram <= 3; ++gram) {
+    std::ostringstream math_lines;
+    std::ostringstream nonmath_lines;
+    ngramRanker->writeNGramLines(gram, math_sentences, api, math_lines);
+    ngramRanker->writeNGramLines(gram, nonmath_sentences, api, nonmath_lines);
+    ngrams.math[gram - 1] = math_lines.str();
+    ngrams.nonmath[gram - 1] = nonmath_lines.str();
+  }
+
+  delete blobDataGrid;
+  TesseractEnginePool::getSharedPool()->returnEngine(api);
+  pixDestroy(&trainingImage);
+}
+
 double NGramProfileGenerator::findMathNonMathRatio(const std::string& mathdir, const std::string& nonmathdir) {
   std::string math_uni_fp = mathdir + NGramRanker::getNGramFileName(1);
   std::string nonmath_uni_fp = nonmathdir + NGramRanker::getNGramFileName(1);
@@ -284,42 +366,16 @@ double NGramProfileGenerator::findMathNonMathRatio(const std::string& mathdir, c
 }
 
 bool NGramProfileGenerator::isSentenceMath(TesseractSentenceData* sentence, int imgnum) {
+  assert(groundtruthIndex != NULL);
   Boxa* lineboxes = sentence->getRowBoxes();
   bool found = false;
   for(int i = 0; i < lineboxes->n; i++) {
     Box* line = boxaGetBox(lineboxes, i, L_CLONE);
     // see if any entry of the groundtruth for the given image
     // overlaps with the current line's box
-    std::ifstream gtfile;
-    std::string gtfilename = groundtruthFilePath;
-    gtfile.open(gtfilename.c_str(), std::ifstream::in);
-    if((gtfile.rdstate() & std::ifstream::failbit) != 0) {
-      std::cout << "ERROR: Could not open Groundtruth.dat in " \
-           << groundtruthFilePath << std::endl;
-      assert(false);
-    }
-    int max = 55;
-    char* curline = new char[max];
-    GroundTruthEntry* entry = NULL;
-    while(!gtfile.eof()) {
-      gtfile.getline(curline, max);
-      if(curline == NULL)
-        continue;
-      std::string curlinestr = (std::string)curline;
-      assert(curlinestr.length() < max);
-      entry = GtParser::parseGTLine(curlinestr);
-      if(entry == NULL)
-        continue;
-      if(entry->image_index == imgnum) {
-        // see if any part of the entry is contained within the current line
-        int bb_intersects = 0; // this will be 1 if blob_bb intersects math
-        boxIntersects(line, entry->rect, &bb_intersects);
-        if(bb_intersects == 1) {
-          // the sentence to which this line belongs is a math one!
-          found = true;
-          break;
-        }
-      }
+    if(groundtruthIndex->findIntersectingEntry(imgnum, line) != NULL) {
+      // the sentence to which this line belongs is a math one!
+      found = true;
     }
     boxDestroy(&line);
     if(found == true)
@@ -336,11 +392,7 @@ void NGramProfileGenerator::colorSentenceBlobs(Pix* const im, const int sentence
   BlobData* b = NULL;
   BlobDataGridSearch bdgs(grid);
   bdgs.SetUniqueMode(true);
-  BLOCK_RES* blockRes = block->getBlockRes();
-  if(blockRes == NULL) {
-    return;
-  }
-  TBOX blockBox = blockRes->block->bounding_box();
+  TBOX blockBox = block->getBoundingBox();
   blockBox.print();
   bdgs.StartRectSearch(blockBox);
   while((b = bdgs.NextRectSearch()) != NULL) {
@@ -350,14 +402,7 @@ void NGramProfileGenerator::colorSentenceBlobs(Pix* const im, const int sentence
     }
     TesseractBlockData* parentWordBlock = word->getParentBlock();
     if(parentWordBlock != NULL) {
-      BLOCK_RES* parentWordBlockRes = parentWordBlock->getBlockRes();
-      if(parentWordBlockRes == NULL) {
-        continue;
-      }
-      if(parentWordBlockRes->block == NULL) {
-        continue;
-      }
-      if(!(parentWordBlockRes->block->bounding_box() == blockBox)) {
+      if(!(parentWordBlock->getBoundingBox() == blockBox)) {
         continue;
       }
       //std::cout << "4\n";
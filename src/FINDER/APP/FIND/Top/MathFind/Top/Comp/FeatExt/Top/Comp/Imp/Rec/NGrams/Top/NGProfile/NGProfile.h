@@ -34,11 +34,15 @@
 #include <SentenceData.h>
 #include <BlobDataGrid.h>
 #include <BlockData.h>
+#include <GTIndex.h>
 
 #include <baseapi.h>
 
+#include <dlib/threads.h>
+
 #include <string>
 #include <iostream>
+#include <vector>
 
 class NGramProfileGenerator {
  public:
@@ -70,10 +74,38 @@ class NGramProfileGenerator {
   NGramRanker* ngramRanker;
   std::string ngramdir;
   std::string groundtruthFilePath;
+  GroundTruthIndex* groundtruthIndex; // only exists while generating new n-grams
 
   // create the n-gram profile from scratch using the training data
   RankedNGramVecs generateNewNGrams();
 
+  // The n-gram file lines found in one training image's math and non-math
+  // sentences (uni, bi, then tri grams), held until it's the image's turn
+  // to be appended to the n-gram files
+  struct ImageNGrams {
+    ImageNGrams() : numMathSentences(0), numNonMathSentences(0),
+        done(false) {}
+    std::string math[3];
+    std::string nonmath[3];
+    int numMathSentences;
+    int numNonMathSentences;
+    bool done;
+  };
+
+  // run by each worker thread, keeps taking the next training image until
+  // they've all been taken
+  void extractImageNGrams();
+
+  // recognizes the training image, labels its sentences as math or non-math,
+  // and finds the n-grams in each
+  void findImageNGrams(const int& imageIndex, ImageNGrams& ngrams);
+
+  // state shared with the worker threads while generating new n-grams
+  std::vector<ImageNGrams> jobNGrams; // one per image
+  int nextJobImage;
+  dlib::mutex jobMutex;
+  dlib::signaler jobImageDone;
+
   // returns true if any region of the groundtruth overlaps
   // any linebox of the sentence
   bool isSentenceMath(TesseractSentenceData* sentence, int imgnum);
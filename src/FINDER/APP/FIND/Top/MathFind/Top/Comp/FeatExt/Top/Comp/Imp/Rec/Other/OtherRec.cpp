@@ -88,6 +88,14 @@ void OtherRecognitionFeatureExtractor::doFinderInitialization() {
   doTrainerInitialization(); // same
 }
 
+void OtherRecognitionFeatureExtractor::doWorkerInitialization(
+    BlobFeatureExtractor* const initialized) {
+  OtherRecognitionFeatureExtractor* const other =
+      dynamic_cast<OtherRecognitionFeatureExtractor*>(initialized);
+  assert(other != NULL);
+  mathwords = other->mathwords;
+}
+
 
 void OtherRecognitionFeatureExtractor
 ::doPreprocessing(BlobDataGrid* const blobDataGrid) {
@@ -194,7 +202,7 @@ rows[i]->avg_baselinedist = avg_baseline_dist_;
     while((b = bigs.NextFullSearch()) != NULL) {
       if(b->getParentWord() == NULL)
         continue;
-      if(b->getParentRow()->getBoundingBox() == row->row()->bounding_box()) {
+      if(b->getParentRow()->getBoundingBox() == row->getBoundingBox()) {
         if(b->left() < left)
           left = b->left();
         if(b->right() > right)
@@ -206,7 +214,7 @@ rows[i]->avg_baselinedist = avg_baseline_dist_;
       continue;
     }
     for(int j = left; j < right; ++j) {
-      inT32 y = blobDataGrid->getBinaryImage()->h - (inT32)row->row()->base_line((float)j);
+      inT32 y = blobDataGrid->getBinaryImage()->h - (inT32)row->getBaseline(j);
       Lept_Utils::drawAtXY(dbgim, j, y, LayoutEval::GREEN);
     }
   }
@@ -267,12 +275,7 @@ rows[i]->avg_baselinedist = avg_baseline_dist_;
   bdgs.StartFullSearch();
   blob = NULL;
   while((blob = bdgs.NextFullSearch()) != NULL) {
-    bool isItalic = false;
-    tesseract::FontInfo* const fontInfo = blob->getFontInfo();
-    if(fontInfo != NULL) {
-      isItalic = fontInfo->is_italic();
-    }
-    if(!isItalic) {
+    if(!blob->isItalic()) {
       ++non_ital_blobs;
     }
     ++total_blobs;
@@ -284,11 +287,8 @@ rows[i]->avg_baselinedist = avg_baseline_dist_;
   PIX* boldital_img = pixCopy(NULL, blobDataGrid->getBinaryImage());
   boldital_img = pixConvertTo32(boldital_img);
   while((blob = bdgs.NextFullSearch()) != NULL) {
-    tesseract::FontInfo* const fontInfo = blob->getFontInfo();
-    if(fontInfo != NULL) {
-      if(fontInfo->is_italic()) {
-        M_Utils::drawHlBlobDataRegion(blob, boldital_img, LayoutEval::RED);
-      }
+    if(blob->isItalic()) {
+      M_Utils::drawHlBlobDataRegion(blob, boldital_img, LayoutEval::RED);
     }
   }
   pixWriteToDumpDir(std::string("italics") +
@@ -383,9 +383,8 @@ rows[i]->avg_baselinedist = avg_baseline_dist_;
 
 
 
-std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(BlobData* const blob) {
-
-  std::vector<DoubleFeature*> fv;
+void OtherRecognitionFeatureExtractor::extractFeatures(BlobData* const blob,
+    double* const columns) {
 
   /******** Height flag ********/
   if(heightFlagEnabled) {
@@ -396,7 +395,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
       h = (double)blob->getBoundingBox().height();
     }
     h = M_Utils::expNormalize(h);
-    fv.push_back(new DoubleFeature(description, h, description->getHeightFlag()));
+    columns[getFlagColumn(description->getHeightFlag())] = h;
   }
 
   /******** Width/height ratio flag ********/
@@ -406,7 +405,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
       whr = whr / avg_whr;
     }
     whr = M_Utils::expNormalize(whr);
-    fv.push_back(new DoubleFeature(description, whr, description->getWidthHeightFlag()));
+    columns[getFlagColumn(description->getWidthHeightFlag())] = whr;
   }
 
   /******** Vertical distance above row baseline flag ********/
@@ -425,7 +424,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
         double baseline_dist = findBaselineDist(blob->getParentChar());
         blob->getParentChar()->setDistanceAboveRowBaseline(baseline_dist);
         vdarb = baseline_dist - avg_baseline_dist_;
-        rowheight = rowData->row()->bounding_box().height();
+        rowheight = rowData->getBoundingBox().height();
         if(vdarb < 0) {
           vdarb = (double)0;
         } else {
@@ -435,7 +434,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
         }
       }
     }
-    fv.push_back(new DoubleFeature(description, vdarb, description->getVdarbFlag()));
+    columns[getFlagColumn(description->getVdarbFlag())] = vdarb;
   }
 
   /******** Is OCR math word flag ********/
@@ -446,7 +445,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
         imw = (double)1;
       }
     }
-    fv.push_back(new DoubleFeature(description, imw, description->getIsOcrMathFlag()));
+    columns[getFlagColumn(description->getIsOcrMathFlag())] = imw;
   }
 
   /******** Is italic flag ********/
@@ -454,14 +453,11 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
     double is_italic = (double)0;
     assert(blobDataGrid->getNonItalicizedRatio() >= 0);
     if(blob->getParentWord() != NULL) {
-      const FontInfo* fontInfo = blob->getParentWord()->getWordRes()->fontinfo;
-      if(fontInfo != NULL) {
-        if(fontInfo->is_italic()) {
-          is_italic = (double)1 * blobDataGrid->getNonItalicizedRatio();
-        }
+      if(blob->getParentWord()->getIsItalic()) {
+        is_italic = (double)1 * blobDataGrid->getNonItalicizedRatio();
       }
     }
-    fv.push_back(new DoubleFeature(description, is_italic, description->getIsItalicFlag()));
+    columns[getFlagColumn(description->getIsItalicFlag())] = is_italic;
   }
 
   /******** Confidence flag ********/
@@ -472,7 +468,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
     }
     ocr_conf /= avg_confidence;
     ocr_conf = M_Utils::expNormalize(ocr_conf);
-    fv.push_back(new DoubleFeature(description, ocr_conf, description->getConfidenceFlag()));
+    columns[getFlagColumn(description->getConfidenceFlag())] = ocr_conf;
   }
 
   /******** Belongs to Valid OCR Row Flag ********/
@@ -484,7 +480,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
         in_valid_row = (double)1;
       }
     }
-    fv.push_back(new DoubleFeature(description, in_valid_row, description->getIsOnValidOcrRowFlag()));
+    columns[getFlagColumn(description->getIsOnValidOcrRowFlag())] = in_valid_row;
   }
 
   /******** Belongs to Valid OCR Word Flag ********/
@@ -496,7 +492,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
         in_valid_word = (double)1;
       }
     }
-    fv.push_back(new DoubleFeature(description, in_valid_word, description->getIsOcrValidFlag()));
+    columns[getFlagColumn(description->getIsOcrValidFlag())] = in_valid_word;
   }
 
   /******** Bad OCR Page Flag ********/
@@ -505,7 +501,7 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
     if(bad_page) {
       bad_page_ = (double)1;
     }
-    fv.push_back(new DoubleFeature(description, bad_page_, description->getIsOnBadPageFlag()));
+    columns[getFlagColumn(description->getIsOnBadPageFlag())] = bad_page_;
   }
 
   /******** Belongs to Stopword Flag ********/
@@ -517,16 +513,14 @@ std::vector<DoubleFeature*> OtherRecognitionFeatureExtractor::extractFeatures(Bl
         stop_word = (double)1;
       }
     }
-    fv.push_back(new DoubleFeature(description, stop_word, description->getIsInOcrStopwordFlag()));
+    columns[getFlagColumn(description->getIsInOcrStopwordFlag())] = stop_word;
   }
-
-  return fv;
 }
 
 double OtherRecognitionFeatureExtractor::findBaselineDist(TesseractCharData* tessChar) {
   // calculate the current recognized char's distance from the baseline
   TesseractRowData* const row = tessChar->getParentWord()->getParentRow();
-  double char_baseline = (double)row->row()->base_line(M_Utils::centerx(*(tessChar->getBoundingBox())));
+  double char_baseline = (double)row->getBaseline(M_Utils::centerx(*(tessChar->getBoundingBox())));
   double char_bottom = (double)tessChar->getBoundingBox()->bottom();
   double baseline_dist = char_bottom - char_baseline;
   if(baseline_dist < 0) {
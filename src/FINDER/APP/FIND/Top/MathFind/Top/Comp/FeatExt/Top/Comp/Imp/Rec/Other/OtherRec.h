@@ -11,7 +11,6 @@
 #include <BlobFeatExt.h>
 #include <OtherRecDesc.h>
 #include <BlobDataGrid.h>
-#include <DoubleFeature.h>
 #include <BlobData.h>
 #include <BlobFeatExtDesc.h>
 #include <CharData.h>
@@ -35,9 +34,11 @@ class OtherRecognitionFeatureExtractor : public virtual BlobFeatureExtractor {
 
   void doFinderInitialization();
 
+  void doWorkerInitialization(BlobFeatureExtractor* const initialized);
+
   void doPreprocessing(BlobDataGrid* const blobDataGrid);
 
-  std::vector<DoubleFeature*> extractFeatures(BlobData* const blob);
+  void extractFeatures(BlobData* const blob, double* const columns);
 
   BlobFeatureExtractorDescription* getFeatureExtractorDescription();
 
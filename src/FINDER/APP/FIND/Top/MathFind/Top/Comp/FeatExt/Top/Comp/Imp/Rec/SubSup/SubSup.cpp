@@ -92,7 +92,8 @@ void SubOrSuperscriptsFeatureExtractor::doPreprocessing(BlobDataGrid* const blob
  #endif
 }
 
-std::vector<DoubleFeature*> SubOrSuperscriptsFeatureExtractor::extractFeatures(BlobData* const blobData) {
+void SubOrSuperscriptsFeatureExtractor::extractFeatures(BlobData* const blobData,
+    double* const columns) {
   double has_sup = (double)0, has_sub = (double)0,
       is_sup = (double)0, is_sub = (double)0;
 
@@ -119,38 +120,20 @@ std::vector<DoubleFeature*> SubOrSuperscriptsFeatureExtractor::extractFeatures(B
 #endif
 
   if(hasSubFeatureEnabled) {
-    blobSubOrSuperscriptData->appendExtractedFeature(
-        new DoubleFeature(
-            description,
-            has_sub,
-            description->getHasSubscriptDescription()));
+    columns[getFlagColumn(description->getHasSubscriptDescription())] = has_sub;
   }
 
   if(isSubFeatureEnabled) {
-    blobSubOrSuperscriptData->appendExtractedFeature(
-        new DoubleFeature(
-            description,
-            is_sub,
-            description->getIsSubscriptDescription()));
+    columns[getFlagColumn(description->getIsSubscriptDescription())] = is_sub;
   }
 
   if(hasSupFeatureEnabled) {
-    blobSubOrSuperscriptData->appendExtractedFeature(
-        new DoubleFeature(
-            description,
-            has_sup,
-            description->getHasSuperscriptDescription()));
+    columns[getFlagColumn(description->getHasSuperscriptDescription())] = has_sup;
   }
 
   if(isSupFeatureEnabled) {
-    blobSubOrSuperscriptData->appendExtractedFeature(
-        new DoubleFeature(
-            description,
-            is_sup,
-            description->getIsSuperscriptDescription()));
+    columns[getFlagColumn(description->getIsSuperscriptDescription())] = is_sup;
   }
-
-  return blobSubOrSuperscriptData->getExtractedFeatures();
 }
 
 // Determines whether or not the blob in question has a super/subscript
@@ -11,7 +11,6 @@
 #include <BlobFeatExt.h>
 #include <SubSupDesc.h>
 #include <BlobDataGrid.h>
-#include <DoubleFeature.h>
 #include <BlobFeatExtDesc.h>
 #include <FeatExtFlagDesc.h>
 #include <BlobData.h>
@@ -32,7 +31,7 @@ public:
 
   void doPreprocessing(BlobDataGrid* const blobDataGrid);
 
-  std::vector<DoubleFeature*> extractFeatures(BlobData* const blob);
+  void extractFeatures(BlobData* const blob, double* const columns);
 
   BlobFeatureExtractorDescription* getFeatureExtractorDescription();
 
@@ -54,7 +54,8 @@ MathExpressionFeatureExtractor* MathExpressionFeatureExtractorFactory
     featureExtractors.push_back(featureFactories[i]->create(finderInfo));
   }
 
-  return new MathExpressionFeatureExtractor(finderInfo, featureExtractors);
+  return new MathExpressionFeatureExtractor(finderInfo, featureExtractors,
+      featureFactories);
 }
 
 
@@ -0,0 +1,97 @@
+/*
+ * TessEnginePool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <TessEnginePool.h>
+
+#include <baseapi.h>
+
+#include <dlib/threads.h>
+
+#include <iostream>
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+
+TesseractEnginePool::TesseractEnginePool(const int& maxEngines)
+: numPending(0), engineReturned(poolMutex) {
+  assert(maxEngines > 0);
+  this->maxEngines = maxEngines;
+}
+
+TesseractEnginePool::~TesseractEnginePool() {
+  assert(idleEngines.size() == allEngines.size()); // all should be returned
+  for(int i = 0; i < allEngines.size(); ++i) {
+    allEngines[i]->End();
+    delete allEngines[i];
+  }
+  allEngines.clear();
+  idleEngines.clear();
+}
+
+TesseractEnginePool* TesseractEnginePool::getSharedPool() {
+  static TesseractEnginePool sharedPool;
+  return &sharedPool;
+}
+
+tesseract::TessBaseAPI* TesseractEnginePool::leaseEngine() {
+  poolMutex.lock();
+  while(idleEngines.empty()) {
+    if(allEngines.size() + numPending < maxEngines) {
+      // Room for another engine, initialize it outside of the lock
+      ++numPending;
+      poolMutex.unlock();
+      tesseract::TessBaseAPI* const engine = createEngine();
+      poolMutex.lock();
+      --numPending;
+      allEngines.push_back(engine);
+      poolMutex.unlock();
+      return engine;
+    }
+    engineReturned.wait();
+  }
+  tesseract::TessBaseAPI* const engine = idleEngines.back();
+  idleEngines.pop_back();
+  poolMutex.unlock();
+  return engine;
+}
+
+void TesseractEnginePool::returnEngine(tesseract::TessBaseAPI* const engine) {
+  assert(engine != NULL);
+
+  // Free up the last page's results and image without throwing away the
+  // language data, then forget anything learned by the adaptive classifier
+  // on that page so results don't depend on which page the engine saw last
+  engine->Clear();
+  engine->ClearAdaptiveClassifier();
+
+  dlib::auto_mutex lock(poolMutex);
+  idleEngines.push_back(engine);
+  engineReturned.signal();
+}
+
+void TesseractEnginePool::reserveEngines(const int& maxEngines) {
+  dlib::auto_mutex lock(poolMutex);
+  if(maxEngines > this->maxEngines) {
+    this->maxEngines = maxEngines;
+  }
+}
+
+int TesseractEnginePool::getMaxEngines() {
+  dlib::auto_mutex lock(poolMutex);
+  return maxEngines;
+}
+
+tesseract::TessBaseAPI* TesseractEnginePool::createEngine() {
+  dlib::auto_mutex lock(initMutex);
+  tesseract::TessBaseAPI* const engine = new tesseract::TessBaseAPI;
+  if(engine->Init("/usr/local/share/", "eng") != 0) {
+    std::cout << "ERROR: Could not initialize Tesseract with the tessdata in "
+        << "/usr/local/share/\n";
+    assert(false);
+  }
+  return engine;
+}
@@ -0,0 +1,89 @@
+/*
+ * TessEnginePool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef TESSENGINEPOOL_H_
+#define TESSENGINEPOOL_H_
+
+#include <baseapi.h>
+
+#include <dlib/threads.h>
+
+#include <vector>
+
+/**
+ * Holds a set of Tesseract engines that have already been through Init()
+ * so that the tessdata, dictionaries and DAWGs are only loaded once per
+ * process rather than once per page. Pages lease an engine, run their
+ * recognition and grid building on it, and hand it back once the grid that
+ * relies on it has been deleted. Engines are only initialized when first
+ * needed, so a pool that is never leased from more than once at a time will
+ * only ever pay for a single Init().
+ */
+class TesseractEnginePool {
+ public:
+
+  /**
+   * Creates a pool that will initialize no more than maxEngines engines.
+   */
+  TesseractEnginePool(const int& maxEngines=1);
+
+  /**
+   * Ends and deletes every engine. All leased engines should have been
+   * returned by now.
+   */
+  ~TesseractEnginePool();
+
+  /**
+   * Gets the pool shared by everything in this process (finder, trainer and
+   * n-gram profile generation). The pool is owned by this class.
+   */
+  static TesseractEnginePool* getSharedPool();
+
+  /**
+   * Leases an initialized engine from the pool. If all of the engines are
+   * in use and the pool is already at its maximum size then this blocks
+   * until one is returned. The engine is still owned by the pool and must
+   * be handed back through returnEngine() when finished with.
+   */
+  tesseract::TessBaseAPI* leaseEngine();
+
+  /**
+   * Hands the engine back to the pool. Its recognition results, image and
+   * adaptive classifier state are cleared so that the next page leasing it
+   * starts from the same state as a freshly initialized engine. Anything
+   * relying on the engine's results (i.e., a BlobDataGrid) must already
+   * have been deleted.
+   */
+  void returnEngine(tesseract::TessBaseAPI* const engine);
+
+  /**
+   * Raises the maximum number of engines the pool may initialize (never
+   * lowers it, engines already created are kept).
+   */
+  void reserveEngines(const int& maxEngines);
+
+  int getMaxEngines();
+
+ private:
+
+  // Creates and initializes a new engine (called with the pool's mutex
+  // unlocked since Init() takes a while, but engines are initialized one at
+  // a time since Init() sets Tesseract's global parameters)
+  tesseract::TessBaseAPI* createEngine();
+
+  std::vector<tesseract::TessBaseAPI*> allEngines; // all created so far
+  std::vector<tesseract::TessBaseAPI*> idleEngines; // ones not leased out
+  int maxEngines;
+  int numPending; // engines currently being initialized
+
+  dlib::mutex poolMutex;
+  dlib::signaler engineReturned;
+  dlib::mutex initMutex;
+};
+
+
+#endif /* TESSENGINEPOOL_H_ */
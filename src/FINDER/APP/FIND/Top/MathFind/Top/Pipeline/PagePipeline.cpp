@@ -0,0 +1,138 @@
+/*
+ * PagePipeline.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <PagePipeline.h>
+
+#include <MathExpressionFinder.h>
+#include <MFinderResults.h>
+#include <TessEnginePool.h>
+#include <Utils.h>
+
+#include <allheaders.h>
+
+#include <dlib/threads.h>
+#include <dlib/pipe.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+
+MathExpressionFinderPipeline::MathExpressionFinderPipeline(
+    MathExpressionFinder* const finder,
+    const int& maxPagesInFlight)
+: runMode(FIND), readQueue(NULL), finishedQueue(NULL), pagesInFlight(0),
+  pageWritten(inFlightMutex) {
+  assert(finder != NULL && maxPagesInFlight > 0);
+  this->finder = finder;
+  this->maxPagesInFlight = maxPagesInFlight;
+}
+
+void MathExpressionFinderPipeline::run(RunMode runMode,
+    const std::vector<std::string>& imagePaths,
+    const std::vector<std::string>& imageNames,
+    const std::string& resultsDirPath,
+    const bool& displayResults) {
+  assert(imagePaths.size() == imageNames.size());
+  this->runMode = runMode;
+  this->imagePaths = imagePaths;
+  this->imageNames = imageNames;
+  pagesInFlight = 0;
+
+  finder->initialize();
+  const int numWorkers = finder->getNumWorkers();
+  TesseractEnginePool::getSharedPool()->reserveEngines(numWorkers);
+
+  // The queues never hold more than the pages in flight
+  dlib::pipe<PageJob> readPages_(maxPagesInFlight);
+  dlib::pipe<PageJob> finishedPages_(maxPagesInFlight);
+  readQueue = &readPages_;
+  finishedQueue = &finishedPages_;
+
+  // One thread for reading plus one for each worker, results are written
+  // on this one
+  dlib::thread_pool threadPool(numWorkers + 1);
+  threadPool.add_task(*this, &MathExpressionFinderPipeline::readPages);
+  for(long i = 0; i < numWorkers; ++i) {
+    threadPool.add_task(*this, &MathExpressionFinderPipeline::findInPages, i);
+  }
+  writePages(resultsDirPath, displayResults);
+  threadPool.wait_for_all_tasks();
+
+  readQueue = NULL;
+  finishedQueue = NULL;
+}
+
+void MathExpressionFinderPipeline::readPages() {
+  for(int i = 0; i < imagePaths.size(); ++i) {
+    // wait for room before reading the next page in
+    inFlightMutex.lock();
+    while(pagesInFlight >= maxPagesInFlight) {
+      pageWritten.wait();
+    }
+    ++pagesInFlight;
+    inFlightMutex.unlock();
+
+    std::cout << "image path " << imagePaths[i] << std::endl;
+    PageJob job;
+    job.index = i;
+    job.image = Utils::leptReadAndBinarizeImg(imagePaths[i]);
+    readQueue->enqueue(job);
+  }
+
+  // let each worker know there's nothing left
+  for(int i = 0; i < finder->getNumWorkers(); ++i) {
+    PageJob done;
+    readQueue->enqueue(done);
+  }
+}
+
+void MathExpressionFinderPipeline::findInPages(long workerIndex) {
+  MathExpressionFinder* const worker = finder->getWorker(workerIndex);
+  PageJob job;
+  while(readQueue->dequeue(job) && job.index >= 0) {
+    job.results = worker->getPageResults(runMode, job.image,
+        imageNames[job.index]);
+    pixDestroy(&job.image);
+    finishedQueue->enqueue(job);
+  }
+}
+
+void MathExpressionFinderPipeline::writePages(
+    const std::string& resultsDirPath_,
+    const bool& displayResults) {
+  std::ofstream rectstream;
+  const std::string resultsDirPath =
+      MathExpressionFinderResults::createResultsFiles(resultsDirPath_, rectstream);
+  // Pages can finish out of order, so each one is held until the pages before
+  // it have been written. Held pages still count as in flight, and the page
+  // being waited on was read in before them so it's already with a worker.
+  std::map<int, PageJob> finishedPages;
+  for(int i = 0; i < imagePaths.size(); ++i) {
+    while(finishedPages.find(i) == finishedPages.end()) {
+      PageJob finished;
+      finishedQueue->dequeue(finished);
+      finishedPages[finished.index] = finished;
+    }
+    PageJob job = finishedPages[i];
+    finishedPages.erase(i);
+    if(displayResults) {
+      job.results->displaySegmentationResults();
+    }
+    job.results->printToFiles(rectstream, resultsDirPath);
+    delete job.results;
+
+    // make room for the next page to be read in
+    dlib::auto_mutex lock(inFlightMutex);
+    --pagesInFlight;
+    pageWritten.signal();
+  }
+  rectstream.close();
+}
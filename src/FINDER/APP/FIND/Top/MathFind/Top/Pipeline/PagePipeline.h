@@ -0,0 +1,98 @@
+/*
+ * PagePipeline.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef PAGEPIPELINE_H_
+#define PAGEPIPELINE_H_
+
+#include <MathExpressionFinder.h>
+#include <MFinderResults.h>
+
+#include <allheaders.h>
+
+#include <dlib/threads.h>
+#include <dlib/pipe.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Runs a finder over a list of image files as a three stage pipeline rather
+ * than reading every image into memory up front and holding every result until
+ * the end. One thread reads and binarizes the images, each of the finder's
+ * workers recognizes, detects and (if in FIND mode) segments the pages handed
+ * to it, and the calling thread writes each page's results to the results
+ * directory once that page and all of the ones before it are done, so the
+ * results come out in the same order as the images however many workers
+ * there are. No more than maxPagesInFlight pages are held in memory at once
+ * (counting from when a page is read in until its results have been written
+ * and destroyed, including pages that are done but waiting on an earlier one).
+ */
+class MathExpressionFinderPipeline {
+ public:
+
+  /**
+   * The finder (and its workers) are not owned by the pipeline.
+   */
+  MathExpressionFinderPipeline(
+      MathExpressionFinder* const finder,
+      const int& maxPagesInFlight);
+
+  /**
+   * Runs the finder on each of the images at the given paths, printing
+   * their results to a fresh results directory at resultsDirPath. The image
+   * names correspond with the paths and are used for naming the results.
+   * If displayResults is set then each page's results are displayed before
+   * being written.
+   */
+  void run(RunMode runMode,
+      const std::vector<std::string>& imagePaths,
+      const std::vector<std::string>& imageNames,
+      const std::string& resultsDirPath,
+      const bool& displayResults);
+
+ private:
+
+  // A page making its way through the pipeline. Ones with a negative index
+  // let the stage receiving them know there are no more pages coming.
+  struct PageJob {
+    PageJob() : index(-1), image(NULL), results(NULL) {}
+    int index;
+    Pix* image;
+    MathExpressionFinderResults* results;
+  };
+
+  // Stage 1: reads and binarizes each image
+  void readPages();
+
+  // Stage 2: runs the given worker on each page read in
+  void findInPages(long workerIndex);
+
+  // Stage 3: prints each finished page's results, in page order, then
+  // destroys them
+  void writePages(const std::string& resultsDirPath,
+      const bool& displayResults);
+
+  MathExpressionFinder* finder;
+  int maxPagesInFlight;
+
+  // the current run
+  RunMode runMode;
+  std::vector<std::string> imagePaths;
+  std::vector<std::string> imageNames;
+  dlib::pipe<PageJob>* readQueue;
+  dlib::pipe<PageJob>* finishedQueue;
+
+  // pages read in but not yet written
+  int pagesInFlight;
+  dlib::mutex inFlightMutex;
+  dlib::signaler pageWritten;
+};
+
+
+#endif /* PAGEPIPELINE_H_ */
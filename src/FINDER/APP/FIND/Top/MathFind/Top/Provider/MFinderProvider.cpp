@@ -24,6 +24,21 @@
 
 MathExpressionFinder* MathExpressionFinderProvider
 ::createMathExpressionFinder(GeometryBasedExtractorCategory* const spatialCategory,
+    RecognitionBasedExtractorCategory* const recognitionCategory,
+    FinderInfo* const finderInfo,
+    const int& numWorkers) {
+  assert(numWorkers > 0);
+  MathExpressionFinder* const finder =
+      createSingleMathExpressionFinder(spatialCategory, recognitionCategory, finderInfo);
+  for(int i = 1; i < numWorkers; ++i) {
+    finder->addWorker(
+        createSingleMathExpressionFinder(spatialCategory, recognitionCategory, finderInfo));
+  }
+  return finder;
+}
+
+MathExpressionFinder* MathExpressionFinderProvider
+::createSingleMathExpressionFinder(GeometryBasedExtractorCategory* const spatialCategory,
     RecognitionBasedExtractorCategory* const recognitionCategory,
     FinderInfo* const finderInfo) {
 
@@ -29,14 +29,22 @@ class MathExpressionFinderProvider {
   /**
    * Creates the math expression finder. The created finder is owned
    * by the calling code. Parsed arguments from the command line are
-   * passed in to dictate how the expression finder is created.
+   * passed in to dictate how the expression finder is created. If more
+   * than one worker is requested then the finder is given its own copies
+   * of the feature extractor, detector, and segmentor for each additional
+   * worker so that that many pages can be processed at once.
    */
   MathExpressionFinder* createMathExpressionFinder(GeometryBasedExtractorCategory* const spatialCategory,
       RecognitionBasedExtractorCategory* const recognitionCategory,
-      FinderInfo* const finderInfo);
+      FinderInfo* const finderInfo,
+      const int& numWorkers=1);
 
  private:
 
+  MathExpressionFinder* createSingleMathExpressionFinder(GeometryBasedExtractorCategory* const spatialCategory,
+      RecognitionBasedExtractorCategory* const recognitionCategory,
+      FinderInfo* const finderInfo);
+
   std::string stripFeatureFlags(const std::string& uniqueFeatureName);
   std::vector<std::string> getFeatureFlags(const std::string& uniqueFeatureName);
 
@@ -0,0 +1,144 @@
+/*
+ * GTIndex.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <GTIndex.h>
+
+#include <GTParser.h>
+#include <Sample.h>
+
+#include <allheaders.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+
+GroundTruthIndex::GroundTruthIndex(const std::string& groundtruthFilePath) {
+  std::ifstream gtfile(groundtruthFilePath.c_str());
+  if(!gtfile.is_open()) {
+    std::cout << "ERROR: Could not open the groundtruth file at "
+        << groundtruthFilePath << std::endl;
+    assert(false);
+  }
+  std::string line;
+  while(std::getline(gtfile, line)) {
+    GroundTruthEntry* const entry = GtParser::parseGTLine(line);
+    if(entry == NULL)
+      continue;
+    if(entry->image_index < 0) {
+      std::cout << "ERROR: Invalid image index in groundtruth entry: "
+          << line << std::endl;
+      assert(false);
+    }
+    if(entry->image_index >= images.size()) {
+      images.resize(entry->image_index + 1);
+    }
+    ImageEntries& image = images[entry->image_index];
+    IndexedRect rect = getRect(entry->rect);
+    rect.entryIndex = image.entries.size();
+    image.entries.push_back(entry);
+    image.rects.push_back(rect);
+  }
+  gtfile.close();
+
+  for(int i = 0; i < images.size(); ++i) {
+    ImageEntries& image = images[i];
+    std::stable_sort(image.rects.begin(), image.rects.end(), &isTopLess);
+    image.maxBottoms.assign(image.rects.size(), 0);
+    buildSubtree(image, 0, image.rects.size());
+  }
+}
+
+GroundTruthIndex::~GroundTruthIndex() {
+  for(int i = 0; i < images.size(); ++i) {
+    for(int j = 0; j < images[i].entries.size(); ++j) {
+      delete images[i].entries[j];
+    }
+  }
+  images.clear();
+}
+
+const GroundTruthEntry* GroundTruthIndex::findIntersectingEntry(
+    const int& imageIndex, Box* const box) const {
+  assert(box != NULL);
+  if(imageIndex < 0 || imageIndex >= images.size()) {
+    return NULL;
+  }
+  const ImageEntries& image = images[imageIndex];
+  int firstEntry = -1;
+  searchSubtree(image, 0, image.rects.size(), getRect(box), firstEntry);
+  return (firstEntry < 0) ? NULL : image.entries[firstEntry];
+}
+
+GroundTruthEntry* GroundTruthIndex::copyIntersectingEntry(
+    const int& imageIndex, Box* const box) const {
+  const GroundTruthEntry* const found = findIntersectingEntry(imageIndex, box);
+  if(found == NULL) {
+    return NULL;
+  }
+  GroundTruthEntry* const entry = new GroundTruthEntry;
+  entry->image_index = found->image_index;
+  entry->entry = found->entry;
+  entry->rect = boxCopy(found->rect);
+  return entry;
+}
+
+int GroundTruthIndex::buildSubtree(ImageEntries& image, const int& begin,
+    const int& end) {
+  if(begin >= end) {
+    return INT_MIN;
+  }
+  const int mid = begin + (end - begin) / 2;
+  int maxBottom = image.rects[mid].bottom;
+  maxBottom = std::max(maxBottom, buildSubtree(image, begin, mid));
+  maxBottom = std::max(maxBottom, buildSubtree(image, mid + 1, end));
+  image.maxBottoms[mid] = maxBottom;
+  return maxBottom;
+}
+
+void GroundTruthIndex::searchSubtree(const ImageEntries& image,
+    const int& begin, const int& end, const IndexedRect& query,
+    int& firstEntry) {
+  if(begin >= end) {
+    return;
+  }
+  const int mid = begin + (end - begin) / 2;
+  if(image.maxBottoms[mid] < query.top) {
+    return; // everything under here is above the query
+  }
+  searchSubtree(image, begin, mid, query, firstEntry);
+  const IndexedRect& rect = image.rects[mid];
+  if(rect.top > query.bottom) {
+    return; // this and everything after it is below the query
+  }
+  if(!(rect.bottom < query.top || rect.right < query.left
+      || query.right < rect.left)
+      && (firstEntry < 0 || rect.entryIndex < firstEntry)) {
+    firstEntry = rect.entryIndex;
+  }
+  searchSubtree(image, mid + 1, end, query, firstEntry);
+}
+
+// the same edges boxIntersects uses
+GroundTruthIndex::IndexedRect GroundTruthIndex::getRect(Box* const box) {
+  IndexedRect rect;
+  int width = 0, height = 0;
+  boxGetGeometry(box, &rect.left, &rect.top, &width, &height);
+  rect.right = rect.left + width - 1;
+  rect.bottom = rect.top + height - 1;
+  rect.entryIndex = -1;
+  return rect;
+}
+
+bool GroundTruthIndex::isTopLess(const IndexedRect& rect1,
+    const IndexedRect& rect2) {
+  return rect1.top < rect2.top;
+}
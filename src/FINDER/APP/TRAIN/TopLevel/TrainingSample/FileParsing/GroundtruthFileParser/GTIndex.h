@@ -0,0 +1,89 @@
+/*
+ * GTIndex.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef GTINDEX_H_
+#define GTINDEX_H_
+
+#include <Sample.h>
+
+#include <allheaders.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * The whole groundtruth file parsed once and indexed by image so that
+ * finding the groundtruth region a blob (or any other box) falls in doesn't
+ * mean re-reading and re-parsing the file. Each image's regions are kept
+ * sorted by their top in a static search tree where each node also holds
+ * the lowest bottom of any region under it, so a query only visits the
+ * regions that could overlap it vertically: O(log n + k) for n regions on
+ * the image of which k overlap. The index isn't modified after it's built
+ * so it can be searched from several threads at once.
+ */
+class GroundTruthIndex {
+ public:
+
+  /**
+   * Parses every entry in the groundtruth file at the given path (the file
+   * must exist)
+   */
+  GroundTruthIndex(const std::string& groundtruthFilePath);
+
+  ~GroundTruthIndex();
+
+  /**
+   * Finds the entry for the given image whose rectangle intersects the box
+   * (as determined by Leptonica's boxIntersects). If more than one does then
+   * the one appearing first in the groundtruth file is given. Returns NULL if
+   * there isn't one. The entry is owned by the index.
+   */
+  const GroundTruthEntry* findIntersectingEntry(const int& imageIndex,
+      Box* const box) const;
+
+  /**
+   * Same as findIntersectingEntry, but returns a newly allocated copy of
+   * the entry which is owned by the caller
+   */
+  GroundTruthEntry* copyIntersectingEntry(const int& imageIndex,
+      Box* const box) const;
+
+ private:
+
+  struct IndexedRect {
+    int left;
+    int top;
+    int right; // inclusive
+    int bottom; // inclusive
+    int entryIndex; // index of the entry in the file (for the image)
+  };
+
+  struct ImageEntries {
+    std::vector<GroundTruthEntry*> entries; // in the order they're in the file
+    std::vector<IndexedRect> rects; // sorted by top
+    std::vector<int> maxBottoms; // lowest bottom in each rect's subtree
+  };
+
+  // fills in the max bottoms for the subtree rooted at the middle of the
+  // given range of rects and returns the subtree's
+  static int buildSubtree(ImageEntries& image, const int& begin,
+      const int& end);
+
+  // searches the subtree rooted at the middle of the given range of rects
+  // updating firstEntry to the earliest entry found that intersects
+  static void searchSubtree(const ImageEntries& image, const int& begin,
+      const int& end, const IndexedRect& query, int& firstEntry);
+
+  static IndexedRect getRect(Box* const box);
+
+  static bool isTopLess(const IndexedRect& rect1, const IndexedRect& rect2);
+
+  std::vector<ImageEntries> images; // indexed by image index
+};
+
+
+#endif /* GTINDEX_H_ */
@@ -8,89 +8,35 @@
 #include <SampleFileParser.h>
 
 #include <Sample.h>
+#include <SampleStore.h>
 #include <Utils.h>
-#include <DoubleFeature.h>
-#include <FeatExtFlagDesc.h>
 
 #include <allheaders.h>
 
 #include <vector>
 #include <iostream>
-#include <iomanip>
 #include <assert.h>
 #include <stddef.h>
 
 void SampleFileParser::writeSamples(const std::string& sample_path,
-    const std::vector<std::vector<BLSample*> >& samples) {
+    const std::vector<std::vector<BLSample*> >& samples,
+    const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors) {
   std::cout << "Writing the samples to " << sample_path << std::endl;
   int samplecount = 0;
-  std::ofstream s(sample_path.c_str());
-  if(!s.is_open()) {
-    std::cout << "ERROR: Couldn't open " << sample_path << " for writing\n";
-    assert(false);
-  }
-
   for(int i = 0; i < samples.size(); ++i) {
-    for(int j = 0; j < samples[i].size(); ++j) {
-      writeSample(samples[i][j], s);
-      ++samplecount;
-    }
+    samplecount += samples[i].size();
   }
+  SampleStore::write(sample_path, samples, blobFeatureExtractors);
   std::cout << "Total of " << samplecount << " samples written.\n";
 }
 
-// writes the sample in the following space-delimited format:
-// label featurevec imgindex blobbox groundtruth_entry
-// label: 0 or 1
-// featurevec: comma delimited list of doubles
-// imgname: gives the name of the image in which the blob resides (0.png, 1.png, 2.jpg, etc.)
-// imgindex: gives the index of the image in which the blob resides (should be an integer matching the name)
-// blobbox: comma delimited coordinates as follows x,y,w,h
-// groundtruth_entry: info on the matching groundtruth entry if label is 1
-//                    otherwise the following comma delimited list is all 0's
-//                    type,x,y,w,h <- type is E/D/L (embedded displayed or labeled)
-//                     and x,y,w,h is the bounding box of the entry
-// Thus the entire space-delimited format is as follows:
-// label f1,f2,etc., imgname x1,y1,w1,h1 entrytype,x2,y2,w2,h2
-// f is the feature, x1-h1 are the coords for the blob, and x2-h2 are the coords
-// for the groundtruth entry if applicable (otherwise all 0's)
-void SampleFileParser::writeSample(BLSample* const sample, std::ofstream& fs) {
-  if(sample->label)
-    fs << 1 << " ";
-  else
-    fs << 0 << " ";
-  int numfeat = (sample->features).size();
-  for(int i = 0; i < numfeat; ++i) {
-    fs << std::setprecision(20) << sample->features[i]->getFeature();
-    fs << (((i + 1) < numfeat) ? "," : " ");
-  }
-  fs << sample->imageName << " ";
-  fs << sample->imageIndex << " ";
-  BOX* box = sample->blobbox;
-  fs << box->x << "," << box->y << "," << box->w << "," << box->h << " ";
-  if(sample->entry) {
-    GroundTruthEntry* entry = sample->entry;
-    GT_Entry::GTEntryType type = entry->entry;
-    if(type == GT_Entry::DISPLAYED)
-      fs << "D,";
-    else if(type == GT_Entry::EMBEDDED)
-      fs << "E,";
-    else if(type == GT_Entry::LABEL)
-      fs << "L,";
-    else {
-      std::cout << "ERROR: Unexpected groundtruth entry type\n";
-      assert(false);
-    }
-    BOX* gtbox = entry->rect;
-    fs << gtbox->x << "," << gtbox->y << "," << gtbox->w
-       << "," << gtbox->h << "\n";
-  }
-  else
-    fs << "0,0,0,0,0\n";
-}
-
 std::vector<std::vector<BLSample*> > SampleFileParser::readOldSamples(const std::string& sample_path,
     const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors) {
+  // samples files are written as a SampleStore now, but older ones were
+  // written as text with one sample per line
+  if(SampleStore::isSampleStore(sample_path)) {
+    return SampleStore(sample_path, blobFeatureExtractors).createSamples();
+  }
   std::vector<std::vector<BLSample*> > samples_read = std::vector<std::vector<BLSample*> >();
   std::ifstream s(sample_path.c_str());
   if(!s.is_open()) {
@@ -120,7 +66,8 @@ std::vector<std::vector<BLSample*> > SampleFileParser::readOldSamples(const std:
   return samples_read;
 }
 
-// reads the sample in the following space-delimited format:
+// reads a sample from an older text samples file, which were written in the
+// following space-delimited format:
 // label featurevec imgindex blobbox groundtruth_entry
 // label: 0 or 1
 // featurevec: comma delimited list of doubles
@@ -146,29 +93,15 @@ BLSample* SampleFileParser::readSample(const std::string& line,
   // get the feature vec
   std::string fvecstring = spacesplit[1];
   std::vector<std::string> featureStrVec = Utils::stringSplit(fvecstring, ',');
-  std::vector<DoubleFeature*> featureVec;
+  std::vector<double> featureVec;
+  featureVec.reserve(featureStrVec.size());
   int index = 0;
   for(int i = 0; i < blobFeatureExtractors.size(); ++i) {
-    BlobFeatureExtractor* const featExt = blobFeatureExtractors[i];
-    assert(index < featureStrVec.size()); // sanity
-    std::vector<FeatureExtractorFlagDescription*> enabledFlags =
-        featExt->getEnabledFlagDescriptions();
-    // no enabled flags, just read in as a feature
-    if(enabledFlags.empty()) {
-      featureVec.push_back(
-          new DoubleFeature(
-              featExt->getFeatureExtractorDescription(),
-              atof(featureStrVec[index++].c_str())));
-      continue;
-    }
-    // otherwise read in as flags
-    for(int j = 0; j < enabledFlags.size(); ++j) {
+    // one feature for each of the extractor's columns (one per enabled flag)
+    const int numColumns = blobFeatureExtractors[i]->getNumFeatureColumns();
+    for(int j = 0; j < numColumns; ++j) {
       assert(index < featureStrVec.size()); // sanity
-      featureVec.push_back(
-          new DoubleFeature(
-              featExt->getFeatureExtractorDescription(),
-              atof(featureStrVec[index++].c_str()),
-              enabledFlags[j]));
+      featureVec.push_back(atof(featureStrVec[index++].c_str()));
     }
   }
   assert(featureVec.size() == featureStrVec.size()); // sanity check
@@ -17,12 +17,12 @@
 
 namespace SampleFileParser {
 
-// Serialization methods
+// Serialization methods (writes a SampleStore for the feature extractors)
 void writeSamples(const std::string& sample_path,
-    const std::vector<std::vector<BLSample*> >& samples);
-void writeSample(BLSample* const sample, std::ofstream& fs);
+    const std::vector<std::vector<BLSample*> >& samples,
+    const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors);
 
-// Deserialization methods
+// Deserialization methods (reads either a SampleStore or an older text file)
 std::vector<std::vector<BLSample*> > readOldSamples(const std::string& sample_path,
   const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors);
 BLSample* readSample(const std::string& line,
@@ -0,0 +1,318 @@
+/*
+ * SampleStore.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <SampleStore.h>
+
+#include <Sample.h>
+#include <BlobFeatExt.h>
+
+#include <allheaders.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char SampleStore::magic[8] = {'M', 'F', 'S', 'A', 'M', 'P', 'L', 'E'};
+
+void SampleStore::write(const std::string& path,
+    const std::vector<std::vector<BLSample*> >& samples,
+    const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors) {
+  std::vector<BLSample*> allSamples;
+  std::string imageNames;
+  for(int i = 0; i < samples.size(); ++i) {
+    allSamples.insert(allSamples.end(), samples[i].begin(), samples[i].end());
+    appendString(imageNames, samples[i].empty() ? "" : samples[i][0]->imageName);
+  }
+  padTo8(imageNames);
+  const std::string schema = makeSchema(blobFeatureExtractors);
+  int numColumns = 0;
+  for(int i = 0; i < blobFeatureExtractors.size(); ++i) {
+    numColumns += blobFeatureExtractors[i]->getNumFeatureColumns();
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.byteOrderMark = byteOrderMark;
+  header.numSamples = allSamples.size();
+  header.numColumns = numColumns;
+  header.numImages = samples.size();
+  header.schemaSize = schema.size();
+  header.imageNamesSize = imageNames.size();
+
+  std::ofstream fs(path.c_str(), std::ios::binary | std::ios::trunc);
+  if(!fs.is_open()) {
+    std::cout << "ERROR: Couldn't open " << path << " for writing\n";
+    assert(false);
+  }
+  fs.write((const char*)&header, sizeof(Header));
+  fs.write(schema.data(), schema.size());
+  fs.write(imageNames.data(), imageNames.size());
+
+  // one column at a time
+  std::vector<double> column(allSamples.size());
+  for(int j = 0; j < numColumns; ++j) {
+    for(size_t i = 0; i < allSamples.size(); ++i) {
+      if(allSamples[i]->features.size() != numColumns) {
+        std::cout << "ERROR: A sample has " << allSamples[i]->features.size()
+            << " features rather than the " << numColumns
+            << " the feature extractors have columns for.\n";
+        assert(false);
+      }
+      column[i] = allSamples[i]->features[j];
+    }
+    if(!column.empty()) {
+      fs.write((const char*)&column[0], column.size() * sizeof(double));
+    }
+  }
+
+  // then the per sample arrays, each padded out to 8 bytes
+  const std::string padding(8, '\0');
+  std::vector<unsigned char> labels(allSamples.size());
+  std::vector<inT32> imageIndices(allSamples.size());
+  std::vector<inT32> blobBoxes(allSamples.size() * 4);
+  std::vector<char> gtTypes(allSamples.size());
+  std::vector<inT32> gtBoxes(allSamples.size() * 4, 0);
+  for(size_t i = 0; i < allSamples.size(); ++i) {
+    BLSample* const sample = allSamples[i];
+    labels[i] = sample->label ? 1 : 0;
+    imageIndices[i] = sample->imageIndex;
+    boxGetGeometry(sample->blobbox, &blobBoxes[i * 4], &blobBoxes[i * 4 + 1],
+        &blobBoxes[i * 4 + 2], &blobBoxes[i * 4 + 3]);
+    gtTypes[i] = getGroundTruthType(sample->entry);
+    if(sample->entry != NULL) {
+      boxGetGeometry(sample->entry->rect, &gtBoxes[i * 4], &gtBoxes[i * 4 + 1],
+          &gtBoxes[i * 4 + 2], &gtBoxes[i * 4 + 3]);
+    }
+  }
+  const size_t n = allSamples.size();
+  if(n > 0) {
+    fs.write((const char*)&labels[0], n);
+    fs.write(padding.data(), getPadded(n) - n);
+    fs.write((const char*)&imageIndices[0], n * sizeof(inT32));
+    fs.write(padding.data(), getPadded(n * sizeof(inT32)) - n * sizeof(inT32));
+    fs.write((const char*)&blobBoxes[0], n * 4 * sizeof(inT32));
+    fs.write(&gtTypes[0], n);
+    fs.write(padding.data(), getPadded(n) - n);
+    fs.write((const char*)&gtBoxes[0], n * 4 * sizeof(inT32));
+  }
+  if(!fs) {
+    std::cout << "ERROR: Failed writing the samples to " << path << std::endl;
+    assert(false);
+  }
+  fs.close();
+}
+
+bool SampleStore::isSampleStore(const std::string& path) {
+  std::ifstream fs(path.c_str(), std::ios::binary);
+  char fileMagic[sizeof(magic)];
+  if(!fs.is_open() || !fs.read(fileMagic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(fileMagic, magic, sizeof(magic)) == 0;
+}
+
+SampleStore::SampleStore(const std::string& path,
+    const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors)
+: path(path), mapped(NULL), mappedSize(0), features(NULL), labels(NULL),
+  imageIndices(NULL), blobBoxes(NULL), gtTypes(NULL), gtBoxes(NULL) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  struct stat fileStat;
+  if(fd < 0 || fstat(fd, &fileStat) != 0) {
+    std::cout << "ERROR: Couldn't open the sample file at " << path << std::endl;
+    assert(false);
+  }
+  mappedSize = fileStat.st_size;
+  if(mappedSize < sizeof(Header)) {
+    std::cout << "ERROR: Invalid sample file at " << path << std::endl;
+    assert(false);
+  }
+  mapped = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(mapped == MAP_FAILED) {
+    std::cout << "ERROR: Couldn't map the sample file at " << path << std::endl;
+    assert(false);
+  }
+  const char* const bytes = (const char*)mapped;
+  memcpy(&header, bytes, sizeof(Header));
+  if(memcmp(header.magic, magic, sizeof(magic)) != 0
+      || header.version != version || header.byteOrderMark != byteOrderMark) {
+    std::cout << "ERROR: The sample file at " << path << " is not a version "
+        << version << " sample file for this machine.\n";
+    assert(false);
+  }
+  size_t featuresOffset, labelsOffset, imageIndicesOffset, blobBoxesOffset,
+      gtTypesOffset, gtBoxesOffset;
+  const size_t size = getSectionOffsets(header, featuresOffset, labelsOffset,
+      imageIndicesOffset, blobBoxesOffset, gtTypesOffset, gtBoxesOffset);
+  if(size != mappedSize) {
+    std::cout << "ERROR: The sample file at " << path << " is " << mappedSize
+        << " bytes but should be " << size << " bytes.\n";
+    assert(false);
+  }
+
+  // the samples have to be for the feature extractors being trained
+  const std::string schema = makeSchema(blobFeatureExtractors);
+  if(schema.size() != header.schemaSize
+      || memcmp(schema.data(), bytes + sizeof(Header), schema.size()) != 0) {
+    std::cout << "ERROR: The samples at " << path << " were extracted with "
+        << "different feature extractors (or flags) than the ones selected.\n";
+    assert(false);
+  }
+
+  const char* name = bytes + sizeof(Header) + header.schemaSize;
+  for(uinT64 i = 0; i < header.numImages; ++i) {
+    uinT32 length = 0;
+    memcpy(&length, name, sizeof(uinT32));
+    imageNames.push_back(std::string(name + sizeof(uinT32), length));
+    name += sizeof(uinT32) + length;
+  }
+
+  features = (const double*)(bytes + featuresOffset);
+  labels = (const unsigned char*)(bytes + labelsOffset);
+  imageIndices = (const inT32*)(bytes + imageIndicesOffset);
+  blobBoxes = (const inT32*)(bytes + blobBoxesOffset);
+  gtTypes = bytes + gtTypesOffset;
+  gtBoxes = (const inT32*)(bytes + gtBoxesOffset);
+}
+
+SampleStore::~SampleStore() {
+  if(mapped != NULL) {
+    munmap(mapped, mappedSize);
+  }
+}
+
+long SampleStore::getNumSamples() const {
+  return header.numSamples;
+}
+
+int SampleStore::getNumColumns() const {
+  return header.numColumns;
+}
+
+int SampleStore::getNumImages() const {
+  return header.numImages;
+}
+
+const double* SampleStore::getFeatureColumn(const int& column) const {
+  assert(column >= 0 && column < header.numColumns);
+  return features + (size_t)column * header.numSamples;
+}
+
+std::vector<std::vector<BLSample*> > SampleStore::createSamples() const {
+  std::vector<std::vector<BLSample*> > samples(header.numImages);
+  for(long i = 0; i < header.numSamples; ++i) {
+    const int imageIndex = imageIndices[i];
+    if(imageIndex < 0 || imageIndex >= header.numImages) {
+      std::cout << "ERROR: Invalid image index in the sample file at "
+          << path << std::endl;
+      assert(false);
+    }
+    BLSample* const sample = new BLSample;
+    sample->label = (labels[i] != 0);
+    sample->features.resize(header.numColumns);
+    for(int j = 0; j < header.numColumns; ++j) {
+      sample->features[j] = features[(size_t)j * header.numSamples + i];
+    }
+    sample->imageName = imageNames[imageIndex];
+    sample->imageIndex = imageIndex;
+    const inT32* const box = blobBoxes + i * 4;
+    sample->blobbox = boxCreate(box[0], box[1], box[2], box[3]);
+    if(gtTypes[i] != '0') {
+      GroundTruthEntry* const entry = new GroundTruthEntry;
+      if(gtTypes[i] == 'D')
+        entry->entry = GT_Entry::DISPLAYED;
+      else if(gtTypes[i] == 'E')
+        entry->entry = GT_Entry::EMBEDDED;
+      else if(gtTypes[i] == 'L')
+        entry->entry = GT_Entry::LABEL;
+      else {
+        std::cout << "ERROR: Invalid groundtruth entry type in the sample file at "
+            << path << std::endl;
+        assert(false);
+      }
+      const inT32* const gtBox = gtBoxes + i * 4;
+      entry->rect = boxCreate(gtBox[0], gtBox[1], gtBox[2], gtBox[3]);
+      entry->image_index = imageIndex;
+      sample->entry = entry;
+    }
+    samples[imageIndex].push_back(sample);
+  }
+  return samples;
+}
+
+size_t SampleStore::getSectionOffsets(const Header& header, size_t& features,
+    size_t& labels, size_t& imageIndices, size_t& blobBoxes,
+    size_t& gtTypes, size_t& gtBoxes) {
+  const size_t n = header.numSamples;
+  features = sizeof(Header) + header.schemaSize + header.imageNamesSize;
+  labels = features + header.numColumns * n * sizeof(double);
+  imageIndices = labels + getPadded(n);
+  blobBoxes = imageIndices + getPadded(n * sizeof(inT32));
+  gtTypes = blobBoxes + n * 4 * sizeof(inT32);
+  gtBoxes = gtTypes + getPadded(n);
+  return gtBoxes + n * 4 * sizeof(inT32);
+}
+
+std::string SampleStore::makeSchema(
+    const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors) {
+  std::string schema;
+  appendInt(schema, blobFeatureExtractors.size());
+  for(int i = 0; i < blobFeatureExtractors.size(); ++i) {
+    BlobFeatureExtractor* const extractor = blobFeatureExtractors[i];
+    appendString(schema,
+        extractor->getFeatureExtractorDescription()->getUniqueName());
+    appendInt(schema, extractor->getNumFeatureColumns());
+    const std::vector<FeatureExtractorFlagDescription*> flags =
+        extractor->getEnabledFlagDescriptions();
+    appendInt(schema, flags.size());
+    for(int j = 0; j < flags.size(); ++j) {
+      appendString(schema, flags[j]->getName());
+    }
+  }
+  padTo8(schema);
+  return schema;
+}
+
+void SampleStore::appendString(std::string& buffer, const std::string& str) {
+  appendInt(buffer, str.size());
+  buffer.append(str);
+}
+
+void SampleStore::appendInt(std::string& buffer, const uinT32& value) {
+  buffer.append((const char*)&value, sizeof(uinT32));
+}
+
+void SampleStore::padTo8(std::string& buffer) {
+  buffer.resize(getPadded(buffer.size()), '\0');
+}
+
+size_t SampleStore::getPadded(const size_t& size) {
+  return (size + 7) & ~(size_t)7;
+}
+
+char SampleStore::getGroundTruthType(GroundTruthEntry* const entry) {
+  if(entry == NULL)
+    return '0';
+  if(entry->entry == GT_Entry::DISPLAYED)
+    return 'D';
+  if(entry->entry == GT_Entry::EMBEDDED)
+    return 'E';
+  if(entry->entry == GT_Entry::LABEL)
+    return 'L';
+  std::cout << "ERROR: Unexpected groundtruth entry type\n";
+  assert(false);
+  return '0';
+}
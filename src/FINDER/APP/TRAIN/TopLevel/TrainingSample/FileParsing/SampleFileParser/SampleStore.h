@@ -0,0 +1,131 @@
+/*
+ * SampleStore.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef SAMPLESTORE_H_
+#define SAMPLESTORE_H_
+
+#include <Sample.h>
+#include <BlobFeatExt.h>
+
+#include <host.h>
+
+#include <allheaders.h>
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * Binary file holding every training sample extracted for a Finder, laid out
+ * by column so that it can be memory-mapped and read without any parsing:
+ *
+ *   header      - magic, version, byte order mark, and the section sizes
+ *   schema      - for each feature extractor (in order) its unique name, its
+ *                 number of feature columns, and the names of its enabled
+ *                 flags (one per column)
+ *   image names - the name of each image, indexed by image index
+ *   features    - one contiguous array of float64 per feature column
+ *   labels      - one byte per sample (1 for math, 0 otherwise)
+ *   image index - one int32 per sample
+ *   blob boxes  - x, y, w, h as int32 per sample
+ *   gt types    - one byte per sample ('D', 'E', 'L', or '0' if the sample
+ *                 isn't in a groundtruth entry)
+ *   gt boxes    - x, y, w, h as int32 per sample (all 0 if no entry)
+ *
+ * Every section starts on an 8 byte boundary. Values are stored in the byte
+ * order of the machine that wrote the file (which has to be the same as the
+ * one reading it).
+ */
+class SampleStore {
+ public:
+
+  /**
+   * Writes the samples (one vector per image, in image index order) which
+   * were extracted by the given feature extractors to the file at the path
+   */
+  static void write(const std::string& path,
+      const std::vector<std::vector<BLSample*> >& samples,
+      const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors);
+
+  /**
+   * True if the file at the path exists and is a sample store (rather than
+   * the older text samples file)
+   */
+  static bool isSampleStore(const std::string& path);
+
+  /**
+   * Maps the sample store at the given path into memory. The file must have
+   * been written for the given feature extractors (the same extractors with
+   * the same flags enabled, in the same order).
+   */
+  SampleStore(const std::string& path,
+      const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors);
+
+  ~SampleStore();
+
+  long getNumSamples() const;
+  int getNumColumns() const;
+  int getNumImages() const;
+
+  /**
+   * The values of the given feature column for every sample
+   */
+  const double* getFeatureColumn(const int& column) const;
+
+  /**
+   * Creates the samples (one vector per image) owned by the caller
+   */
+  std::vector<std::vector<BLSample*> > createSamples() const;
+
+ private:
+
+  struct Header {
+    char magic[8];
+    uinT32 version;
+    uinT32 byteOrderMark;
+    uinT64 numSamples;
+    uinT64 numColumns;
+    uinT64 numImages;
+    uinT64 schemaSize; // in bytes, padded
+    uinT64 imageNamesSize; // in bytes, padded
+  };
+
+  // the sections' offsets from the start of the file for the given header,
+  // returns the total size of the file
+  static size_t getSectionOffsets(const Header& header, size_t& features,
+      size_t& labels, size_t& imageIndices, size_t& blobBoxes,
+      size_t& gtTypes, size_t& gtBoxes);
+
+  static std::string makeSchema(
+      const std::vector<BlobFeatureExtractor*>& blobFeatureExtractors);
+
+  static void appendString(std::string& buffer, const std::string& str);
+  static void appendInt(std::string& buffer, const uinT32& value);
+  static void padTo8(std::string& buffer);
+  static size_t getPadded(const size_t& size);
+
+  static char getGroundTruthType(GroundTruthEntry* const entry);
+
+  static const char magic[8];
+  static const uinT32 version = 1;
+  static const uinT32 byteOrderMark = 0x01020304;
+
+  std::string path;
+  void* mapped;
+  size_t mappedSize;
+  Header header;
+  std::vector<std::string> imageNames;
+  const double* features;
+  const unsigned char* labels;
+  const inT32* imageIndices;
+  const inT32* blobBoxes;
+  const char* gtTypes;
+  const inT32* gtBoxes;
+};
+
+
+#endif /* SAMPLESTORE_H_ */
@@ -13,7 +13,6 @@
 #define SAMPLE_H
 
 #include <Utils.h>
-#include <DoubleFeature.h>
 
 #include <allheaders.h>
 
@@ -56,7 +55,7 @@ struct BLSample {
 
   bool operator!=(const BLSample& othersample);
 
-  std::vector<DoubleFeature*> features;
+  std::vector<double> features; // the blob's row of the FeatureMatrix
   bool label;
   GroundTruthEntry* entry; // if this is NULL then the sample is non-math
   BOX* blobbox; // the sample's bounding box for debugging
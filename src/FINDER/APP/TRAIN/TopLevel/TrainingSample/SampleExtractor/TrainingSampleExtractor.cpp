@@ -10,18 +10,22 @@
 #include <FinderInfo.h>
 #include <FeatExt.h>
 #include <Sample.h>
-#include <GTParser.h>
+#include <GTIndex.h>
 #include <Utils.h>
 #include <M_Utils.h>
 #include <SampleFileParser.h>
 #include <BlobDataGrid.h>
 #include <BlobDataGridFactory.h>
 #include <DatasetMenu.h>
+#include <TessEnginePool.h>
 
 #include <baseapi.h>
 
 #include <allheaders.h>
 
+#include <dlib/threads.h>
+
+#include <algorithm>
 #include <vector>
 #include <assert.h>
 #include <stddef.h>
@@ -34,7 +38,8 @@
 
 
 TrainingSampleExtractor::TrainingSampleExtractor(FinderInfo* const finderInfo,
-    MathExpressionFeatureExtractor* const featureExtractor) {
+    MathExpressionFeatureExtractor* const featureExtractor)
+: groundtruthIndex(NULL), nextJobImage(0), jobImageDone(jobMutex) {
   this->finderInfo = finderInfo;
   this->featureExtractor = featureExtractor;
 }
@@ -99,16 +104,47 @@ void TrainingSampleExtractor::getNewSamples(bool writeToFile) {
   featureExtractor->doTrainerInitialization();
   std::cout << "Done with trainer initialization on all extractors.\n";
 
-  // Extract the features for each image in the groundtruth dataset
+  // Parse the groundtruth once up front for labeling the samples
+  groundtruthIndex = new GroundTruthIndex(finderInfo->getGroundtruthFilePath());
+
+  // Extract the features for each image in the groundtruth dataset. The
+  // images are recognized, have their grids built, and have their features
+  // extracted in parallel (each worker on its own engine and with its own
+  // feature extractor, since the extractors keep state for the page they're
+  // on) while this thread takes the finished samples in image order. Each
+  // image's samples only depend on its own grid and the state shared from the
+  // trainer initialization, so they come out the same as if everything had
+  // been done serially.
   std::cout << "Extracting the features for each image in the groundtruth dataset.\n";
   //Utils::waitForInput();
-  for(int i = 0; i < finderInfo->getGroundtruthImagePaths().size(); ++i) {
-    tesseract::TessBaseAPI api; // the tesseract api that will be used for features which require it during feature extraction
-
+  const int numImages = finderInfo->getGroundtruthImagePaths().size();
+  jobGrids.assign(numImages, ImageGrid());
+  nextJobImage = 0;
+  const int numWorkers =
+      std::max(1, std::min(Utils::getNumProcessors(), numImages));
+  jobFeatureExtractors.assign(1, featureExtractor);
+  for(int i = 1; i < numWorkers; ++i) {
+    jobFeatureExtractors.push_back(featureExtractor->createTrainingWorker());
+  }
+  // a worker has to lease an engine before it can take an image, so there are
+  // never more grids waiting on this thread than there are engines
+  TesseractEnginePool::getSharedPool()->reserveEngines(numWorkers);
+  dlib::thread_pool threadPool(numWorkers);
+  for(long i = 0; i < numWorkers; ++i) {
+    threadPool.add_task(*this, &TrainingSampleExtractor::buildImageGrids, i);
+  }
+  for(int i = 0; i < numImages; ++i) {
+    jobMutex.lock();
+    while(!jobGrids[i].done) {
+      jobImageDone.wait();
+    }
+    jobMutex.unlock();
     const std::string imagePath = finderInfo->getGroundtruthImagePaths()[i];
-    Pix* image = Utils::leptReadImg(imagePath);
-
-    BlobDataGrid* blobDataGrid = BlobDataGridFactory().createBlobDataGrid(image, &api, Utils::getNameFromPath(imagePath));
+    Pix* image = jobGrids[i].image; // no longer touched by the workers
+    BlobDataGrid* blobDataGrid = jobGrids[i].grid;
+    tesseract::TessBaseAPI* const api = jobGrids[i].api;
+    std::vector<BLSample*> img_samples = jobGrids[i].samples;
+    jobGrids[i] = ImageGrid();
 #ifdef DBG_SHOW_GRID
     std::string winname = "BlobDataGrid for Image " +  Utils::getNameFromPath(imagePath);
     ScrollView* gridviewer = blobDataGrid->MakeWindow(100, 100, winname.c_str());
@@ -118,10 +154,6 @@ void TrainingSampleExtractor::getNewSamples(bool writeToFile) {
     gridviewer = NULL;
 #endif
 
-    // now to get the features from the grid and append them to the
-    // samples vector.
-    std::vector<BLSample*> img_samples = getGridSamples(blobDataGrid, i);
-
 #ifdef DBG
     std::cout << "Finished grabbing samples.\n";
     M_Utils::waitForInput();
@@ -164,6 +196,8 @@ void TrainingSampleExtractor::getNewSamples(bool writeToFile) {
     // the vector which holds all of them. For now I have this organized
     // as a vector for each image
     samples_extracted.push_back(img_samples);
+    delete blobDataGrid;
+    TesseractEnginePool::getSharedPool()->returnEngine(api);
     pixDestroy(&image); // destroy finished image
 
 #ifdef DBG_MEDS_TRAINER
@@ -173,10 +207,50 @@ void TrainingSampleExtractor::getNewSamples(bool writeToFile) {
     std::cout << "Finished acquiring " << img_samples.size()
          << " samples for image " << finderInfo->getGroundtruthImagePaths()[i] << std::endl;
   }
+  threadPool.wait_for_all_tasks();
+  jobGrids.clear();
+  for(int i = 1; i < jobFeatureExtractors.size(); ++i) {
+    delete jobFeatureExtractors[i]; // the first one is featureExtractor
+  }
+  jobFeatureExtractors.clear();
+  delete groundtruthIndex;
+  groundtruthIndex = NULL;
   if(writeToFile) {
     SampleFileParser::writeSamples(
         finderInfo->getFinderTrainingPaths()->getSampleFilePath(),
-        samples_extracted);
+        samples_extracted,
+        featureExtractor->getBlobFeatureExtractors());
+  }
+}
+
+void TrainingSampleExtractor::buildImageGrids(long workerIndex) {
+  MathExpressionFeatureExtractor* const workerFeatureExtractor =
+      jobFeatureExtractors[workerIndex];
+  while(true) {
+    // lease the engine before taking an image so that whichever image this
+    // thread is waiting on is always being worked on by a thread that has one
+    tesseract::TessBaseAPI* const api = TesseractEnginePool::getSharedPool()->leaseEngine();
+    jobMutex.lock();
+    const int i = nextJobImage++;
+    jobMutex.unlock();
+    if(i >= jobGrids.size()) {
+      TesseractEnginePool::getSharedPool()->returnEngine(api);
+      return;
+    }
+    const std::string imagePath = finderInfo->getGroundtruthImagePaths()[i];
+    ImageGrid imageGrid;
+    imageGrid.image = Utils::leptReadImg(imagePath);
+    imageGrid.grid = BlobDataGridFactory().createBlobDataGrid(
+        imageGrid.image, api, Utils::getNameFromPath(imagePath));
+    imageGrid.api = api;
+
+    // now to get the features from the grid and make the samples from them
+    imageGrid.samples =
+        getGridSamples(workerFeatureExtractor, imageGrid.grid, i);
+    imageGrid.done = true;
+    dlib::auto_mutex lock(jobMutex);
+    jobGrids[i] = imageGrid; // each image's slot is only written once
+    jobImageDone.broadcast();
   }
 }
 
@@ -189,10 +263,11 @@ void TrainingSampleExtractor::getNewSamples(bool writeToFile) {
 // stored inside a BLOBINFO object as a vector of doubles. What features
 // these doubles represent varies based upon what feature extractor
 // implementation is being utilized.
-std::vector<BLSample*> TrainingSampleExtractor::getGridSamples(BlobDataGrid* const blobDataGrid,
-    int image_index) {
+std::vector<BLSample*> TrainingSampleExtractor::getGridSamples(
+    MathExpressionFeatureExtractor* const extractor,
+    BlobDataGrid* const blobDataGrid, int image_index) {
   std::cout << "Starting feature extraction for training image " << image_index << std::endl;
-  featureExtractor->extractFeatures(blobDataGrid);
+  extractor->extractFeatures(blobDataGrid);
   std::cout << "Finished extracting features for training image " << image_index << std::endl;
   BlobDataGridSearch bdgs(blobDataGrid);
   bdgs.StartFullSearch();
@@ -201,13 +276,14 @@ std::vector<BLSample*> TrainingSampleExtractor::getGridSamples(BlobDataGrid* con
   int blobnum = 0;
   assert(DatasetSelectionMenu::getFileNumFromPath(finderInfo->getGroundtruthImagePaths()[image_index]) == image_index); // sanity
   while((blob = bdgs.NextFullSearch()) != NULL) {
-    if(blob->getExtractedFeatures().empty()) {
+    const double* const features = blob->getExtractedFeatures();
+    if(features == NULL) {
       std::cout << "ERROR: Attempting to create a training sample from a blob "
            << "from which features haven't been extracted!>:-[\n";
       assert(false);
     }
     BLSample* lsample = new BLSample; // labeled sample
-    lsample->features = blob->getExtractedFeatures();
+    lsample->features.assign(features, features + blob->getNumExtractedFeatures());
     lsample->entry = getBlobGTEntry(blob, image_index, blobDataGrid->getImage());
     TBOX tbox = blob->getBoundingBox();
     lsample->blobbox = M_Utils::tessTBoxToImBox(&tbox, blobDataGrid->getImage());
@@ -226,49 +302,14 @@ std::vector<BLSample*> TrainingSampleExtractor::getGridSamples(BlobDataGrid* con
 
 
 // If the given blob in the given image is contained within any of the groundtruth
-// entry rectangles, then return a pointer to the entry it's contained in. Otherwise
-// just return NULL.
+// entry rectangles, then return a copy of the (first) entry it's contained in,
+// owned by the caller. Otherwise just return NULL.
 GroundTruthEntry* TrainingSampleExtractor::getBlobGTEntry(BlobData* const blob, const int image_index, Pix* const img) {
-  // open the groundtruth file
-  std::ifstream gtfile;
-  std::string gtfilename = finderInfo->getGroundtruthFilePath();
-  gtfile.open(gtfilename.c_str(), std::ifstream::in);
-  if((gtfile.rdstate() & std::ifstream::failbit) != 0) {
-    std::cout << "ERROR: Could not open Groundtruth.dat in " \
-         << finderInfo->getGroundtruthDirPath() << std::endl;
-    assert(false);
-  }
-  int max = 55;
-  char* curline = new char[max];
-  bool found = false;
-  GroundTruthEntry* entry = NULL;
-  while(!gtfile.eof()) {
-    gtfile.getline(curline, max);
-    if(curline == NULL)
-      continue;
-    std::string curlinestr = (std::string)curline;
-    assert(curlinestr.length() < max);
-    entry = GtParser::parseGTLine(curlinestr);
-    if(entry == NULL)
-      continue;
-    if(entry->image_index == image_index) {
-      // see if the entry's rectangle overlaps this blob
-      Box* blob_bb = M_Utils::getBlobDataBox(blob, img);
-      int bb_intersects = 0; // this will be 1 if blob_bb intersects math
-      boxIntersects(entry->rect, blob_bb, &bb_intersects);
-      if(bb_intersects == 1) {
-        // found a math blob!
-        found = true;
-      }
-    }
-    if(found)
-      break;
-    delete entry; // delete the entry when we're done with it
-    entry = NULL;
-  }
-  delete [] curline;
-  curline = NULL;
-  gtfile.close();
+  assert(groundtruthIndex != NULL);
+  Box* blob_bb = M_Utils::getBlobDataBox(blob, img);
+  GroundTruthEntry* const entry =
+      groundtruthIndex->copyIntersectingEntry(image_index, blob_bb);
+  boxDestroy(&blob_bb);
   return entry;
 }
 
@@ -13,6 +13,13 @@
 #include <BlobDataGrid.h>
 #include <BlobData.h>
 #include <FeatExt.h>
+#include <GTIndex.h>
+
+#include <baseapi.h>
+
+#include <allheaders.h>
+
+#include <dlib/threads.h>
 
 #include <vector>
 
@@ -33,10 +40,41 @@ class TrainingSampleExtractor {
 
   void getNewSamples(bool writeToFile=true);
 
-  std::vector<BLSample*> getGridSamples(BlobDataGrid* const grid, int image_index);
+  // extracts the features from the grid with the given extractor and makes
+  // the image's labeled samples from them
+  std::vector<BLSample*> getGridSamples(
+      MathExpressionFeatureExtractor* const extractor,
+      BlobDataGrid* const grid, int image_index);
 
   GroundTruthEntry* getBlobGTEntry(BlobData* const blob, const int image_index, Pix* const img);
 
+  GroundTruthIndex* groundtruthIndex; // only exists while getting new samples
+
+  // a training image recognized and laid out in a grid by one of the worker
+  // threads along with the samples it extracted from it
+  struct ImageGrid {
+    ImageGrid() : image(NULL), grid(NULL), api(NULL), done(false) {}
+    Pix* image;
+    BlobDataGrid* grid;
+    tesseract::TessBaseAPI* api; // leased from the engine pool for the grid
+    std::vector<BLSample*> samples;
+    bool done;
+  };
+
+  // run by each worker thread, keeps leasing an engine, building the grid for
+  // the next training image, and extracting its samples until they've all
+  // been taken
+  void buildImageGrids(long workerIndex);
+
+  // state shared with the worker threads while getting new samples
+  std::vector<ImageGrid> jobGrids; // one per image
+  // one per worker, the first is featureExtractor and the rest are training
+  // workers created from it
+  std::vector<MathExpressionFeatureExtractor*> jobFeatureExtractors;
+  int nextJobImage;
+  dlib::mutex jobMutex;
+  dlib::signaler jobImageDone;
+
   void sampleReadVerify();
 
   // only one of the following is used unless sampleReadVerify is being used to test
@@ -16,21 +16,27 @@
 #include <SentenceData.h>
 #include <M_Utils.h>
 #include <MFinderResults.h>
+#include <FeatureMatrix.h>
 
 #include <baseapi.h>
+#include <coutln.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
 
 BlobDataGrid::BlobDataGrid(const int& gridsize,
     const ICOORD& bleft,
     const ICOORD& tright,
     tesseract::TessBaseAPI* const tessBaseAPI,
     PIX* const image,
-    std::string imageName): nonItalicizedRatio(-1) {
+    std::string imageName): nonItalicizedRatio(-1), featureMatrix(NULL) {
   this->Init(gridsize, bleft, tright);
   this->tessBaseAPI = tessBaseAPI;
   this->image = image;
   this->imageName = imageName;
   this->binaryImage = NULL;
-  this->area = gridheight_ * gridwidth_;
+  this->area = (tright.x() - bleft.x()) * (tright.y() - bleft.y());
 }
 
 // TODO: Make sure to deallocate things as necessary
@@ -43,6 +49,9 @@ BlobDataGrid::~BlobDataGrid() {
 
   pixDestroy(&binaryImage);
 
+  delete featureMatrix;
+  featureMatrix = NULL;
+
   // First grab any shared (double) pointers. Have to delete them after the blobs are deleted
   GenericVector<BlobMergeData**> mergeDataShared;
   {
@@ -99,6 +108,11 @@ Pix* BlobDataGrid::getBinaryImage() {
   return binaryImage;
 }
 
+void BlobDataGrid::setBinaryImage(Pix* const binaryImage) {
+  pixDestroy(&this->binaryImage);
+  this->binaryImage = binaryImage;
+}
+
 std::string BlobDataGrid::getImageName() {
   return imageName;
 }
@@ -122,6 +136,16 @@ void BlobDataGrid::setNonItalicizedRatio(double nonItalicizedRatio) {
   this->nonItalicizedRatio = nonItalicizedRatio;
 }
 
+FeatureMatrix* BlobDataGrid::getFeatureMatrix() {
+  return featureMatrix;
+}
+void BlobDataGrid::setFeatureMatrix(FeatureMatrix* const featureMatrix) {
+  if(this->featureMatrix != featureMatrix) {
+    delete this->featureMatrix;
+  }
+  this->featureMatrix = featureMatrix;
+}
+
 void BlobDataGrid::appendSegmentation(Segmentation* const segmentation) {
   segmentations.push_back(segmentation);
 }
@@ -316,7 +340,7 @@ void BlobDataGrid::HandleClick(int x, int y) {
   }
   if(bb->belongsToRecognizedNormalRow()) {
     std::cout << "The blob is on a row that is considered 'normal' paragraph text based on average vertical spacing on the page.\n";
-    std::cout << "The baseline for the blob is at y = " << bb->getParentRow()->row()->base_line(bb->left()) << std::endl;
+    std::cout << "The baseline for the blob is at y = " << bb->getParentRow()->getBaseline(bb->left()) << std::endl;
     std::cout << "The blob's bottom y is at " << bb->bottom() << std::endl;
     //ScrollView* baselineview = new ScrollView("baseline", 300, 100,
     //                        img->w, img->h, img->w, img->h, false);
@@ -362,3 +386,537 @@ void BlobDataGrid::HandleClick(int x, int y) {
 int BlobDataGrid::getArea() {
   return area;
 }
+
+BlobData_CLIST* BlobDataGrid::getCell(const int& gridX, const int& gridY) {
+  return &grid_[gridY * gridwidth_ + gridX];
+}
+
+void BlobDataGrid::InsertBBox(bool h_spread, bool v_spread, BlobData* bbox) {
+  tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData_C_IT>::InsertBBox(
+      h_spread, v_spread, bbox);
+  insertions.push_back(bbox);
+}
+
+BlobDataGridSearch::BlobDataGridSearch(BlobDataGrid* const grid)
+: uniqueMode(false), previousReturn(NULL), searchType(FULL_SEARCH),
+  xOrigin(0), yOrigin(0), lineDir(-1), lineLength(1), numLines(0),
+  bandStart(0), bandEnd(0), bandIndex(0), bandInsertions(0), lastStep(-1),
+  lastFirst(NULL), lastNext(NULL) {
+  this->grid = grid;
+  pixelGridWidth = grid->tright().x() - grid->bleft().x();
+  pixelGridHeight = grid->tright().y() - grid->bleft().y();
+}
+
+void BlobDataGridSearch::SetUniqueMode(bool mode) {
+  uniqueMode = mode;
+}
+
+bool BlobDataGridSearch::GetUniqueMode() const {
+  return uniqueMode;
+}
+
+namespace {
+// The order blobs are sorted in within a grid cell (same as SortByBoxLeft)
+int compareBoxes(const TBOX& box1, const TBOX& box2) {
+  if(box1.left() != box2.left()) {
+    return box1.left() - box2.left();
+  }
+  if(box1.right() != box2.right()) {
+    return box1.right() - box2.right();
+  }
+  if(box1.bottom() != box2.bottom()) {
+    return box1.bottom() - box2.bottom();
+  }
+  return box1.top() - box2.top();
+}
+}
+
+bool BlobDataGridSearch::SearchEntry::operator<(
+    const SearchEntry& other) const {
+  if(step != other.step) {
+    return step < other.step;
+  }
+  if(wrapped != other.wrapped) {
+    return other.wrapped;
+  }
+  return compareBoxes(blob->bounding_box(), other.blob->bounding_box()) < 0;
+}
+
+void BlobDataGridSearch::StartFullSearch() {
+  commonStart(FULL_SEARCH, grid->bleft().x(), grid->tright().y());
+  lineLength = pixelGridWidth;
+  numLines = pixelGridHeight;
+}
+
+BlobData* BlobDataGridSearch::NextFullSearch() {
+  previousReturn = nextEntry();
+  if(previousReturn == NULL) {
+    return commonEnd();
+  }
+  return previousReturn;
+}
+
+void BlobDataGridSearch::StartRadSearch(int x, int y, int max_radius) {
+  commonStart(RAD_SEARCH, x, y);
+  numLines = std::max(max_radius, 0) + 1; // one ring per radius
+}
+
+BlobData* BlobDataGridSearch::NextRadSearch() {
+  BlobData* next = NULL;
+  do {
+    if((next = nextEntry()) == NULL) {
+      return commonEnd();
+    }
+    previousReturn = next;
+  } while(uniqueMode && !returns.insert(next).second);
+  return next;
+}
+
+void BlobDataGridSearch::StartSideSearch(int x, int ymin, int ymax) {
+  commonStart(SIDE_SEARCH, x, ymax);
+  // double the height (in 1 pixel cells) same as GridSearch
+  lineLength = std::max((ymax - ymin) * 2, 0) + 1;
+  numLines = -1;
+}
+
+BlobData* BlobDataGridSearch::NextSideSearch(bool right_to_left) {
+  lineDir = right_to_left ? -1 : 1;
+  BlobData* next = NULL;
+  do {
+    if((next = nextEntry()) == NULL) {
+      return commonEnd();
+    }
+    previousReturn = next;
+  } while(uniqueMode && !returns.insert(next).second);
+  return next;
+}
+
+void BlobDataGridSearch::StartVerticalSearch(int xmin, int xmax, int y) {
+  commonStart(VERTICAL_SEARCH, xmin, y);
+  lineLength = std::max(xmax - xmin, 0) + 1;
+  numLines = -1;
+}
+
+BlobData* BlobDataGridSearch::NextVerticalSearch(bool top_to_bottom) {
+  lineDir = top_to_bottom ? -1 : 1;
+  BlobData* next = NULL;
+  do {
+    if((next = nextEntry()) == NULL) {
+      return commonEnd();
+    }
+    previousReturn = next;
+  } while(uniqueMode && !returns.insert(next).second);
+  return next;
+}
+
+void BlobDataGridSearch::StartRectSearch(const TBOX& rect) {
+  this->rect = rect;
+  commonStart(RECT_SEARCH, rect.left(), rect.top());
+  int right, bottom;
+  pixelCoords(rect.right(), rect.bottom(), &right, &bottom);
+  lineLength = std::max(right - xOrigin, 0) + 1;
+  numLines = std::max(yOrigin - bottom, 0) + 1;
+}
+
+BlobData* BlobDataGridSearch::NextRectSearch() {
+  BlobData* next = NULL;
+  do {
+    if((next = nextEntry()) == NULL) {
+      return commonEnd();
+    }
+    previousReturn = next;
+  } while(!rect.overlap(next->bounding_box()) ||
+      (uniqueMode && !returns.insert(next).second));
+  return next;
+}
+
+void BlobDataGridSearch::RemoveBBox() {
+  if(previousReturn == NULL) {
+    return;
+  }
+  grid->RemoveBBox(previousReturn);
+
+  // GridSearch forgets what's been returned whenever something is removed,
+  // so in unique mode the blobs already returned can come back from the
+  // pixels still to be searched. Otherwise only the removed blob's own
+  // entries need to go.
+  returns.clear();
+  if(uniqueMode && searchType != FULL_SEARCH) {
+    refreshBand();
+  } else {
+    int kept = bandIndex;
+    for(int i = bandIndex; i < band.size(); ++i) {
+      if(band[i].blob != previousReturn) {
+        band[kept++] = band[i];
+      }
+    }
+    band.resize(kept);
+  }
+  previousReturn = NULL;
+}
+
+void BlobDataGridSearch::commonStart(const SearchType& type, const int& x,
+    const int& y) {
+  searchType = type;
+  pixelCoords(x, y, &xOrigin, &yOrigin);
+  lineDir = -1;
+  lineLength = 1;
+  numLines = 0;
+  bandStart = 0;
+  bandEnd = 0;
+  band.clear();
+  bandIndex = 0;
+  bandInsertions = grid->insertions.size();
+  lastStep = -1;
+  lastStepReturns.clear();
+  previousReturn = NULL;
+  returns.clear();
+}
+
+BlobData* BlobDataGridSearch::commonEnd() {
+  previousReturn = NULL;
+  return NULL;
+}
+
+BlobData* BlobDataGridSearch::nextEntry() {
+  if(bandInsertions != grid->insertions.size()) {
+    refreshBand();
+  }
+  while(bandIndex >= band.size()) {
+    if(!lineInSearch(bandEnd)) {
+      return NULL;
+    }
+    bandStart = bandEnd;
+    const int cell = lineCell(bandStart);
+    do {
+      ++bandEnd;
+    } while(lineInSearch(bandEnd) && lineCell(bandEnd) == cell);
+    fillBand(-1);
+  }
+  const SearchEntry& entry = band[bandIndex++];
+  if(entry.step != lastStep) {
+    lastStep = entry.step;
+    lastStepReturns.clear();
+  }
+  lastStepReturns.push_back(entry.blob);
+  lastBox = entry.blob->bounding_box();
+  return entry.blob;
+}
+
+bool BlobDataGridSearch::lineInSearch(const int& line) const {
+  if(numLines >= 0 && line >= numLines) {
+    return false;
+  }
+  if(searchType == RAD_SEARCH) {
+    return true;
+  }
+  if(searchType == SIDE_SEARCH) {
+    const int x = xOrigin + lineDir * line;
+    return x >= 0 && x < pixelGridWidth;
+  }
+  const int y = yOrigin + lineDir * line;
+  return y >= 0 && y < pixelGridHeight;
+}
+
+int BlobDataGridSearch::lineCell(const int& line) const {
+  // every ring is a band of its own
+  if(searchType == RAD_SEARCH) {
+    return line;
+  }
+  int cellX, cellY;
+  if(searchType == SIDE_SEARCH) {
+    pixelCell(xOrigin + lineDir * line, 0, &cellX, &cellY);
+    return cellX;
+  }
+  pixelCell(0, yOrigin + lineDir * line, &cellX, &cellY);
+  return cellY;
+}
+
+void BlobDataGridSearch::fillBand(const long long& minStep) {
+  band.clear();
+  bandIndex = 0;
+  bandInsertions = grid->insertions.size();
+
+  // The pixels the band's lines cross
+  int minX, minY, maxX, maxY;
+  if(searchType == RAD_SEARCH) {
+    minX = xOrigin - bandStart;
+    maxX = xOrigin + bandStart;
+    minY = yOrigin - bandStart;
+    maxY = yOrigin + bandStart;
+  } else if(searchType == SIDE_SEARCH) {
+    minX = std::min(xOrigin + lineDir * bandStart,
+        xOrigin + lineDir * (bandEnd - 1));
+    maxX = std::max(xOrigin + lineDir * bandStart,
+        xOrigin + lineDir * (bandEnd - 1));
+    minY = yOrigin - (lineLength - 1);
+    maxY = yOrigin;
+  } else {
+    minX = xOrigin;
+    maxX = xOrigin + (lineLength - 1);
+    minY = std::min(yOrigin + lineDir * bandStart,
+        yOrigin + lineDir * (bandEnd - 1));
+    maxY = std::max(yOrigin + lineDir * bandStart,
+        yOrigin + lineDir * (bandEnd - 1));
+  }
+  minX = std::max(minX, 0);
+  minY = std::max(minY, 0);
+  maxX = std::min(maxX, pixelGridWidth - 1);
+  maxY = std::min(maxY, pixelGridHeight - 1);
+  if(minX > maxX || minY > maxY) {
+    return;
+  }
+  int cellLeft, cellBottom, cellRight, cellTop;
+  pixelCell(minX, minY, &cellLeft, &cellBottom);
+  pixelCell(maxX, maxY, &cellRight, &cellTop);
+
+  // Look at each blob once, in the first of the band's cells it's in (the
+  // full search takes it from the cell its box starts in instead). Blobs
+  // with identical boxes are all first found in the same cell, so the
+  // stable sort keeps them in that cell's order.
+  for(int cellY = cellTop; cellY >= cellBottom; --cellY) {
+    for(int cellX = cellLeft; cellX <= cellRight; ++cellX) {
+      BlobData_C_IT it(grid->getCell(cellX, cellY));
+      for(it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
+        BlobData* const blob = it.data();
+        const TBOX box = blob->bounding_box();
+        int left, bottom, right, top;
+        pixelCoords(box.left(), box.bottom(), &left, &bottom);
+        pixelCoords(box.right(), box.top(), &right, &top);
+        int firstX, firstY;
+        if(searchType == FULL_SEARCH) {
+          pixelCell(left, bottom, &firstX, &firstY);
+        } else {
+          pixelCell(std::max(left, minX), std::min(top, maxY),
+              &firstX, &firstY);
+        }
+        if(firstX != cellX || firstY != cellY) {
+          continue;
+        }
+        if(uniqueMode && searchType != FULL_SEARCH
+            && returns.find(blob) != returns.end()) {
+          continue;
+        }
+        addEntries(blob, minStep);
+      }
+    }
+  }
+  std::stable_sort(band.begin(), band.end());
+}
+
+void BlobDataGridSearch::addEntries(BlobData* const blob,
+    const long long& minStep) {
+  const TBOX box = blob->bounding_box();
+  int left, bottom, right, top;
+  pixelCoords(box.left(), box.bottom(), &left, &bottom);
+  pixelCoords(box.right(), box.top(), &right, &top);
+
+  // The pixels are gone through in the order they're searched in, and in
+  // unique mode only the first one is kept
+  SearchEntry entry;
+  entry.blob = blob;
+  entry.wrapped = false;
+  if(searchType == FULL_SEARCH) {
+    entry.step = (long long)(yOrigin - bottom) * lineLength + left;
+    if(searchesPixel(entry, minStep)) {
+      band.push_back(entry);
+    }
+  } else if(searchType == RAD_SEARCH) {
+    const int ring = bandStart;
+    if(ring == 0) {
+      entry.step = 0;
+      if(left <= xOrigin && xOrigin <= right
+          && bottom <= yOrigin && yOrigin <= top
+          && searchesPixel(entry, minStep)) {
+        band.push_back(entry);
+      }
+      return;
+    }
+    // the rings before this one have 1 + 4 + 8 + ... + 4 * (ring - 1) pixels
+    const long long ringStart = 1 + 2 * (long long)ring * (ring - 1);
+    for(int dir = 0; dir < 4; ++dir) {
+      for(int index = 0; index < ring; ++index) {
+        ICOORD offset = C_OUTLINE::chain_step(dir);
+        offset *= ring - index;
+        offset += C_OUTLINE::chain_step(dir + 1) * index;
+        const int x = xOrigin + offset.x();
+        const int y = yOrigin + offset.y();
+        if(x < left || x > right || y < bottom || y > top) {
+          continue;
+        }
+        entry.step = ringStart + (long long)dir * ring + index;
+        if(searchesPixel(entry, minStep)) {
+          band.push_back(entry);
+          if(uniqueMode) {
+            return;
+          }
+        }
+      }
+    }
+  } else {
+    // Each line crosses the box in a run of consecutive positions
+    int runStart, runEnd;
+    if(searchType == SIDE_SEARCH) {
+      runStart = std::max(yOrigin - top, 0);
+      runEnd = std::min(yOrigin - bottom, lineLength - 1);
+    } else {
+      runStart = std::max(left - xOrigin, 0);
+      runEnd = std::min(right - xOrigin, lineLength - 1);
+    }
+    if(runStart > runEnd) {
+      return;
+    }
+    for(int line = bandStart; line < bandEnd; ++line) {
+      if(searchType == SIDE_SEARCH) {
+        const int x = xOrigin + lineDir * line;
+        if(x < left || x > right) {
+          continue;
+        }
+      } else {
+        const int y = yOrigin + lineDir * line;
+        if(y < bottom || y > top) {
+          continue;
+        }
+      }
+      const long long lineStart = (long long)line * lineLength;
+      const int first = (int)std::max((long long)runStart,
+          std::min(minStep - lineStart, (long long)runEnd + 1));
+      for(int pos = first; pos <= runEnd; ++pos) {
+        entry.step = lineStart + pos;
+        if(searchesPixel(entry, minStep)) {
+          band.push_back(entry);
+          if(uniqueMode) {
+            return;
+          }
+        }
+      }
+    }
+  }
+}
+
+bool BlobDataGridSearch::searchesPixel(SearchEntry& entry,
+    const long long& minStep) const {
+  entry.wrapped = false;
+  if(entry.step != minStep) {
+    return entry.step > minStep;
+  }
+  // At the pixel last returned from, the blobs already returned from it are
+  // done, and so is any that sorts before the last of them
+  const TBOX box = entry.blob->bounding_box();
+  if(newBlobs.find(entry.blob) == newBlobs.end()) {
+    return std::find(lastStepReturns.begin(), lastStepReturns.end(),
+        entry.blob) == lastStepReturns.end()
+        && compareBoxes(box, lastBox) >= 0;
+  }
+  // A blob inserted since is only reached if GridSearch's iterator hadn't
+  // run off the end of the pixel's list yet and it went in after the
+  // iterator, or at the start of the list (which the iterator gets back
+  // around to last)
+  if(lastNext == NULL) {
+    return false;
+  }
+  if(compareBoxes(box, lastNext->bounding_box()) >= 0) {
+    return true;
+  }
+  entry.wrapped = compareBoxes(box, lastFirst->bounding_box()) < 0;
+  return entry.wrapped;
+}
+
+void BlobDataGridSearch::refreshBand() {
+  if(bandEnd == 0) {
+    // no band yet, the first one will see everything
+    bandInsertions = grid->insertions.size();
+    return;
+  }
+  newBlobs.clear();
+  newBlobs.insert(grid->insertions.begin() + bandInsertions,
+      grid->insertions.end());
+  lastFirst = NULL;
+  lastNext = NULL;
+  int x, y;
+  if(!newBlobs.empty() && stepPixel(lastStep, &x, &y)) {
+    int cellX, cellY;
+    pixelCell(x, y, &cellX, &cellY);
+    BlobData_C_IT it(grid->getCell(cellX, cellY));
+    for(it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
+      BlobData* const blob = it.data();
+      if(newBlobs.find(blob) != newBlobs.end() || !coversPixel(blob, x, y)) {
+        continue;
+      }
+      if(lastFirst == NULL) {
+        lastFirst = blob;
+      }
+      const int order = compareBoxes(blob->bounding_box(), lastBox);
+      if(order > 0 || (order == 0 && std::find(lastStepReturns.begin(),
+          lastStepReturns.end(), blob) == lastStepReturns.end())) {
+        lastNext = blob;
+        break;
+      }
+    }
+  }
+  fillBand(lastStep);
+  newBlobs.clear();
+}
+
+bool BlobDataGridSearch::stepPixel(const long long& step, int* pixelX,
+    int* pixelY) const {
+  if(step < 0) {
+    return false;
+  }
+  if(searchType == RAD_SEARCH) {
+    const int ring = bandStart;
+    if(ring == 0) {
+      *pixelX = xOrigin;
+      *pixelY = yOrigin;
+      return step == 0;
+    }
+    const long long ringStart = 1 + 2 * (long long)ring * (ring - 1);
+    if(step < ringStart || step >= ringStart + 4 * (long long)ring) {
+      return false;
+    }
+    const int dir = (int)((step - ringStart) / ring);
+    const int index = (int)((step - ringStart) % ring);
+    ICOORD offset = C_OUTLINE::chain_step(dir);
+    offset *= ring - index;
+    offset += C_OUTLINE::chain_step(dir + 1) * index;
+    *pixelX = xOrigin + offset.x();
+    *pixelY = yOrigin + offset.y();
+    return true;
+  }
+  const long long line = step / lineLength;
+  const int pos = (int)(step % lineLength);
+  if(line < bandStart || line >= bandEnd) {
+    return false;
+  }
+  if(searchType == SIDE_SEARCH) {
+    *pixelX = xOrigin + lineDir * (int)line;
+    *pixelY = yOrigin - pos;
+  } else {
+    *pixelX = xOrigin + pos;
+    *pixelY = yOrigin + lineDir * (int)line;
+  }
+  return *pixelX >= 0 && *pixelX < pixelGridWidth
+      && *pixelY >= 0 && *pixelY < pixelGridHeight;
+}
+
+bool BlobDataGridSearch::coversPixel(BlobData* const blob,
+    const int& pixelX, const int& pixelY) const {
+  const TBOX box = blob->bounding_box();
+  int left, bottom, right, top;
+  pixelCoords(box.left(), box.bottom(), &left, &bottom);
+  pixelCoords(box.right(), box.top(), &right, &top);
+  return left <= pixelX && pixelX <= right
+      && bottom <= pixelY && pixelY <= top;
+}
+
+void BlobDataGridSearch::pixelCoords(const int& x, const int& y,
+    int* pixelX, int* pixelY) const {
+  *pixelX = ClipToRange(x - grid->bleft().x(), 0, pixelGridWidth - 1);
+  *pixelY = ClipToRange(y - grid->bleft().y(), 0, pixelGridHeight - 1);
+}
+
+void BlobDataGridSearch::pixelCell(const int& pixelX, const int& pixelY,
+    int* cellX, int* cellY) const {
+  grid->GridCoords(pixelX + grid->bleft().x(), pixelY + grid->bleft().y(),
+      cellX, cellY);
+}
@@ -8,6 +8,7 @@
 #ifndef BLOBDATAGRID_H_
 #define BLOBDATAGRID_H_
 
+#include <set>
 #include <string>
 #include <vector>
 #include <baseapi.h>
@@ -24,10 +25,11 @@ class TesseractSentenceData;
 class BlobMergeData;
 class Segmentation;
 class MathExpressionFinderResults;
+class FeatureMatrix;
 
 class BlobData;
 CLISTIZEH(BlobData)
-typedef tesseract::GridSearch<BlobData, BlobData_CLIST, BlobData_C_IT> BlobDataGridSearch;
+class BlobDataGridSearch;
 
 class BlobDataGrid : public tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData_C_IT> {
  public:
@@ -47,6 +49,10 @@ class BlobDataGrid : public tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData
 
   Pix* getBinaryImage();
 
+  // Sets the image after being thresholded by Tesseract (the grid takes
+  // ownership of it)
+  void setBinaryImage(Pix* const binaryImage);
+
   std::string getImageName();
 
   tesseract::TessBaseAPI* getTessBaseAPI();
@@ -69,6 +75,18 @@ class BlobDataGrid : public tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData
   double getNonItalicizedRatio();
   void setNonItalicizedRatio(double nonItalicizedRatio);
 
+  /**
+   * Gets the features extracted from the blobs on this page, a row per blob
+   * (NULL until features have been extracted). Each blob knows its own row.
+   */
+  FeatureMatrix* getFeatureMatrix();
+
+  /**
+   * Hands the grid the features extracted from its blobs. The grid owns the
+   * matrix from then on (any it already had is deleted).
+   */
+  void setFeatureMatrix(FeatureMatrix* const featureMatrix);
+
   /**
    * Appends a segmentation to this grid's list of segmentations
    */
@@ -147,11 +165,29 @@ class BlobDataGrid : public tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData
 
   void HandleClick(int x, int y);
 
+  /**
+   * Area of the page covered by the grid in pixels
+   */
   int getArea();
 
+  /**
+   * Same as BBGrid's, but also records the insertion so that a
+   * BlobDataGridSearch in progress knows to pick up the new blob
+   */
+  void InsertBBox(bool h_spread, bool v_spread, BlobData* bbox);
+
  private:
 
-  tesseract::TessBaseAPI* tessBaseAPI; // the api this grid relies on
+  friend class BlobDataGridSearch;
+
+  // The list of blobs in the grid cell at the given grid coordinates
+  BlobData_CLIST* getCell(const int& gridX, const int& gridY);
+
+  // every blob inserted so far, in the order they were inserted (searches
+  // use it to tell which blobs are new since they last looked at the grid)
+  std::vector<BlobData*> insertions;
+
+  tesseract::TessBaseAPI* tessBaseAPI; // the api this grid relies on (for dictionary lookups)
 
   Pix* image; // the document image used as input to generate this grid (not owned by the grid)
 
@@ -175,6 +211,9 @@ class BlobDataGrid : public tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData
   // tesseract recognition results
   double nonItalicizedRatio;
 
+  // features extracted from each of the blobs (owned by the grid)
+  FeatureMatrix* featureMatrix;
+
   // results of segmentation. each segment owned by first blob that has a reference
   // to it that is deleted from the grid. The results thus needs to create a copy
   // of this to avoid memory issues.
@@ -183,5 +222,195 @@ class BlobDataGrid : public tesseract::BBGrid<BlobData, BlobData_CLIST, BlobData
   int area;
 };
 
+/**
+ * Searches a BlobDataGrid the same way as Tesseract's GridSearch does, except
+ * that the blobs are returned in exactly the order (and with exactly the
+ * duplicates when not in unique mode) that a GridSearch would return them
+ * from a grid with 1 pixel cells, whatever the grid's actual cell size is.
+ * All of the feature extractors and the segmentation were written against
+ * 1 pixel cells, so this lets the grid use cells around the size of a
+ * character (far fewer lists to allocate and walk) without changing any of
+ * their results.
+ *
+ * Every search walks lines of 1 pixel cells (rows, or columns for the side
+ * search, and rings for the radius search), and the lines are taken a band
+ * at a time, a band being all of the search's lines that fall in one row (or
+ * column) of real cells. Each blob in the band's real cells is looked at
+ * once, and an entry is made for each of the search's pixels its (clipped)
+ * box covers (only the first one in unique mode), which are then sorted into
+ * the order GridSearch would have visited them in. Within a pixel the blobs
+ * keep the order of the real cell's list, which is sorted the same way as a
+ * 1 pixel cell's would be. The full search only makes an entry for the pixel
+ * each blob's box starts in.
+ *
+ * Blobs inserted into the grid part way through a search are returned from
+ * the pixels the search hasn't reached yet, and from the current pixel only
+ * where GridSearch's iterator over the pixel's list would still get to them,
+ * so inserting as a search goes returns the same blobs GridSearch would.
+ */
+class BlobDataGridSearch {
+ public:
+
+  BlobDataGridSearch(BlobDataGrid* const grid);
+
+  /**
+   * In unique mode each blob is returned at most once per search (the full
+   * search always returns each blob once).
+   */
+  void SetUniqueMode(bool mode);
+  bool GetUniqueMode() const;
+
+  /**
+   * Returns every blob in the grid, from the top of the page down and left
+   * to right by their bottom left corner.
+   */
+  void StartFullSearch();
+  BlobData* NextFullSearch();
+
+  /**
+   * Searches the (diamond shaped) rings of pixels around x,y out to
+   * max_radius.
+   */
+  void StartRadSearch(int x, int y, int max_radius);
+  BlobData* NextRadSearch();
+
+  /**
+   * Searches to the side of x for blobs that vertically overlap a strip
+   * twice the height of ymin to ymax (measured down from ymax).
+   */
+  void StartSideSearch(int x, int ymin, int ymax);
+  BlobData* NextSideSearch(bool right_to_left);
+
+  /**
+   * Searches up or down from y for blobs that horizontally overlap
+   * xmin to xmax.
+   */
+  void StartVerticalSearch(int xmin, int xmax, int y);
+  BlobData* NextVerticalSearch(bool top_to_bottom);
+
+  /**
+   * Searches for blobs overlapping the rectangle (left to right, top to
+   * bottom).
+   */
+  void StartRectSearch(const TBOX& rect);
+  BlobData* NextRectSearch();
+
+  /**
+   * Removes the last blob returned from the grid without invalidating this
+   * search. Other searches on the same grid must be restarted.
+   */
+  void RemoveBBox();
+
+ private:
+
+  enum SearchType {
+    FULL_SEARCH,
+    RAD_SEARCH,
+    SIDE_SEARCH,
+    VERTICAL_SEARCH,
+    RECT_SEARCH
+  };
+
+  // A blob along with when the search reaches the pixel it's returned from
+  struct SearchEntry {
+    long long step;
+    BlobData* blob;
+    // inserted at the start of the list of the pixel being searched, which
+    // GridSearch only gets to after the rest of the pixel's blobs
+    bool wrapped;
+    // by step, then in the order of a grid cell's list
+    bool operator<(const SearchEntry& other) const;
+  };
+
+  // Shared by all the starts, x and y are in image coordinates (the start
+  // then sets the line length and number of lines)
+  void commonStart(const SearchType& type, const int& x, const int& y);
+
+  // Shared by all the nexts once the search has run out
+  BlobData* commonEnd();
+
+  // The next entry's blob (or NULL once the search has run out), moving on
+  // to the next band as needed
+  BlobData* nextEntry();
+
+  // Whether the line (or ring) is part of the search and, if so, the row
+  // (or column) of real cells it's in
+  bool lineInSearch(const int& line) const;
+  int lineCell(const int& line) const;
+
+  // Makes the entries for the current band, leaving out any before minStep
+  void fillBand(const long long& minStep);
+
+  // Makes the entries for one blob in the band
+  void addEntries(BlobData* const blob, const long long& minStep);
+
+  // Whether the entry comes after minStep, or is at it (which is where the
+  // last entry was returned from) but hasn't been searched yet
+  bool searchesPixel(SearchEntry& entry, const long long& minStep) const;
+
+  // The 1 pixel cell the current band reaches at the given step, false if
+  // the step isn't in the band
+  bool stepPixel(const long long& step, int* pixelX, int* pixelY) const;
+
+  // Whether the blob's (clipped) box covers the 1 pixel cell
+  bool coversPixel(BlobData* const blob, const int& pixelX,
+      const int& pixelY) const;
+
+  // Rebuilds the rest of the current band after the grid has changed
+  void refreshBand();
+
+  // Image coordinates to the coordinates of the 1 pixel cell holding them
+  void pixelCoords(const int& x, const int& y, int* pixelX, int* pixelY) const;
+
+  // The real cell holding the given 1 pixel cell
+  void pixelCell(const int& pixelX, const int& pixelY, int* cellX,
+      int* cellY) const;
+
+  BlobDataGrid* grid;
+
+  // Size of the page in 1 pixel cells
+  int pixelGridWidth;
+  int pixelGridHeight;
+
+  bool uniqueMode;
+  std::set<BlobData*> returns; // already returned in unique mode
+  BlobData* previousReturn;
+
+  // The search's lines, each lineLength pixels long. The search ends after
+  // numLines of them or, if numLines is negative, at the edge of the page.
+  // Line i, position j is the pixel at
+  // xOrigin + j, yOrigin + lineDir * i for the searches that go by rows and
+  // at xOrigin + lineDir * i, yOrigin - j for the side search. Pixel j of the
+  // radius search's ring i is found the same way GridSearch finds it.
+  SearchType searchType;
+  int xOrigin;
+  int yOrigin;
+  int lineDir;
+  int lineLength;
+  int numLines;
+  TBOX rect;
+
+  // The band being searched (lines bandStart up to bandEnd), its entries in
+  // the order they're returned, and the next entry to return
+  int bandStart;
+  int bandEnd;
+  std::vector<SearchEntry> band;
+  int bandIndex;
+  int bandInsertions; // how many blobs had been inserted when the band was made
+
+  // Where the last entry was returned from along with the blobs returned
+  // from that pixel so far
+  long long lastStep;
+  TBOX lastBox;
+  std::vector<BlobData*> lastStepReturns;
+
+  // While the band is being remade, the blobs inserted since it was last
+  // made, along with the first of the older blobs in the last pixel and the
+  // one after the last returned from it (where GridSearch's iterator was)
+  std::set<BlobData*> newBlobs;
+  BlobData* lastFirst;
+  BlobData* lastNext;
+};
+
 
 #endif /* BLOBDATAGRID_H_ */
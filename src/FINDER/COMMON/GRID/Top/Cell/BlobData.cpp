@@ -13,6 +13,7 @@
 #include <RowData.h>
 #include <BlockData.h>
 #include <M_Utils.h>
+#include <FeatureMatrix.h>
 
 BlobData::BlobData(TBOX box, PIX* blobImage, BlobDataGrid* parentGrid)
     : mathExpressionDetectionResult(false),
@@ -22,7 +23,8 @@ BlobData::BlobData(TBOX box, PIX* blobImage, BlobDataGrid* parentGrid)
       markedForDeletion(false),
       inBadRegion(false),
       badRegionKnown(false),
-      mergeData(NULL) {
+      mergeData(NULL),
+      featureRow(-1) {
   this->box = box;
   this->blobImage = blobImage;
   this->parentGrid = parentGrid;
@@ -143,14 +145,15 @@ const TBOX& BlobData::getBoundingBox() const {
 }
 
 /**
- * Appends the provided vector of features to this blob entry's array
- * of features. Once finalized, this array should contain one or more
- * features for all feature extractions that were carried out.
+ * Sets the row of the parent grid's FeatureMatrix holding the features
+ * extracted from this blob.
  */
-void BlobData::appendExtractedFeatures(std::vector<DoubleFeature*> extractedFeatures_) {
-  for(int i = 0; i < extractedFeatures_.size(); ++i) {
-    this->extractedFeatures.push_back(extractedFeatures_[i]);
-  }
+void BlobData::setFeatureRow(const int& featureRow) {
+  this->featureRow = featureRow;
+}
+
+int BlobData::getFeatureRow() {
+  return featureRow;
 }
 
 /**
@@ -168,8 +171,18 @@ bool BlobData::getMathExpressionDetectionResult() {
   return mathExpressionDetectionResult;
 }
 
-std::vector<DoubleFeature*> BlobData::getExtractedFeatures() {
-  return extractedFeatures;
+const double* BlobData::getExtractedFeatures() {
+  if(featureRow < 0 || parentGrid->getFeatureMatrix() == NULL) {
+    return NULL;
+  }
+  return parentGrid->getFeatureMatrix()->getRow(featureRow);
+}
+
+int BlobData::getNumExtractedFeatures() {
+  if(featureRow < 0 || parentGrid->getFeatureMatrix() == NULL) {
+    return 0;
+  }
+  return parentGrid->getFeatureMatrix()->getNumColumns();
 }
 
 bool BlobData::belongsToRecognizedWord() {
@@ -238,10 +251,7 @@ float BlobData::getAverageWordConfInRow() {
   float total = 0;
   for(int i = 0; i < row->getTesseractWords().size(); ++i) {
     TesseractWordData* const word = row->getTesseractWords()[i];
-    if(word->bestchoice() == NULL) {
-      continue;
-    }
-    sum += word->bestchoice()->certainty();
+    sum += word->getCertainty();
     ++total;
   }
   getParentRow()->setAvgWordConf(sum / total);
@@ -343,11 +353,10 @@ float BlobData::getCharRecognitionConfidence() {
   if(charData == NULL) {
     return minTesseractCertainty;
   }
-  BLOB_CHOICE* info = charData->getCharResultInfo();
-  if(info == NULL) {
+  if(!charData->hasCertainty()) {
     return minTesseractCertainty;
   }
-  return info->certainty();
+  return charData->getCertainty();
 }
 
 /**
@@ -359,13 +368,9 @@ float BlobData::getWordRecognitionConfidence() {
   if(wordData == NULL) {
     return minTesseractCertainty;
   }
-  WERD_CHOICE* const info = getParentWord()->bestchoice();
-  if(info == NULL) {
-    return minTesseractCertainty;
-  }
   // returns the worst certainty of the individual
   // blobs in the word (as defined by Tesseract)
-  return info->certainty();
+  return wordData->getCertainty();
 }
 
 float BlobData::getWordAvgRecognitionConfidence() {
@@ -377,24 +382,20 @@ float BlobData::getWordAvgRecognitionConfidence() {
   }
   std::vector<TesseractCharData*> childChars = wordData->getChildChars();
   for(int i = 0; i < childChars.size(); ++i) {
-    BLOB_CHOICE* charResInfo = childChars[i]->getCharResultInfo();
-    if(charResInfo == NULL) {
+    if(!childChars[i]->hasCertainty()) {
       continue;
     }
-    avg += charResInfo->certainty();
+    avg += childChars[i]->getCertainty();
     ++total;
   }
   return avg/total;
 }
 
-FontInfo* BlobData::getFontInfo() {
+bool BlobData::isItalic() {
   if(getParentWord() == NULL) {
-    return NULL;
-  }
-  if(getParentWord()->getWordRes() == NULL) {
-    return NULL;
+    return false;
   }
-  return (FontInfo*)getParentWord()->getWordRes()->fontinfo;
+  return getParentWord()->getIsItalic();
 }
 
 // Markers solely for during grid creation stage and/or debugging
@@ -91,10 +91,18 @@ class BlobData: public ELIST_LINK {
 
   /**
    * Gets the features extracted by all feature extractors that
-   * were run on this blob. There should be no need to call this
-   * method until all of the desired feature extractors have been run.
+   * were run on this blob (this blob's row in the parent grid's
+   * FeatureMatrix). There should be no need to call this method
+   * until all of the desired feature extractors have been run.
+   * Returns NULL if no features have been extracted.
    */
-  std::vector<DoubleFeature*> getExtractedFeatures();
+  const double* getExtractedFeatures();
+
+  /**
+   * Gets the number of features returned by getExtractedFeatures()
+   * (0 if no features have been extracted)
+   */
+  int getNumExtractedFeatures();
 
   /**
    * Gets the size of the variable data vector
@@ -121,11 +129,11 @@ class BlobData: public ELIST_LINK {
   int appendNewVariableData(BlobFeatureExtractionData* const data);
 
   /**
-   * Appends the provided vector of features to this blob entry's array
-   * of features. Once finalized, this array should contain features for
-   * all feature extractions that were carried out.
+   * Sets the row of the parent grid's FeatureMatrix holding the features
+   * extracted from this blob.
    */
-  void appendExtractedFeatures(std::vector<DoubleFeature*> features);
+  void setFeatureRow(const int& featureRow);
+  int getFeatureRow();
 
   /**
    * Returns reference to an immutable version of this blob's bounding box
@@ -244,10 +252,9 @@ class BlobData: public ELIST_LINK {
   float getWordAvgRecognitionConfidence();
 
   /**
-   * Gets font info from the parent if that info exists.
-   * If not returns NULL.
+   * True if Tesseract found the font of the parent word and it's italic.
    */
-  FontInfo* getFontInfo();
+  bool isItalic();
 
   // Markers solely for during grid creation stage and/or debugging
   void markForDeletion();
@@ -270,15 +277,12 @@ class BlobData: public ELIST_LINK {
   // Based on feature extractor used, each entry is cast to its class type
   std::vector<BlobFeatureExtractionData*> variableExtractionData;
 
-  // This blob entry's array of extracted features. There should be at least
-  // one entry for each feature extractor run on this blob (some feature extractors
-  // extract more than one feature).
-  // WARNING: This is only to be modified from the main feature extractor. The
-  //          blob feature extractors should never modify this data. They must add
-  //          their features to blob's data entry which they create. The main feature
-  //          extractor pulls the features out of each of those and compiles them into
-  //          a complete list that is sent into the binary classification.
-  std::vector<DoubleFeature*> extractedFeatures;
+  // This blob entry's row in the parent grid's FeatureMatrix (-1 until features
+  // are extracted). There's at least one column for each feature extractor run on
+  // this blob (some feature extractors extract more than one feature).
+  // WARNING: This is only to be set from the main feature extractor, which hands
+  //          each blob feature extractor its columns of this row to fill in.
+  int featureRow;
 
   bool mathExpressionDetectionResult;
 
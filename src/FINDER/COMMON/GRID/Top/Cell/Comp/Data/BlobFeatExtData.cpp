@@ -9,18 +9,4 @@
 
 BlobFeatureExtractionData::BlobFeatureExtractionData() {}
 
-std::vector<DoubleFeature*> BlobFeatureExtractionData::getExtractedFeatures() {
-  return extractedFeatures;
-}
-
-BlobFeatureExtractionData::~BlobFeatureExtractionData() {
-  for(int i = 0; i < extractedFeatures.size(); ++i) {
-    delete extractedFeatures[i];
-  }
-}
-
-void BlobFeatureExtractionData::appendExtractedFeature(DoubleFeature* const feature) {
-  extractedFeatures.push_back(feature);
-}
-
-
+BlobFeatureExtractionData::~BlobFeatureExtractionData() {}
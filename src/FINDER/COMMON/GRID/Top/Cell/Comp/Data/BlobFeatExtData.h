@@ -8,29 +8,19 @@
 #ifndef BLOBFEATUREEXTRACTIONDATA_H_
 #define BLOBFEATUREEXTRACTIONDATA_H_
 
-#include <vector>
-#include <DoubleFeature.h>
-
 /**
  * Base class overridden by any feature extractor for
- * storing its extracted features and optionally other data into
- * a blob. The extracted data for a blob is stored within the
- * blob's grid entry as an object overriding this type
+ * storing data it extracted from a blob into that blob (the
+ * features themselves go in the page's FeatureMatrix). The
+ * extracted data for a blob is stored within the blob's grid
+ * entry as an object overriding this type
  */
 class BlobFeatureExtractionData {
  public:
 
   BlobFeatureExtractionData();
 
-  std::vector<DoubleFeature*> getExtractedFeatures();
-
   ~BlobFeatureExtractionData();
-
-  void appendExtractedFeature(DoubleFeature* const feature);
-
- private:
-
-  std::vector<DoubleFeature*> extractedFeatures;
 };
 
 
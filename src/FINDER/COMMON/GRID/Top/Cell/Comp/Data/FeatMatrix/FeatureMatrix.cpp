@@ -0,0 +1,41 @@
+/*
+ * FeatureMatrix.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <FeatureMatrix.h>
+
+#include <vector>
+#include <assert.h>
+
+FeatureMatrix::FeatureMatrix(const int& numRows, const int& numColumns) {
+  assert(numRows >= 0 && numColumns > 0);
+  this->numRows = numRows;
+  this->numColumns = numColumns;
+  this->rowStride = (numColumns + 3) & ~3;
+  features.assign(numRows * rowStride, (double)0);
+}
+
+int FeatureMatrix::getNumRows() const {
+  return numRows;
+}
+
+int FeatureMatrix::getNumColumns() const {
+  return numColumns;
+}
+
+int FeatureMatrix::getRowStride() const {
+  return rowStride;
+}
+
+double* FeatureMatrix::getRow(const int& row) {
+  assert(row >= 0 && row < numRows);
+  return &features[row * rowStride];
+}
+
+const double* FeatureMatrix::getRow(const int& row) const {
+  assert(row >= 0 && row < numRows);
+  return &features[row * rowStride];
+}
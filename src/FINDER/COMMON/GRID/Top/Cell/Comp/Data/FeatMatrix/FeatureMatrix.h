@@ -0,0 +1,57 @@
+/*
+ * FeatureMatrix.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef FEATUREMATRIX_H_
+#define FEATUREMATRIX_H_
+
+#include <vector>
+
+/**
+ * Holds the features extracted from every blob on a page as one contiguous
+ * block of doubles, a row per blob and a column per feature, rather than as
+ * a heap allocated object per feature. Each blob feature extractor writes
+ * straight into its own columns of the blob's row and the detector reads
+ * whole rows back out. Rows are padded with zeros out to a multiple of 4
+ * doubles (the same as the SVM batch scorer's rows) so that a row can be
+ * handed to the scorer as is. The column order is the order the extractors
+ * were given to the MathExpressionFeatureExtractor in, and within an
+ * extractor the order its flags were enabled in.
+ */
+class FeatureMatrix {
+ public:
+
+  /**
+   * Allocates a matrix of the given dimensions with every feature set to 0
+   */
+  FeatureMatrix(const int& numRows, const int& numColumns);
+
+  int getNumRows() const;
+
+  int getNumColumns() const;
+
+  /**
+   * Number of doubles between the start of one row and the next
+   */
+  int getRowStride() const;
+
+  /**
+   * Gets the first feature in the given row
+   */
+  double* getRow(const int& row);
+  const double* getRow(const int& row) const;
+
+ private:
+
+  int numRows;
+  int numColumns;
+  int rowStride;
+
+  std::vector<double> features;
+};
+
+
+#endif /* FEATUREMATRIX_H_ */
@@ -0,0 +1,142 @@
+/*
+ * NGramIndex.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <NGramIndex.h>
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <utility>
+#include <vector>
+#include <string.h>
+#include <assert.h>
+
+NGramProfileIndex::NGramProfileIndex(const RankedNGramVecs& profile) {
+  assert(profile.length() == maxGram);
+
+  // intern every word in the profile first
+  for(int i = 0; i < maxGram; ++i) {
+    for(int j = 0; j < profile[i].length(); ++j) {
+      const GenericVector<char*>& ngramWords = profile[i][j]->ngram->words;
+      for(int k = 0; k < ngramWords.length(); ++k) {
+        addWord(ngramWords[k]);
+      }
+    }
+  }
+  if(words.size() >= ((size_t)1 << bitsPerWord) - 1) {
+    std::cout << "ERROR: The n-gram profile has too many distinct words ("
+        << words.size() << ") to be indexed.\n";
+    assert(false);
+  }
+
+  for(int i = 0; i < maxGram; ++i) {
+    const RankedNGramVec& ranked = profile[i];
+    topFrequencies[i] = ranked.empty() ? 0 : ranked[0]->frequency;
+    for(int j = 0; j < ranked.length(); ++j) {
+      addNGram(i + 1, ranked[j]->ngram, ranked[j]->frequency);
+    }
+  }
+}
+
+void NGramProfileIndex::addWord(const char* const word) {
+  const std::string wordStr(word);
+  if(wordIds.insert(std::make_pair(wordStr, (int)words.size())).second) {
+    words.push_back(wordStr);
+  }
+}
+
+void NGramProfileIndex::addNGram(const int& gram, NGram* const ngram,
+    const double& frequency) {
+  assert(ngram->words.length() == gram);
+  int ids[maxGram];
+  for(int i = 0; i < gram; ++i) {
+    ids[i] = findWord(ngram->words[i], strlen(ngram->words[i]));
+    assert(ids[i] >= 0);
+  }
+  // keeps the first one if it's already there from higher up in the ranking
+  frequencies[gram - 1].insert(std::make_pair(makeKey(ids, gram), frequency));
+}
+
+int NGramProfileIndex::findWord(const char* const word,
+    const int& length) const {
+  return findWord(std::string(word, length));
+}
+
+int NGramProfileIndex::findWord(const std::string& word) const {
+  const std::map<std::string, int>::const_iterator found =
+      wordIds.find(word);
+  return found == wordIds.end() ? -1 : found->second;
+}
+
+const std::string& NGramProfileIndex::getWord(const int& wordId) const {
+  assert(wordId >= 0 && wordId < words.size());
+  return words[wordId];
+}
+
+int NGramProfileIndex::getNumWords() const {
+  return words.size();
+}
+
+NGramKey NGramProfileIndex::makeKey(const int* const wordIds,
+    const int& gram) {
+  assert(gram > 0 && gram <= maxGram);
+  NGramKey key = 0;
+  for(int i = 0; i < gram; ++i) {
+    assert(wordIds[i] >= 0);
+    key = (key << bitsPerWord) | (NGramKey)(wordIds[i] + 1);
+  }
+  return key;
+}
+
+std::string NGramProfileIndex::keyToString(const NGramKey& key) const {
+  const NGramKey wordMask = (((NGramKey)1) << bitsPerWord) - 1;
+  std::string ngram = "";
+  for(NGramKey rest = key; rest != 0; rest >>= bitsPerWord) {
+    const std::string& word = getWord((int)(rest & wordMask) - 1);
+    ngram = ngram.empty() ? word : (word + " " + ngram);
+  }
+  return ngram;
+}
+
+double NGramProfileIndex::findFrequency(const int& gram,
+    const NGramKey& key) const {
+  assert(gram > 0 && gram <= maxGram);
+  const std::map<NGramKey, double>& grams = frequencies[gram - 1];
+  const std::map<NGramKey, double>::const_iterator found = grams.find(key);
+  return found == grams.end() ? 0 : found->second;
+}
+
+double NGramProfileIndex::getTopFrequency(const int& gram) const {
+  assert(gram > 0 && gram <= maxGram);
+  return topFrequencies[gram - 1];
+}
+
+int NGramTable::insert(NGram* const ngram, const int& index) {
+  assert(ngram != NULL && index >= 0);
+  return indices.insert(std::make_pair(ngram, index)).first->second;
+}
+
+int NGramTable::find(NGram* const ngram) const {
+  const std::map<NGram*, int, NGramLess>::const_iterator found =
+      indices.find(ngram);
+  return found == indices.end() ? -1 : found->second;
+}
+
+// compares word by word, a shorter n-gram coming before a longer one that
+// starts with the same words
+bool NGramTable::NGramLess::operator()(NGram* const ngram1,
+    NGram* const ngram2) const {
+  const int length1 = ngram1->words.length();
+  const int length2 = ngram2->words.length();
+  for(int i = 0; i < length1 && i < length2; ++i) {
+    const int cmp = strcmp(ngram1->words[i], ngram2->words[i]);
+    if(cmp != 0) {
+      return cmp < 0;
+    }
+  }
+  return length1 < length2;
+}
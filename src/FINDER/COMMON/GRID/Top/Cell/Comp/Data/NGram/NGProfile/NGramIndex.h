@@ -0,0 +1,136 @@
+/*
+ * NGramIndex.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef NGRAMINDEX_H_
+#define NGRAMINDEX_H_
+
+#include <NGram.h>
+
+#include <host.h>
+
+#include <string>
+#include <map>
+#include <vector>
+
+// An n-gram of up to three words packed into one integer, each word being
+// stored as its id in an NGramProfileIndex plus one in its own 21 bits
+// (so 0 is never a valid key)
+typedef uinT64 NGramKey;
+
+// The keys of the n-grams found in a sentence, 3 vectors in the same order
+// as RankedNGramVecs (uni, bi, then tri grams). A key appears once for every
+// time its n-gram occurs in the sentence.
+typedef GenericVector<NGramKey> NGramKeyVec;
+typedef GenericVector<NGramKeyVec> NGramKeyVecs;
+
+/**
+ * Read-only lookup table compiled from a ranked uni, bi, and tri gram
+ * profile. Every word in the profile is interned to an integer id and each
+ * n-gram is keyed by the tuple of its word ids packed into one integer, so
+ * that looking up how often an n-gram appears in the profile is a
+ * logarithmic search comparing integers rather than a scan through the
+ * whole profile comparing strings. Nothing
+ * is modified after construction so one index can be shared between
+ * threads.
+ */
+class NGramProfileIndex {
+ public:
+
+  /**
+   * Builds the index from the given uni, bi, and tri gram profile (which
+   * is left as is and can be destroyed afterwards). If the same n-gram
+   * appears more than once in the profile then its first (highest ranked)
+   * frequency is the one that's kept.
+   */
+  NGramProfileIndex(const RankedNGramVecs& profile);
+
+  /**
+   * Returns the id of the word or -1 if it's not in any of the profile's
+   * n-grams (in which case no n-gram containing it can be in the profile)
+   */
+  int findWord(const char* const word, const int& length) const;
+  int findWord(const std::string& word) const;
+
+  const std::string& getWord(const int& wordId) const;
+
+  int getNumWords() const;
+
+  /**
+   * Packs the given word ids (all of which must be valid) into a key
+   */
+  static NGramKey makeKey(const int* const wordIds, const int& gram);
+
+  /**
+   * Gets the words of the key back out separated by spaces (the same way
+   * an NGram is printed)
+   */
+  std::string keyToString(const NGramKey& key) const;
+
+  /**
+   * Gets the frequency the n-gram had in the profile, or 0 if it isn't in it
+   */
+  double findFrequency(const int& gram, const NGramKey& key) const;
+
+  /**
+   * Gets the frequency of the top ranked n-gram in the profile (the first
+   * one) or 0 if the profile doesn't have any
+   */
+  double getTopFrequency(const int& gram) const;
+
+  static const int maxGram = 3;
+
+ private:
+
+  void addWord(const char* const word);
+
+  void addNGram(const int& gram, NGram* const ngram, const double& frequency);
+
+  static const int bitsPerWord = 21;
+
+  // interned words, a word's id is its index
+  std::vector<std::string> words;
+  std::map<std::string, int> wordIds;
+
+  // the profile frequency of each n-gram key, one map per gram
+  std::map<NGramKey, double> frequencies[maxGram];
+
+  double topFrequencies[maxGram];
+};
+
+/**
+ * Set of n-grams ordered by their words, used to find which of a set of
+ * n-grams a given one matches without comparing it against every one of
+ * them. Each distinct n-gram remembers the index it was first inserted with.
+ * The n-grams are not owned by the table and must outlive it.
+ */
+class NGramTable {
+ public:
+
+  /**
+   * Inserts the n-gram with the given index unless an equal n-gram is
+   * already in the table. Returns the index the n-gram ends up with (the
+   * given one if it was inserted, otherwise the equal n-gram's).
+   */
+  int insert(NGram* const ngram, const int& index);
+
+  /**
+   * Gets the index of the n-gram equal to the given one or -1 if there is
+   * none
+   */
+  int find(NGram* const ngram) const;
+
+ private:
+
+  // orders the n-grams by their words rather than by pointer
+  struct NGramLess {
+    bool operator()(NGram* const ngram1, NGram* const ngram2) const;
+  };
+
+  std::map<NGram*, int, NGramLess> indices;
+};
+
+#endif /* NGRAMINDEX_H_ */
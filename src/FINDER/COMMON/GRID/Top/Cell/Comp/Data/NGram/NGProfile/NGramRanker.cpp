@@ -21,6 +21,9 @@
 
 NGramRanker::NGramRanker(StopwordFileReader* stopwordHelper) {
   this->stopwordHelper = stopwordHelper;
+  // read the stop words in now so that they're only ever read from (never
+  // written to) once sentences are being processed in parallel
+  stopwordHelper->getStopwords();
 }
 
 NGramRanker::~NGramRanker() {}
@@ -41,26 +44,29 @@ std::string NGramRanker::getNGramFileName(const int& gram) {
   return ngramfile;
 }
 
-// This also writes the uni, bi, and tri -grams each to their own file in the
-// a directory called Cur-Sentence-NGrams/ which is in the given directory
+// The n-grams are found and counted in memory, only being written out (to
+// the same uni, bi, and tri -gram files and their -ranked counts that
+// rankNGrams reads and writes) if a debug directory is given
 RankedNGramVecs NGramRanker::generateSentenceNGrams(
     TesseractSentenceData* sentence,
-    const std::string& ngramdir) {
+    tesseract::TessBaseAPI* const api,
+    const std::string& debugdir) {
+  assert(api != NULL);
   RankedNGramVecs sentence_ngrams;
-  // initialize the filestreams used to write ngrams to files
-  std::ofstream ng_streams[3];
-  // initialize filestructure
-  std::string sentence_ngramdir = ngramdir + (std::string)"Cur-Sentence-NGrams/";
-  if(!Utils::existsDirectory(sentence_ngramdir))
-    Utils::exec("mkdir " + sentence_ngramdir);
-  else {
-    Utils::exec("rm -r " + sentence_ngramdir);
-    Utils::exec("mkdir " + sentence_ngramdir);
+  for(int gram = 1; gram <= 3; ++gram) {
+    GenericVector<NGram*> ngrams;
+    findNGrams(gram, sentence, api, ngrams);
+    if(!debugdir.empty()) {
+      writeNGrams(ngrams, debugdir + getNGramFileName(gram));
+    }
+    // count the frequency of each and sort by increasing frequency
+    RankedNGramVec ngramcounts = countNGramFrequencies(ngrams);
+    ngramcounts.sort(&sortcmp);
+    if(!debugdir.empty()) {
+      writeNGramCounts(ngramcounts, debugdir + getNGramFileName(gram));
+    }
+    sentence_ngrams.push_back(ngramcounts);
   }
-  GenericVector<TesseractSentenceData*> sentencevec;
-  sentencevec.push_back(sentence);
-  writeNGramFiles(sentencevec, sentence_ngramdir, ng_streams);
-  sentence_ngrams = rankNGrams(sentence_ngramdir);
   return sentence_ngrams;
 }
 
@@ -77,23 +83,25 @@ RankedNGramVecs NGramRanker::subtractAndReRankNGrams(RankedNGramVecs& mathngrams
 RankedNGramVec NGramRanker::subtractAndReRankNGram(int gram, RankedNGramVec& mathngrams,
     const RankedNGramVec& nonmathngrams, const std::string& mathdir,
     const double& nonmath_weight) {
+  // index the nonmath ngrams so each math ngram's match is found without
+  // comparing it against all of them
+  NGramTable nonmathtable;
+  for(int j = 0; j < nonmathngrams.length(); ++j) {
+    NGram* nonmath_ngram = nonmathngrams[j]->ngram;
+    assert(nonmath_ngram->words.length() == gram); // just to be safe
+    nonmathtable.insert(nonmath_ngram, j);
+  }
   // subtract matching (weighted) nonmath counts from math counts
   for(int i = 0; i < mathngrams.length(); ++i) {
     NGramFrequency* math_ngf = mathngrams[i];
     NGram* math_ngram = math_ngf->ngram;
-    // see if there's a matching one in the nonmathngrams vector
-    for(int j = 0; j < nonmathngrams.length(); ++j) {
-      NGramFrequency* nonmath_ngf = nonmathngrams[j];
-      NGram* nonmath_ngram = nonmath_ngf->ngram;
-      assert(math_ngram->words.length() == gram
-          && nonmath_ngram->words.length() == gram); // just to be safe
-      if(*math_ngram == *nonmath_ngram) {
-        // found match! decrement math frequency
-        math_ngf->frequency -= (nonmath_ngf->frequency * nonmath_weight);
-        if(math_ngf->frequency < 0)
-          math_ngf->frequency = 0;
-        break; // move on to next math ngram
-      }
+    assert(math_ngram->words.length() == gram); // just to be safe
+    const int j = nonmathtable.find(math_ngram);
+    if(j >= 0) {
+      // found match! decrement math frequency
+      math_ngf->frequency -= (nonmathngrams[j]->frequency * nonmath_weight);
+      if(math_ngf->frequency < 0)
+        math_ngf->frequency = 0;
     }
   }
   // rerank math based on updated counts
@@ -173,36 +181,21 @@ void NGramRanker::writeNGramCounts(const GenericVector<NGramFrequency*> ngfs,
 RankedNGramVec NGramRanker::countNGramFrequencies(
     const GenericVector<NGram*>& ngrams) {
   RankedNGramVec ngramcounts;
-  // first add shallow copies of each ngram to the vector, start
-  // each count at one
+  // the first occurrence of each ngram is kept (shallow copy) with a count
+  // of one, each later occurrence is found through the table, counted
+  // against the first, and deleted
+  NGramTable table;
   for(int i = 0; i < ngrams.length(); ++i) {
-    NGramFrequency* ngf = new NGramFrequency;
-    ngf->frequency = 1;
-    ngf->ngram = ngrams[i];
-    ngramcounts.push_back(ngf);
-  }
-  // now count each element while deleting all duplicates
-  for(int i = 0; i < ngramcounts.length(); ++i) {
-    NGramFrequency* cur_ngf = ngramcounts[i];
-    NGram* cur_ngram = ngramcounts[i]->ngram;
-    for(int j = i+1; j < ngramcounts.length(); ++j) {
-      NGram* other_ngram = ngramcounts[j]->ngram;
-      static int equalcount = 0;
-      if(*cur_ngram == *other_ngram) {
-        ++(cur_ngf->frequency); // increment count
-        // remove the duplicate from the vector
-        NGramFrequency* other_ngf = ngramcounts[j];
-        if(other_ngf != NULL) {
-          if(other_ngf->ngram != NULL) {
-            delete other_ngf->ngram;
-            other_ngf->ngram = NULL;
-          }
-          delete other_ngf;
-          other_ngf = NULL;
-        }
-        ngramcounts.remove(j);
-        --j; // need to decrement j to avoid skipping an index (everything shifted left)
-      }
+    const int index = table.insert(ngrams[i], ngramcounts.length());
+    if(index == ngramcounts.length()) {
+      NGramFrequency* ngf = new NGramFrequency;
+      ngf->frequency = 1;
+      ngf->ngram = ngrams[i];
+      ngramcounts.push_back(ngf);
+    }
+    else {
+      ++(ngramcounts[index]->frequency); // increment count
+      delete ngrams[i];
     }
   }
   return ngramcounts;
@@ -256,17 +249,17 @@ readNGramFile(const std::string& filepath, int gram) {
 
 void NGramRanker::writeNGramFiles(
     const GenericVector<TesseractSentenceData*>& sentences,
-    const std::string& path, std::ofstream* streams) {
+    const std::string& path, std::ofstream* streams,
+    tesseract::TessBaseAPI* const api) {
   for(int i = 1; i <= 3; ++i)
-    writeNGramFile(i, sentences, path, (streams+(i-1)));
+    writeNGramFile(i, sentences, path, (streams+(i-1)), api);
 }
 
-// TODO: Abstract n-gram detection functionality here away from this function so writing
-//       to the file is optional, not required. For now I'm just always writing to a file
-//       since it makes it easier to debug when debugging is necessary.
 void NGramRanker::writeNGramFile(const int& gram,
     const GenericVector<TesseractSentenceData*>& sentences,
-    const std::string& path, std::ofstream* stream) {
+    const std::string& path, std::ofstream* stream,
+    tesseract::TessBaseAPI* const api) {
+  assert(api != NULL);
   std::string filename = getNGramFileName(gram);
   std::string filepath = path + filename;
   stream->open(filepath.c_str(), std::ios_base::app);
@@ -275,132 +268,181 @@ void NGramRanker::writeNGramFile(const int& gram,
     assert(false);
   }
 
-  // Init a tesseract api for validating words
-  tesseract::TessBaseAPI api;
-  api.Init("/usr/local/share/", "eng");
+  writeNGramLines(gram, sentences, api, *stream);
+  stream->close();
+}
 
+void NGramRanker::writeNGramLines(const int& gram,
+    const GenericVector<TesseractSentenceData*>& sentences,
+    tesseract::TessBaseAPI* const api, std::ostream& out) {
+  assert(api != NULL);
   for(int i = 0; i < sentences.length(); ++i) {
-    char* s_txt = sentences[i]->sentence_txt;
-    GenericVector<char*> ngram; // holds 1, 2, or 3 strings
-    int wrdstart = 0;
-    int ngram_next_index = 0; // index of the end of an ngram's first word
-                              // the next ngram will start on the current
-                              // ngram's second word. So for instance, if
-                              // the sentence is "The boy went to school",
-                              // trigram 1 is: "The boy went", trigram 2
-                              // is: "boy went to", etc.
-    bool word_found = false;
-    for(int j = 0; j < strlen(s_txt); ++j) {
-      assert(s_txt[j] != '\0');
-      if(!word_found) { // looking for a word start
-        if(s_txt[j] == ' ' || s_txt[j] == '\n')
-          continue; // keep looking
-        else {
-          word_found = true;
-          wrdstart = j;
-          continue;
+    GenericVector<NGram*> ngrams;
+    findNGrams(gram, sentences[i], api, ngrams);
+    for(int j = 0; j < ngrams.length(); ++j) {
+      out << *(ngrams[j]) << "\n";
+      delete ngrams[j];
+    }
+  }
+}
+
+void NGramRanker::writeNGrams(const GenericVector<NGram*>& ngrams,
+    const std::string& filepath) {
+  std::ofstream fs(filepath.c_str());
+  if(!fs.is_open()) {
+    std::cout << "ERROR: Could not open " << filepath << " for writing!\n";
+    assert(false);
+  }
+  for(int i = 0; i < ngrams.length(); ++i) {
+    fs << *(ngrams[i]) << "\n";
+  }
+  fs.close();
+}
+
+void NGramRanker::findNGrams(const int& gram,
+    TesseractSentenceData* const sentence,
+    tesseract::TessBaseAPI* const api,
+    GenericVector<NGram*>& ngrams) {
+  const char* const s_txt = sentence->sentence_txt;
+  GenericVector<int> wordStarts;
+  GenericVector<int> wordLengths;
+  findSentenceWords(s_txt, wordStarts, wordLengths);
+
+  // put each word in the form it's kept in, NULL if it's not valid
+  GenericVector<char*> words;
+  std::string normalized;
+  for(int i = 0; i < wordStarts.length(); ++i) {
+    char* word = NULL;
+    if(normalizeWord(s_txt + wordStarts[i], wordLengths[i], gram, normalized)
+        && isValidWord(normalized, gram, api)) {
+      word = Utils::strCopy(normalized.c_str());
+    }
+    words.push_back(word);
+  }
+
+  // each n-gram starts on the previous one's second word. So for instance,
+  // if the sentence is "The boy went to school", trigram 1 is:
+  // "The boy went", trigram 2 is: "boy went to", etc. Any n-gram containing
+  // an invalid word is discarded.
+  for(int i = 0; i + gram <= words.length(); ++i) {
+    bool ngram_ok = true;
+    for(int k = i; k < i + gram; ++k) {
+      if(words[k] == NULL) {
+        ngram_ok = false;
+        break;
+      }
+    }
+    if(ngram_ok) {
+      NGram* const found = new NGram;
+      for(int k = i; k < i + gram; ++k) {
+        found->words.push_back(Utils::strCopy(words[k]));
+      }
+      ngrams.push_back(found);
+    }
+  }
+  for(int i = 0; i < words.length(); ++i) {
+    Utils::destroyStr(words[i]);
+  }
+}
+
+void NGramRanker::findNGramKeys(TesseractSentenceData* const sentence,
+    tesseract::TessBaseAPI* const api,
+    const NGramProfileIndex& profileIndex,
+    NGramKeyVecs& keys) {
+  assert(api != NULL);
+  const char* const s_txt = sentence->sentence_txt;
+  GenericVector<int> wordStarts;
+  GenericVector<int> wordLengths;
+  findSentenceWords(s_txt, wordStarts, wordLengths);
+
+  // the id of each word's uni-gram and bi/tri-gram forms (which only differ
+  // for operators and stop words), or -1 if no n-gram containing it can be
+  // in the profile. The dictionary is only consulted for words that are in
+  // the profile since the rest can't match anyway.
+  GenericVector<int> wordIds[2];
+  std::string normalized;
+  for(int i = 0; i < wordStarts.length(); ++i) {
+    for(int form = 0; form < 2; ++form) {
+      const int gram = form + 1;
+      int wordId = -1;
+      if(normalizeWord(s_txt + wordStarts[i], wordLengths[i], gram,
+          normalized)) {
+        wordId = profileIndex.findWord(normalized);
+        if(wordId >= 0 && !isValidWord(normalized, gram, api)) {
+          wordId = -1;
         }
       }
-      else { // looking for a word end
-        if(s_txt[j] == ' ' || s_txt[j] == '\n' || (j+1 == strlen(s_txt))) {
-          // found it! (either space, newline, or last character of sentence)
-          int wrdlen = j - wrdstart; // this excludes the last character (space or newline)
-          // include last character if on the last in the string and its not space or newline
-          if(j+1 == strlen(s_txt) && s_txt[j] != ' ' && s_txt[j] != '\n')
-            ++wrdlen;
-          char* word = new char[wrdlen + 1]; // +1 for null terminator
-          for(int k = 0; k < wrdlen; ++k)
-            word[k] = s_txt[wrdstart + k];
-          word[wrdlen] = '\0';
-          ngram.push_back(word);
-          int numgrams = ngram.length();
-          if(numgrams == gram) {
-            // first check all the words on the n-gram to make sure they are valid
-            // and also to convert all uppercase characters to lowercase
-            for(int k = 0; k < numgrams; ++k) {
-              word = ngram[k];
-              wrdlen = strlen(word);
-              // convert all uppercase letters in the word to lower-case!
-              for(int l = 0; l < wrdlen; ++l) {
-                char char_ = word[l];
-                if(isupper((int)char_))
-                  word[l] = (char)tolower((int)char_);
-              }
-              // discard any punctuation/numbers and if the word is nothing but
-              // punctuation/numbers then discard the whole word
-              char* original_wrd = Utils::strCopy(word);
-              int chars_removed = 0;
-              if(!(wrdlen == 1 && gram == 1 && (Utils::stringCompare(word, "=")
-              || Utils::stringCompare(word, "+")
-              || Utils::stringCompare(word, "-")
-              || Utils::stringCompare(word, "*")
-              || Utils::stringCompare(word, "/")))) {
-                for(int l = 0; l < wrdlen; ++l) {
-                  char char_ = original_wrd[l];
-                  if(isalpha((int)char_) == 0) {
-                    word = Utils::strRemoveChar(word, l - chars_removed);
-                    ++chars_removed;
-                  }
-                }
-              }
-              // discard any invalid word or any word on the stop word list
-              if(word != NULL) {
-                if(((api.IsValidWord(word) == 0)
-                    && !Utils::stringCompare(word, "=")
-                    && !Utils::stringCompare(word, "+")
-                    && !Utils::stringCompare(word, "-")
-                    && !Utils::stringCompare(word, "*")
-                    && !Utils::stringCompare(word, "/"))
-                    || (gram == 1 && stopwordHelper->isStopWord(word))) {
-                  Utils::destroyStr(word);
-                }
-              }
-              Utils::destroyStr(original_wrd); // finished using temporary copy
-              ngram[k] = word; // make sure the word in the ngram points at the right place!!
-            }
-            // make sure the ngram is still valid (invalid words would have been discarded)
-            bool ngram_ok = true;
-            for(int k = 0; k < numgrams; ++k) {
-              if(ngram[k] == NULL) {
-                ngram_ok = false;
-                break;
-              }
-            }
-            // ready to write the n-gram to the file (assuming it is valid)
-            if(ngram_ok) {
-              for(int k = 0; k < ngram.length(); ++k)
-                *stream << ngram[k]
-                        << ((k+1) != ngram.length() ? " " : "\n");
-            }
-            for(int k = 0; k < ngram.length(); ++k) {
-              char* w = ngram[k];
-              Utils::destroyStr(w);
-            }
-            ngram.clear();
-            if(gram != 1) {
-              assert(ngram_next_index > 0);
-              j = ngram_next_index; // go back to start of next ngram
-            }
-          }
-          else if(numgrams == 1)
-            ngram_next_index = j; // will go back to this once ngram is done
-          else if(numgrams > gram) {
-            std::cout << "ERROR: Too many words were written to an n-gram!\n";
-            assert(false);
-          }
-          word_found = false;
+      wordIds[form].push_back(wordId);
+    }
+  }
+
+  keys.clear();
+  for(int gram = 1; gram <= NGramProfileIndex::maxGram; ++gram) {
+    const GenericVector<int>& ids = wordIds[gram == 1 ? 0 : 1];
+    NGramKeyVec gramKeys;
+    for(int i = 0; i + gram <= ids.length(); ++i) {
+      bool ngram_ok = true;
+      for(int k = i; k < i + gram; ++k) {
+        if(ids[k] < 0) {
+          ngram_ok = false;
+          break;
         }
       }
+      if(ngram_ok) {
+        gramKeys.push_back(NGramProfileIndex::makeKey(&ids[i], gram));
+      }
+    }
+    keys.push_back(gramKeys);
+  }
+}
+
+// Words are separated by spaces and newlines. A word that starts on the
+// very last character of the text has never been counted as one.
+void NGramRanker::findSentenceWords(const char* const s_txt,
+    GenericVector<int>& wordStarts, GenericVector<int>& wordLengths) {
+  const int s_len = strlen(s_txt);
+  int wrdstart = -1;
+  for(int j = 0; j < s_len; ++j) {
+    const bool delimiter = (s_txt[j] == ' ' || s_txt[j] == '\n');
+    if(wrdstart < 0) { // looking for a word start
+      if(!delimiter)
+        wrdstart = j;
     }
-    // get rid of any left overs (i.e. if sentence ended while looking for more
-    // words for the n-gram which just get rid of the remainder).
-    for(int j = 0; j < ngram.length(); ++j) {
-      char* w = ngram[j];
-      delete [] w;
-      w = NULL;
+    else if(delimiter || j+1 == s_len) { // found the word's end
+      int wrdlen = j - wrdstart;
+      // include last character if on the last in the string and its not space or newline
+      if(!delimiter)
+        ++wrdlen;
+      wordStarts.push_back(wrdstart);
+      wordLengths.push_back(wrdlen);
+      wrdstart = -1;
     }
-    ngram.clear();
   }
-  stream->close();
 }
 
+bool NGramRanker::normalizeWord(const char* const word, const int& wrdlen,
+    const int& gram, std::string& normalized) {
+  normalized.clear();
+  // a lone operator is kept as is in a uni-gram
+  const bool keepAll = (wrdlen == 1 && gram == 1 && isOperator(word[0]));
+  for(int l = 0; l < wrdlen; ++l) {
+    char char_ = word[l];
+    // convert all uppercase letters in the word to lower-case!
+    if(isupper((int)char_))
+      char_ = (char)tolower((int)char_);
+    // discard any punctuation/numbers
+    if(keepAll || isalpha((int)char_) != 0)
+      normalized.push_back(char_);
+  }
+  return !normalized.empty();
+}
+
+bool NGramRanker::isValidWord(const std::string& word, const int& gram,
+    tesseract::TessBaseAPI* const api) {
+  const bool isOperatorWord = (word.length() == 1 && isOperator(word[0]));
+  if(api->IsValidWord(word.c_str()) == 0 && !isOperatorWord)
+    return false;
+  if(gram == 1 && stopwordHelper->isStopWord(word))
+    return false;
+  return true;
+}
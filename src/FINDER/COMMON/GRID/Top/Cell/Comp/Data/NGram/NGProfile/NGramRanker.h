@@ -19,8 +19,10 @@
 
 #include <SentenceData.h>
 #include <NGram.h>
+#include <NGramIndex.h>
 #include <StopwordHelper.h>
 #include <fstream>
+#include <ostream>
 
 class NGramRanker {
  public:
@@ -36,17 +38,44 @@ class NGramRanker {
   //    3. Trigram RankedNGramVec
   // The RankedNGramVec is a GenericVector<NGramFrequency*>
   // The NGramFrequency contains both the N-Gram as well as the number of
-  // times it appears in the sentence.
+  // times it appears in the sentence. Everything is done in memory, the
+  // n-grams and their counts are only written out to files for debugging
+  // if a directory (which must already exist) is given for them. Words are
+  // validated against the dictionary of the given (already initialized)
+  // api, normally the one the sentence was recognized with.
   RankedNGramVecs generateSentenceNGrams(
       TesseractSentenceData* sentence,
-      const std::string& ngramdir);
+      tesseract::TessBaseAPI* const api,
+      const std::string& debugdir="");
+
+  // Finds the uni, bi, and tri grams in the sentence the same way as
+  // generateSentenceNGrams does but, rather than copying each word out,
+  // gives each n-gram as the key of its words' ids in the profile index.
+  // Only the n-grams whose words are all in the profile are kept (any
+  // others can't be in it) and they're kept once for each time they occur.
+  // Words are validated against the dictionary of the given (already
+  // initialized) api.
+  void findNGramKeys(TesseractSentenceData* const sentence,
+      tesseract::TessBaseAPI* const api,
+      const NGramProfileIndex& profileIndex,
+      NGramKeyVecs& keys);
 
   static void destroyNGramVecs(RankedNGramVecs& vecs);
 
   // writes the uni, bi, and tri, grams for all of the sentences
-  // to their respective files under the given path
+  // to their respective files under the given path (words are validated
+  // against the dictionary of the given, already initialized, api)
   void writeNGramFiles(const GenericVector<TesseractSentenceData*>& sentences,
-      const std::string& path, std::ofstream* streams);
+      const std::string& path, std::ofstream* streams,
+      tesseract::TessBaseAPI* const api);
+
+  // writes the uni, bi, or tri grams (depending on the first argument) for
+  // all of the sentences to the given stream, one per line in the same form
+  // as writeNGramFiles writes them. the same ranker can be used to do this
+  // from several threads at once as long as each has its own api.
+  void writeNGramLines(const int& gram,
+      const GenericVector<TesseractSentenceData*>& sentences,
+      tesseract::TessBaseAPI* const api, std::ostream& out);
 
   // ranks the uni, bi, and tri grams located within the given path
   // assuming the grams each have their own separate file and are named
@@ -69,7 +98,42 @@ class NGramRanker {
   void writeNGramFile(
       const int& gram,
       const GenericVector<TesseractSentenceData*>& sentences,
-      const std::string& path, std::ofstream* stream);
+      const std::string& path, std::ofstream* stream,
+      tesseract::TessBaseAPI* const api);
+
+  // finds all of the uni, bi, or tri grams (depending on the first argument)
+  // in the sentence, discarding any containing invalid words (as judged by
+  // the api's dictionary) and, for uni-grams, stop words. the n-grams found
+  // are appended to the given vector and owned by the caller.
+  void findNGrams(const int& gram,
+      TesseractSentenceData* const sentence,
+      tesseract::TessBaseAPI* const api,
+      GenericVector<NGram*>& ngrams);
+
+  // finds where each of the words in the text starts and how long it is
+  static void findSentenceWords(const char* const s_txt,
+      GenericVector<int>& wordStarts, GenericVector<int>& wordLengths);
+
+  // puts the word into the form it's kept in for the given n-gram size:
+  // lower case with any punctuation/numbers removed (other than a lone
+  // operator in a uni-gram). returns false if nothing is left of it.
+  static bool normalizeWord(const char* const word, const int& wrdlen,
+      const int& gram, std::string& normalized);
+
+  // true if the (normalized) word is in the api's dictionary or is an
+  // operator and, for uni-grams, isn't a stop word
+  bool isValidWord(const std::string& word, const int& gram,
+      tesseract::TessBaseAPI* const api);
+
+  inline static bool isOperator(const char& char_) {
+    return char_ == '=' || char_ == '+' || char_ == '-'
+        || char_ == '*' || char_ == '/';
+  }
+
+  // writes the n-grams to the given file one per line, the same as
+  // writeNGramFile does
+  void writeNGrams(const GenericVector<NGram*>& ngrams,
+      const std::string& filepath);
 
   // ranks just one ngram file (either uni, bi, or tri depending
   // on first argument)
@@ -46,9 +46,14 @@ GenericVector<std::string> StopwordFileReader::getStopwords() {
 }
 
 bool StopwordFileReader::isStopWord(std::string word) {
-  stopwords = getStopwords();
+  // only reads the list once it's loaded (rather than copying it on every
+  // call) so words can be checked from several threads at once
+  if(stopwords.empty()) {
+    getStopwords();
+  }
+  const std::string lowerWord = Utils::toLower(word);
   for(int i = 0; i < stopwords.length(); ++i) {
-    if(Utils::toLower(word) == Utils::toLower(stopwords[i])) {
+    if(lowerWord == Utils::toLower(stopwords[i])) {
       return true;
     }
   }
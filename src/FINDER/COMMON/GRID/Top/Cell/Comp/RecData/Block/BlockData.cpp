@@ -23,9 +23,9 @@
 //#define DBG_INFO_GRID
 //#define DBG_INFO_GRID_S
 
-TesseractBlockData::TesseractBlockData(BLOCK_RES* blockRes,
+TesseractBlockData::TesseractBlockData(TBOX boundingBox,
     BlobDataGrid* parentGrid) {
-  this->blockRes = blockRes;
+  this->boundingBox = boundingBox;
   this->parentGrid = parentGrid;
 }
 
@@ -41,8 +41,8 @@ TesseractBlockData::~TesseractBlockData() {
   tesseractRows.clear();
 }
 
-BLOCK_RES* TesseractBlockData::getBlockRes() {
-  return blockRes;
+TBOX TesseractBlockData::getBoundingBox() {
+  return boundingBox;
 }
 
 std::vector<TesseractRowData*>& TesseractBlockData::getTesseractRows() {
@@ -54,13 +54,12 @@ std::vector<TesseractRowData*>& TesseractBlockData::getTesseractRows() {
 // here a sentence is simply any group of one or more words starting with
 // a capital letter, valid first word, and ending with a period or question mark.
 void TesseractBlockData::findRecognizedSentences(
-    tesseract::TessBaseAPI* api,
     BlobDataGrid* blobDataGrid) {
 
   BlobDataGridSearch bdgs(blobDataGrid);
 
   // Determine where the sentences are relative to each row
-  // use the api to figure out if words are valid
+  // use the words' validity according to Tesseract
   //dbgDisplayRowText();
   // walk through the rows
   bool sentence_found = false;
@@ -81,7 +80,7 @@ void TesseractBlockData::findRecognizedSentences(
         }
         if(isupper(wordstr[0]) && islower(wordstr[1])) {
           // see if the uppercase word is valid or not based on the api
-          if(api->IsValidWord(wordstr)) {
+          if(words[j]->getIsValidTessWord()) {
             // found the start of a sentence!!
             tesseractSentences.push_back(
                 new TesseractSentenceData(this, i, j));
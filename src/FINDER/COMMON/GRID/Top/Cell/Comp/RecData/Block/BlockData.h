@@ -8,11 +8,9 @@
 #ifndef TESSERACTBLOCKDATA_H_
 #define TESSERACTBLOCKDATA_H_
 
-#include <baseapi.h>
-
 #include <vector>
 
-#include <pageres.h>
+#include <rect.h>
 #include <BlobDataGrid.h>
 
 #include <SentenceData.h>
@@ -29,11 +27,11 @@ class TesseractBlockData {
 
  public:
 
-  TesseractBlockData(BLOCK_RES* const blockRes, BlobDataGrid* const parentGrid);
+  TesseractBlockData(TBOX boundingBox, BlobDataGrid* const parentGrid);
 
   ~TesseractBlockData();
 
-  BLOCK_RES* getBlockRes();
+  TBOX getBoundingBox();
 
   std::vector<TesseractRowData*>& getTesseractRows();
 
@@ -41,10 +39,10 @@ class TesseractBlockData {
    * Finds the start and end of all sentences recognized by Tesseract
    * and stores the sentence data in a list within this object. Updates
    * the blobs on the grid so they have references to the sentences
-   * to which they belong (if they belong to a sentence).
+   * to which they belong (if they belong to a sentence). The words must
+   * already know whether Tesseract sees them as valid.
    */
-  void findRecognizedSentences(tesseract::TessBaseAPI* tessBaseApi,
-      BlobDataGrid* blobDataGrid);
+  void findRecognizedSentences(BlobDataGrid* blobDataGrid);
 
   std::vector<TesseractSentenceData*>& getRecognizedSentences();
 
@@ -54,7 +52,7 @@ class TesseractBlockData {
  private:
 
   std::vector<TesseractRowData*> tesseractRows;
-  BLOCK_RES* blockRes;
+  TBOX boundingBox;
   std::vector<TesseractSentenceData*> tesseractSentences;
 
   /**
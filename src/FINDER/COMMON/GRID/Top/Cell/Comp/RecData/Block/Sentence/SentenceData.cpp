@@ -10,14 +10,13 @@
 #include <RowData.h>
 #include <WordData.h>
 #include <BlockData.h>
-#include <NGramRanker.h>
 
 #include <assert.h>
 
 TesseractSentenceData::TesseractSentenceData(TesseractBlockData* parentBlock,
     const int startRowIndex, const int startWordIndex)
 : endRowIndex(-1), endWordIndex(-1), isMath(false),
-  sentence_txt(NULL), ngrams(NULL),
+  sentence_txt(NULL),
   lineboxes(NULL) {
   this->parentBlock = parentBlock;
   this->startRowIndex = startRowIndex;
@@ -33,11 +32,6 @@ TesseractSentenceData::~TesseractSentenceData() {
     delete [] sentence_txt;
     sentence_txt = NULL;
   }
-  if(ngrams != NULL) {
-    NGramRanker::destroyNGramVecs(*ngrams);
-    delete ngrams;
-    ngrams = NULL;
-  }
 }
 
 void TesseractSentenceData::readInBlockText(const int endRowIndex, const int endWordIndex) {
@@ -141,13 +135,14 @@ char* TesseractSentenceData::getSentenceText() {
   return sentence_txt;
 }
 
-void TesseractSentenceData::setNGramCounts(RankedNGramVecs* ngrams) {
-  this->ngrams = ngrams;
+void TesseractSentenceData::setNGramKeys(const NGramKeyVecs& ngramKeys) {
+  this->ngramKeys = ngramKeys;
 }
 
-// the uni, bi, and tri grams in the sentence and their counts
-RankedNGramVecs* TesseractSentenceData::getNGramCounts() {
-  return ngrams;
+// the uni, bi, and tri grams in the sentence that could be in the
+// "Math N-Gram Profile" (as keys into its index), once per occurrence
+const NGramKeyVecs& TesseractSentenceData::getNGramKeys() {
+  return ngramKeys;
 }
 
 void TesseractSentenceData::setNGramFeatures(GenericVector<double> ngram_features) {
@@ -16,6 +16,8 @@ class NGramFrequency;
 class RankedNGram;
 class TesseractBlockData;
 
+#include <NGramIndex.h>
+
 #include <allheaders.h>
 #include <baseapi.h>
 
@@ -64,10 +66,11 @@ class TesseractSentenceData {
    */
   char* getSentenceText();
 
-  void setNGramCounts(RankedNGramVecs* ngrams);
+  void setNGramKeys(const NGramKeyVecs& ngramKeys);
 
-  // the uni, bi, and tri grams in the sentence and their counts
-  RankedNGramVecs* getNGramCounts();
+  // the uni, bi, and tri grams in the sentence that could be in the
+  // "Math N-Gram Profile" (as keys into its index), once per occurrence
+  const NGramKeyVecs& getNGramKeys();
 
   void setNGramFeatures(GenericVector<double> ngram_features);
 
@@ -92,7 +95,8 @@ class TesseractSentenceData {
                // false since during prediction it is unknown whether a sentence is math
                // or not.
   char* sentence_txt; // the sentence text
-  RankedNGramVecs* ngrams; // the uni, bi, and tri grams in the sentence and their counts
+  NGramKeyVecs ngramKeys; // the uni, bi, and tri grams in the sentence that could be in
+                          // the "Math N-Gram Profile", as keys into its index
   GenericVector<double> ngram_features; // assigned during feature extraction based on
                                         // comparison to a "Math N-Gram Profile".
   Boxa* lineboxes; // an array of boxes where each box is a line of text in the sentence
@@ -18,7 +18,7 @@
 TesseractCharData::TesseractCharData(
     TBOX charResultBoundingBox,
     TesseractWordData* parentWord):
-   recognitionResultUnicode(""), charResultInfo(NULL),
+   recognitionResultUnicode(""), certaintyFound(false), certainty(0),
    dist_above_baseline(0) {
   this->charResultBoundingBox = charResultBoundingBox;
   this->parentWord = parentWord;
@@ -39,9 +39,10 @@ setRecognitionResultUnicode(const std::string recognitionResultUnicode) {
   return this;
 }
 TesseractCharData* TesseractCharData::
-setCharResultInfo(BLOB_CHOICE* charResultInfo) {
-  if(this->charResultInfo == NULL) {
-    this->charResultInfo = charResultInfo;
+setCertainty(const float certainty) {
+  if(!certaintyFound) {
+    this->certainty = certainty;
+    certaintyFound = true;
   }
   return this;
 }
@@ -61,8 +62,11 @@ TBOX* TesseractCharData::getBoundingBox() {
 std::string TesseractCharData::getUnicode() {
   return recognitionResultUnicode;
 }
-BLOB_CHOICE* TesseractCharData::getCharResultInfo() {
-  return charResultInfo;
+bool TesseractCharData::hasCertainty() {
+  return certaintyFound;
+}
+float TesseractCharData::getCertainty() {
+  return certainty;
 }
 double TesseractCharData::getDistanceAboveRowBaseline() {
   return dist_above_baseline;
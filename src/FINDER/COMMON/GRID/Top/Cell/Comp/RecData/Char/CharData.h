@@ -8,8 +8,7 @@
 #ifndef TESSERACTCHARDATA_H_
 #define TESSERACTCHARDATA_H_
 
-#include <baseapi.h>
-#include <ratngs.h>
+#include <rect.h>
 #include <vector>
 #include <string>
 
@@ -27,11 +26,10 @@ class BlobData;
  * in the character's recognition accuracy, it's confidence in the accuracy
  * of the word the character belongs to, and possibly other features.
  *
- * Regarding memory management, objects of this class are not designed to be
- * used unless the Tesseract api used for recognition is still in scope. It
- * mostly just holds immutable pointers and does not do any deep copying.
- * Just makes life easier that way. There may be some exceptions but deep
- * copies will be avoided where ever possible.
+ * Regarding memory management, the results are copied in (they may have
+ * been read from the OCR result cache rather than coming from the api), so
+ * objects of this class don't depend on the Tesseract api used for
+ * recognition still being in scope.
  */
 class TesseractCharData {
 
@@ -52,7 +50,7 @@ class TesseractCharData {
    * Setters (these only set the values once.. no-op if you try doing it again)
    */
   TesseractCharData* setRecognitionResultUnicode(const std::string recognitionResultUnicode);
-  TesseractCharData* setCharResultInfo(BLOB_CHOICE* charResultInfo);
+  TesseractCharData* setCertainty(const float certainty);
   TesseractCharData* setDistanceAboveRowBaseline(const double dist);
 
   /**
@@ -60,7 +58,9 @@ class TesseractCharData {
    */
   TBOX* getBoundingBox();
   std::string getUnicode();
-  BLOB_CHOICE* getCharResultInfo();
+  // false if Tesseract didn't have a choice for this character
+  bool hasCertainty();
+  float getCertainty();
   double getDistanceAboveRowBaseline();
   TesseractWordData* getParentWord();
   std::vector<BlobData*>& getBlobs();
@@ -76,7 +76,8 @@ class TesseractCharData {
 
   std::string recognitionResultUnicode; // unicode representation of character recognition result
 
-  BLOB_CHOICE* charResultInfo; // tesseract info on the recognition result for this character
+  bool certaintyFound;
+  float certainty; // tesseract's certainty in the recognition result for this character
 
   double dist_above_baseline; // the char's distance above its row's baseline
 
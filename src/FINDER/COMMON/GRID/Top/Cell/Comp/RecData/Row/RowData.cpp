@@ -11,17 +11,18 @@
 #include <BlockData.h>
 #include <WordData.h>
 
-TesseractRowData::TesseractRowData(ROW_RES* rowRes,
+TesseractRowData::TesseractRowData(TBOX boundingBox,
+    const std::vector<float>& baseline,
     TesseractBlockData* parentBlockData)
 : hasValidTessWord(false), avg_baselinedist((double)0),
   rowIndex(-1), isConsideredNormal(true), valid_word_count(-1),
   aValidWordFound(NULL), avgWordConf(-1) {
-  this->rowRes = rowRes;
+  this->boundingBox = boundingBox;
+  this->baseline = baseline;
   this->parentBlockData = parentBlockData;
 }
 
 TesseractRowData::~TesseractRowData() {
-  rowRes = NULL;
   for(int i = 0; i < wordinfovec.length(); ++i) {
     if(wordinfovec[i] != NULL) {
       delete wordinfovec[i];
@@ -31,14 +32,6 @@ TesseractRowData::~TesseractRowData() {
   wordinfovec.clear();
 }
 
-ROW_RES* TesseractRowData::getRowRes() {
-  return rowRes;
-}
-
-WERD_RES_LIST* TesseractRowData::getWordResList() {
-  return &(rowRes->word_res_list);
-}
-
 std::string TesseractRowData::getRowText() {
   std::string str;
   for(int i = 0; i < wordinfovec.length(); ++i) {
@@ -48,18 +41,19 @@ std::string TesseractRowData::getRowText() {
   return str;
 }
 
-// this provides the bounding box, baseline, and various other
-// useful information about the row as found in the tesseract api.
-ROW* TesseractRowData::row() {
-  return rowRes->row;
-}
-
-PARA* TesseractRowData::getParagraph() {
-  return row()->para();
+TBOX TesseractRowData::getBoundingBox() {
+  return boundingBox;
 }
 
-TBOX TesseractRowData::getBoundingBox() {
-  return row()->bounding_box();
+float TesseractRowData::getBaseline(const int x) {
+  assert(!baseline.empty());
+  int index = x - boundingBox.left();
+  if(index < 0) {
+    index = 0;
+  } else if(index >= (int)baseline.size()) {
+    index = baseline.size() - 1;
+  }
+  return baseline[index];
 }
 
 int TesseractRowData::numValidWords() {
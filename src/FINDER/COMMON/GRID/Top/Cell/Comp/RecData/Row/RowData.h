@@ -12,9 +12,11 @@
 
 #include <assert.h>
 
-#include <pageres.h>
-#include <baseapi.h>
+#include <host.h>
+#include <rect.h>
+#include <genericvector.h>
 #include <string>
+#include <vector>
 
 class TesseractWordData;
 class TesseractBlockData;
@@ -22,20 +24,23 @@ class TesseractBlockData;
 //enum ROW_TYPE {NORMAL, ABNORMAL};
 struct TesseractRowData {
 
-  TesseractRowData(ROW_RES* rowRes, TesseractBlockData* parentBlockData);
+  /**
+   * Takes a copy of the row's bounding box and of its baseline, sampled at
+   * each x coordinate from the left of the box to its right (inclusive)
+   */
+  TesseractRowData(TBOX boundingBox, const std::vector<float>& baseline,
+      TesseractBlockData* parentBlockData);
 
   ~TesseractRowData();
 
   std::string getRowText();
 
-  // this provides the bounding box, baseline, and various other
-  // useful information about the row as found in the tesseract api.
-  ROW* row();
-
-  PARA* getParagraph();
-
   TBOX getBoundingBox();
 
+  // the y coordinate of the row's baseline at the given x coordinate
+  // (clamped to the row's bounding box)
+  float getBaseline(const int x);
+
   int numValidWords();
 
   void setValidWordCount(const int wc);
@@ -48,11 +53,6 @@ struct TesseractRowData {
 
   bool getIsConsideredNormal();
 
-  ROW_RES* getRowRes();
-
-  // unmodified words found directly by the tesseract api
-  WERD_RES_LIST* getWordResList();
-
   GenericVector<TesseractWordData*>& getTesseractWords();
 
   TesseractBlockData* getParentBlock();
@@ -68,7 +68,7 @@ struct TesseractRowData {
 
   bool hasValidTessWord;
 
-  char* aValidWordFound;
+  const char* aValidWordFound;
 
   GenericVector<TesseractWordData*> wordinfovec;
 
@@ -76,11 +76,13 @@ struct TesseractRowData {
   bool isConsideredNormal;
   int valid_word_count; // number of valid words on this row
 
-  ROW_RES* rowRes; // tesseract api information on the row
   TesseractBlockData* parentBlockData;
 
  private:
 
+  TBOX boundingBox;
+  std::vector<float> baseline;
+
   float avgWordConf;
 
 };
@@ -14,19 +14,17 @@
 #include <iostream>
 
 TesseractWordData::TesseractWordData(TBOX boundingBox,
-    WERD_RES* const wordRes,
     TesseractRowData* const parentRowData)
 : sentenceIndex(-1), isValidTessWord(false),
   resultMatchesMathWord(false), resultMatchesStopword(false),
-  parentRow(NULL), wordRes(NULL) {
+  parentRow(NULL), hasText(false), certainty(0), fontInfoFound(false),
+  fontProperties(0) {
   this->boundingBox = boundingBox;
-  this->wordRes = wordRes;
   this->parentRow = parentRowData;
 }
 
 TesseractWordData::~TesseractWordData() {
   parentRow = NULL;
-  wordRes = NULL;
   for(int i = 0; i < tesseractChars.size(); ++i) {
     delete tesseractChars[i];
     tesseractChars[i] = NULL;
@@ -34,23 +32,45 @@ TesseractWordData::~TesseractWordData() {
   tesseractChars.clear();
 }
 
+TesseractWordData* TesseractWordData::setWordText(const char* const text) {
+  hasText = (text != NULL);
+  this->text = hasText ? text : "";
+  return this;
+}
+
+TesseractWordData* TesseractWordData::setCertainty(const float certainty) {
+  this->certainty = certainty;
+  return this;
+}
+
+TesseractWordData* TesseractWordData::setFontInfo(const std::string fontName,
+    const uinT32 fontProperties) {
+  fontInfoFound = true;
+  this->fontName = fontName;
+  this->fontProperties = fontProperties;
+  return this;
+}
+
 const char* TesseractWordData::wordstr() {
-  if(bestchoice() != NULL)
-    return bestchoice()->unichar_string().string();
+  if(hasText)
+    return text.c_str();
   return NULL;
 }
 
-WERD_CHOICE* TesseractWordData::bestchoice() {
-  if(wordRes != NULL)
-    return wordRes->best_choice;
-  return NULL;
+float TesseractWordData::getCertainty() {
+  return certainty;
 }
 
-WERD* TesseractWordData::word() {
-  if(!wordRes) {
-    return NULL;
-  }
-  return wordRes->word;
+bool TesseractWordData::hasFontInfo() {
+  return fontInfoFound;
+}
+
+std::string TesseractWordData::getFontName() {
+  return fontName;
+}
+
+bool TesseractWordData::getIsItalic() {
+  return fontInfoFound && (fontProperties & 1); // same as FontInfo::is_italic()
 }
 
 
@@ -100,10 +120,6 @@ bool TesseractWordData::getResultMatchesMathWord() {
   return resultMatchesMathWord;
 }
 
-WERD_RES* TesseractWordData::getWordRes() {
-  return wordRes;
-}
-
 void TesseractWordData::setResultMatchesStopword(bool resultMatchesStopword) {
   this->resultMatchesStopword = resultMatchesStopword;
 }
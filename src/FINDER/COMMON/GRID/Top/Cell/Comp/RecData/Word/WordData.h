@@ -9,8 +9,9 @@
 #define TESSERACTWORDDATA_H_
 
 #include <stddef.h>
-#include <baseapi.h>
-#include <ratngs.h>
+#include <host.h>
+#include <rect.h>
+#include <string>
 #include <vector>
 
 class TesseractCharData;
@@ -20,16 +21,30 @@ class TesseractBlockData;
 struct TesseractWordData {
 
   TesseractWordData(TBOX boundingBox,
-      WERD_RES* const wordRes,
       TesseractRowData* const parentRowData);
 
   ~TesseractWordData();
 
+  /**
+   * Setters for the recognition results (copied from Tesseract's results
+   * so the word doesn't depend on the api that recognized it)
+   */
+  TesseractWordData* setWordText(const char* const text);
+  TesseractWordData* setCertainty(const float certainty);
+  TesseractWordData* setFontInfo(const std::string fontName,
+      const uinT32 fontProperties);
+
+  // the recognized text, NULL if Tesseract didn't give the word any
   const char* wordstr();
 
-  WERD_CHOICE* bestchoice();
+  // Tesseract's certainty in the word (the worst certainty of the
+  // individual characters in it)
+  float getCertainty();
 
-  WERD* word();
+  // false if Tesseract didn't find the word's font
+  bool hasFontInfo();
+  std::string getFontName();
+  bool getIsItalic();
 
   void setIsValidTessWord(bool isValidTessWord);
 
@@ -54,8 +69,6 @@ struct TesseractWordData {
   void setResultMatchesMathWord(bool matchesMathWord);
   bool getResultMatchesMathWord();
 
-  WERD_RES* getWordRes();
-
   void setResultMatchesStopword(bool isStopword);
   bool getResultMatchesStopword();
 
@@ -64,7 +77,13 @@ struct TesseractWordData {
  private:
 
   TBOX boundingBox; // the rectangular coords of the word on the page
-  WERD_RES* wordRes;
+
+  bool hasText;
+  std::string text;
+  float certainty;
+  bool fontInfoFound;
+  std::string fontName;
+  uinT32 fontProperties; // italic, bold, etc. (see Tesseract's FontInfo)
 
   TesseractRowData* parentRow;
 
@@ -7,6 +7,9 @@
 
 #include <BlobDataGridFactory.h>
 
+#include <OcrPageResult.h>
+#include <OcrResultCache.h>
+
 #include <baseapi.h>
 #include <BlobDataGrid.h>
 #include <TessParamManager.h>
@@ -16,7 +19,9 @@
 #include <RowData.h>
 #include <WordData.h>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <M_Utils.h>
 #include <Utils.h>
@@ -32,12 +37,20 @@
 //#define DBG_MULTI_PARENT_ISSUE
 //#define DBG_NO_OVERLAP
 //#define DBG_SHOW_SPLIT
+//#define USE_OCR_CACHE // reuse recognition results cached under ~/.mathfinder/ocrcache (never evicted)
+
+BlobDataGridFactory::BlobDataGridFactory() : gridCellSize(0) {}
+
+BlobDataGridFactory::BlobDataGridFactory(const int& gridCellSize) {
+  assert(gridCellSize > 0);
+  this->gridCellSize = gridCellSize;
+}
 
 BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
     tesseract::TessBaseAPI* tessBaseApi, const std::string imageName) {
 
-  // Initialize the tesseract api
-  tessBaseApi->Init("/usr/local/share/", "eng");
+  // The api is expected to have already been through Init() (i.e., leased
+  // from an engine pool) so that the language data isn't reloaded per page
 
   // Choose the page segmentation mode as PSM_AUTO
   // Fully automatic page segmentation, but no OSD
@@ -55,11 +68,23 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
    * math finding logic is disabled at this stage, the table detection
    * and segmentation logic is kept among various other features. I also
    * leverage their recognition results without any math equation detection in
-   * place.
+   * place. With USE_OCR_CACHE the results are cached by the page's pixels and
+   * Tesseract's configuration, so recognition only runs the first time a page
+   * is seen.
    */
-  // Run Tesseract's layout analysis and recognition
-  tessBaseApi->SetImage(image); // set the image
-  tessBaseApi->Recognize(NULL); // Run Tesseract's layout analysis and recognition without equation detection
+  OcrPageResult pageResult;
+#ifdef USE_OCR_CACHE
+  OcrResultCache ocrResultCache(Utils::getOcrCacheRoot());
+  if(!ocrResultCache.read(image, tessBaseApi, pageResult)) {
+#endif
+    // Run Tesseract's layout analysis and recognition
+    tessBaseApi->SetImage(image); // set the image
+    tessBaseApi->Recognize(NULL); // Run Tesseract's layout analysis and recognition without equation detection
+    readPageResults(tessBaseApi, pageResult);
+#ifdef USE_OCR_CACHE
+    ocrResultCache.write(image, tessBaseApi, pageResult);
+  }
+#endif
 
   /**
    * ---------------
@@ -77,8 +102,11 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
 
   // Create a grid containing an entry for each connected component which includes
   // its image and coordinates
-  BlobDataGrid* blobDataGrid = new BlobDataGrid(1,
+  const int cellSize = (gridCellSize > 0) ? gridCellSize
+      : chooseGridCellSize(blobCoords);
+  BlobDataGrid* blobDataGrid = new BlobDataGrid(cellSize,
       ICOORD(0, 0), ICOORD(image->w, image->h), tessBaseApi, image, imageName);
+  blobDataGrid->setBinaryImage(pixClone(pageResult.thresholdedImage));
 
   // Load all of the connected components and their images onto the grid
   // along with the recognition results
@@ -118,97 +146,57 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
    * result into the grid created in Stage 2 at its appropriate connected component
    * entry.
    */
-  // Note: While I'm using the mutable iterator, I'm still only changing the pointer through the higher level api.
-  //       Only reason I'm using the mutable iterator is so I have public access to everything for readonly purposes
-
-  std::vector<TesseractBlockData*> blocks;
-  // The Page_Res is sort of like a Russian doll. There are many layers:
-  // BLOCK_RES -> ROW_RES -> WERD_RES -> WERD_CHOICE -> BLOB_CHOICE
-  //                         WERD_RES -> WERD        -> C_BLOB
-
-  // My resulting data structure is similar but slightly different:
+  // My resulting data structure follows the page's results:
   // Block -> Row -> Word -> Character -> Blob
 
   // Iterate through the block(s) of text inside the page
-  const BLOCK_RES_LIST* block_results = &(tessBaseApi->extGetPageResults()->block_res_list);
-  BLOCK_RES_IT bres_it((BLOCK_RES_LIST*)block_results);
-  bres_it.move_to_first();
-  for(int i = 0; i < block_results->length(); ++i) { // start iterating blocks on page
+  for(int i = 0; i < pageResult.blocks.size(); ++i) { // start iterating blocks on page
+    const OcrBlockResult& blockResult = pageResult.blocks[i];
 
-    TesseractBlockData* tesseractBlockData = new TesseractBlockData(bres_it.data(), blobDataGrid);
+    TesseractBlockData* tesseractBlockData =
+        new TesseractBlockData(blockResult.boundingBox, blobDataGrid);
 
     // Go ahead and add this block data to the grid, so I can get quick top-down access
     // to the blocks, and the sentences or other contents within them that are of interest
     blobDataGrid->getTesseractBlocks().push_back(tesseractBlockData);
 
     // Iterate through the row(s) of text inside the text block
-    ROW_RES_LIST& rowResList = tesseractBlockData->getBlockRes()->row_res_list;
-    ROW_RES_IT rowresit(&rowResList);
-    rowresit.move_to_first();
-    for(int j = 0; j < rowResList.length(); ++j) { // start iterating rows on block
-      TesseractRowData* tesseractRowData = new TesseractRowData(rowresit.data(), tesseractBlockData);
+    for(int j = 0; j < blockResult.rows.size(); ++j) { // start iterating rows on block
+      const OcrRowResult& rowResult = blockResult.rows[j];
+      TesseractRowData* tesseractRowData = new TesseractRowData(
+          rowResult.boundingBox, rowResult.baseline, tesseractBlockData);
       tesseractBlockData->getTesseractRows().push_back(tesseractRowData);
       tesseractRowData->rowIndex = j;
-      char* firstvalidword = getRowValidTessWord(tesseractRowData, tessBaseApi);
-      if(firstvalidword != NULL) {
-        tesseractRowData->setHasValidTessWord(true);
-        tesseractRowData->aValidWordFound = firstvalidword;
-      }
 
       // Iterate the words within the row
-      WERD_RES_IT wordresit(tesseractRowData->getWordResList());
-      wordresit.move_to_first();
-      for(int k = 0; k < tesseractRowData->getWordResList()->length(); ++k) { // start iterating words on row on block
-        WERD_RES* wordResultData = wordresit.data();
-        if(!wordResultData) {
-          //assert(false); // asserting false because I don't think this is possible but we'll see
-          continue; // Only care if has results (don't think it should get here.. but if it did this is what I'd do)
-        }
-
-        WERD_CHOICE* const bestWordChoice = wordResultData->best_choice;
-        if(!bestWordChoice) {
-          continue; // Only care if has results
-        }
+      for(int k = 0; k < rowResult.words.size(); ++k) { // start iterating words on row on block
+        const OcrWordResult& wordResult = rowResult.words[k];
 
         // Create a word wrapper for this word that has access to its parent row among other things
         // Also add it to its parent's row wrapper to allow top-down access
         TesseractWordData* tesseractWordData =
-            new TesseractWordData(wordResultData->word->bounding_box(), wordResultData, tesseractRowData);
+            (new TesseractWordData(wordResult.boundingBox, tesseractRowData))
+            ->setWordText(wordResult.hasText ? wordResult.text.c_str() : NULL)
+            ->setCertainty(wordResult.certainty);
+        if(wordResult.hasFontInfo) {
+          tesseractWordData->setFontInfo(wordResult.fontName,
+              wordResult.fontProperties);
+        }
         tesseractRowData->getTesseractWords().push_back(tesseractWordData);
 
-        // Go ahead and find out if Tesseract api sees the word as valid or not
-        if(tesseractWordData->wordstr() != NULL) {
-          tesseractWordData->setIsValidTessWord(tessBaseApi->IsValidWord(tesseractWordData->wordstr()));
+        // Whether the Tesseract api sees the word as valid or not
+        tesseractWordData->setIsValidTessWord(wordResult.isValidWord);
+        if(wordResult.isValidWord && !tesseractRowData->getHasValidTessWord()) {
+          tesseractRowData->setHasValidTessWord(true);
+          tesseractRowData->aValidWordFound = tesseractWordData->wordstr();
         }
 
         // Iterate the characters in the word, adding all of each character's blobs to the grid
-        // Bounding boxes and results for the recognized characters in the word
-        const char* const unicodeWordResult = bestWordChoice->unichar_string().string();
-        const char* const unicodeCharLengths = bestWordChoice->unichar_lengths().string();
-        const int numCharactersInWord = strlen(unicodeCharLengths);
-        int charBytePosition = 0;
-        for (int i = 0; i < numCharactersInWord; i++) { // start iterating chars in word in row in block
-
-          // get the substring representing the unicode result for the current character
-          const int unicodeCharBytes = unicodeCharLengths[i]; // num bytes in this character's unicode result
-          std::string unicodeCharResult(std::string(unicodeWordResult),
-              charBytePosition, unicodeCharBytes);
-          charBytePosition += unicodeCharBytes; // advance the position
-
-          // get the bounding box of the current recognized character within the word
-          TBOX charResultBox = tesseractWordData->getBoundingBox().intersection(
-              wordResultData->box_word->BlobBox(i));
-
-          // get the recognition data for this character (should be at the head of the choice list for this character)
-          // iterator over the characters (each entry has a list of choices
-          // for the corresponding character)
-          BLOB_CHOICE_LIST_C_IT characterChoiceListIt(bestWordChoice->blob_choices());
-          for(int j = 0; j < i; ++j) { // advance to the choice list to that of the current character
-            characterChoiceListIt.forward();
-          }
+        for (int l = 0; l < wordResult.chars.size(); l++) { // start iterating chars in word in row in block
+          const OcrCharResult& charResult = wordResult.chars[l];
 
-          BLOB_CHOICE* const bestChoice = characterChoiceListIt.empty() ? NULL :
-              BLOB_CHOICE_IT(characterChoiceListIt.data()).data(); // should be at the head of the choice list for this character
+          // the bounding box of the current recognized character within the word
+          TBOX charResultBox = charResult.boundingBox;
 
           // the below shouldn't happen, every char recognized
           // by Tesseract should correspond to at least
@@ -226,12 +214,18 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
           // Get blobs that overlap this character in my grid and update them to have this data
           TesseractCharData* tesseractCharData =
               (new TesseractCharData(charResultBox, tesseractWordData))
-              ->setCharResultInfo(bestChoice)
-              ->setRecognitionResultUnicode(unicodeCharResult);
+              ->setRecognitionResultUnicode(charResult.unicode);
+          if(charResult.hasChoice) {
+            tesseractCharData->setCertainty(charResult.certainty);
+          }
           tesseractWordData->getTesseractChars().push_back(tesseractCharData);
           BlobDataGridSearch blobDataGridSearch(blobDataGrid);
           blobDataGridSearch.SetUniqueMode(true);
           blobDataGridSearch.StartRectSearch(charResultBox);
+          // Blob split out for this character if it needs one. A new one is only inserted
+          // into the grid once the search is done rather than while it's going through it
+          BlobData* splitBlob = NULL;
+          bool insertSplitBlob = false;
           BlobData* curBlobData = blobDataGridSearch.NextRectSearch();
           while(curBlobData != NULL) { // start iterating blobs in char in word in row in block
             if(tesseractCharData->getBoundingBox()->contains(
@@ -296,8 +290,10 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
               if(M_Utils::almostContains(curBlobData->getBoundingBox(), charResultBox)) {
                 curBlobData->markForDeletion(); // This needs to get removed once it's been split fully
               }
-              // create and insert new blob for this data if there isn't already an entry with a matching bounding box
-              BlobData* splitBlob = blobDataGrid->getEntryWithBoundingBox(charResultBox);
+              // create new blob for this data if there isn't already an entry with a matching bounding box
+              if(splitBlob == NULL) {
+                splitBlob = blobDataGrid->getEntryWithBoundingBox(charResultBox);
+              }
               if(splitBlob == NULL) {
                 splitBlob = new BlobData(
                     charResultBox,
@@ -308,7 +304,7 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
                             image),
                         NULL),
                     blobDataGrid);
-                blobDataGrid->InsertBBox(true, true, splitBlob);
+                insertSplitBlob = true;
               }
               splitBlob->markAsTesseractSplit(); // mark the blob as one that was split from connected component by Tesseract
               splitBlob->setCharacterRecognitionData(tesseractCharData);
@@ -316,12 +312,12 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
             }
             curBlobData = blobDataGridSearch.NextRectSearch();
           } // done iterating blobs in char in word in row in block
+          if(insertSplitBlob) {
+            blobDataGrid->InsertBBox(true, true, splitBlob);
+          }
         } // done iterating chars in word in row in block
-        wordresit.forward();
       } // done iterating words in row in block
-      rowresit.forward();
     } // done iterating rows in block
-    bres_it.forward();
   } // done iterating blocks on the page
 #ifdef DBG_INFO_GRID_MARKED
   {
@@ -350,7 +346,7 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
 
   for(int i = 0; i < blobDataGrid->getTesseractBlocks().size(); ++i) {
     blobDataGrid->getTesseractBlocks()[i]->findRecognizedSentences(
-        tessBaseApi, blobDataGrid);
+        blobDataGrid);
   }
 
   findAllRowCharacteristics(blobDataGrid);
@@ -404,28 +400,105 @@ BlobDataGrid* BlobDataGridFactory::createBlobDataGrid(Pix* image,
   return blobDataGrid;
 }
 
-/**
- * Determines if the given row has a valid word on it according to Tesseract
- */
-char* BlobDataGridFactory::getRowValidTessWord(
-    TesseractRowData* const rowData,
-    tesseract::TessBaseAPI* const api) {
-  WERD_RES_LIST* wordreslist = rowData->getWordResList();
-  WERD_RES_IT wordresit1(wordreslist);
-  wordresit1.move_to_first();
-  bool row_has_valid = false;
-  for(int k = 0; k < wordreslist->length(); k++) {
-    WERD_RES* wordres = wordresit1.data();
-    WERD_CHOICE* wordchoice = wordres->best_choice;
-    if(wordchoice != NULL) {
-      char* wrd = (char*)wordchoice->unichar_string().string();
-      if(api->IsValidWord(wrd)) {
-        return wrd;
+void BlobDataGridFactory::readPageResults(
+    tesseract::TessBaseAPI* const api, OcrPageResult& pageResult) {
+  // The Page_Res is sort of like a Russian doll. There are many layers:
+  // BLOCK_RES -> ROW_RES -> WERD_RES -> WERD_CHOICE -> BLOB_CHOICE
+  //                         WERD_RES -> WERD        -> C_BLOB
+  BLOCK_RES_LIST* const blockResList = &(api->extGetPageResults()->block_res_list);
+  BLOCK_RES_IT bres_it(blockResList);
+  bres_it.move_to_first();
+  for(int i = 0; i < blockResList->length(); ++i, bres_it.forward()) { // start iterating blocks on page
+    BLOCK_RES* const blockRes = bres_it.data();
+    pageResult.blocks.push_back(OcrBlockResult());
+    OcrBlockResult& blockResult = pageResult.blocks.back();
+    blockResult.boundingBox = blockRes->block->bounding_box();
+
+    ROW_RES_IT rowresit(&(blockRes->row_res_list));
+    rowresit.move_to_first();
+    for(int j = 0; j < blockRes->row_res_list.length(); ++j, rowresit.forward()) { // start iterating rows on block
+      ROW* const row = rowresit.data()->row;
+      blockResult.rows.push_back(OcrRowResult());
+      OcrRowResult& rowResult = blockResult.rows.back();
+      rowResult.boundingBox = row->bounding_box();
+      // the baseline is a spline internal to the row, so sample it at each x
+      const int baselineRight = std::max(rowResult.boundingBox.left(),
+          rowResult.boundingBox.right());
+      for(int x = rowResult.boundingBox.left(); x <= baselineRight; ++x) {
+        rowResult.baseline.push_back(row->base_line((float)x));
       }
-    }
-    wordresit1.forward();
-  }
-  return NULL;
+
+      WERD_RES_LIST* const wordResList = &(rowresit.data()->word_res_list);
+      WERD_RES_IT wordresit(wordResList);
+      wordresit.move_to_first();
+      // advanced in the loop header so skipping a word without results
+      // still moves on to the next one
+      for(int k = 0; k < wordResList->length(); ++k, wordresit.forward()) { // start iterating words on row on block
+        WERD_RES* const wordResultData = wordresit.data();
+        if(!wordResultData) {
+          continue; // Only care if has results
+        }
+        WERD_CHOICE* const bestWordChoice = wordResultData->best_choice;
+        if(!bestWordChoice) {
+          continue; // Only care if has results
+        }
+
+        rowResult.words.push_back(OcrWordResult());
+        OcrWordResult& wordResult = rowResult.words.back();
+        wordResult.boundingBox = wordResultData->word->bounding_box();
+        const char* const unicodeWordResult = bestWordChoice->unichar_string().string();
+        wordResult.hasText = (unicodeWordResult != NULL);
+        if(wordResult.hasText) {
+          wordResult.text = unicodeWordResult;
+          // Go ahead and find out if Tesseract api sees the word as valid or not
+          wordResult.isValidWord = api->IsValidWord(unicodeWordResult);
+        }
+        wordResult.certainty = bestWordChoice->certainty();
+        if(wordResultData->fontinfo != NULL) {
+          wordResult.hasFontInfo = true;
+          if(wordResultData->fontinfo->name != NULL) {
+            wordResult.fontName = wordResultData->fontinfo->name;
+          }
+          wordResult.fontProperties = wordResultData->fontinfo->properties;
+        }
+
+        // Bounding boxes and results for the recognized characters in the word
+        const char* const unicodeCharLengths = bestWordChoice->unichar_lengths().string();
+        const int numCharactersInWord =
+            (unicodeCharLengths != NULL) ? strlen(unicodeCharLengths) : 0;
+        // iterator over the characters (each entry has a list of choices
+        // for the corresponding character)
+        BLOB_CHOICE_LIST_C_IT characterChoiceListIt(bestWordChoice->blob_choices());
+        int charBytePosition = 0;
+        for(int l = 0; l < numCharactersInWord; ++l) { // start iterating chars in word in row in block
+          wordResult.chars.push_back(OcrCharResult());
+          OcrCharResult& charResult = wordResult.chars.back();
+
+          // get the substring representing the unicode result for the current character
+          const int unicodeCharBytes = unicodeCharLengths[l]; // num bytes in this character's unicode result
+          charResult.unicode = std::string(std::string(unicodeWordResult),
+              charBytePosition, unicodeCharBytes);
+          charBytePosition += unicodeCharBytes; // advance the position
+
+          // get the bounding box of the current recognized character within the word
+          charResult.boundingBox = wordResult.boundingBox.intersection(
+              wordResultData->box_word->BlobBox(l));
+
+          // get the recognition data for this character (should be at the head of the choice list for this character)
+          if(!characterChoiceListIt.empty()) {
+            BLOB_CHOICE_IT bestChoiceIt(characterChoiceListIt.data());
+            if(!bestChoiceIt.empty()) {
+              charResult.hasChoice = true;
+              charResult.certainty = bestChoiceIt.data()->certainty();
+            }
+            characterChoiceListIt.forward();
+          }
+        } // done iterating chars in word in row in block
+      } // done iterating words in row in block
+    } // done iterating rows in block
+  } // done iterating blocks on the page
+
+  pageResult.thresholdedImage = api->GetThresholdedImage();
 }
 
 void BlobDataGridFactory::findAllRowCharacteristics(BlobDataGrid* const blobDataGrid) {
@@ -461,7 +534,7 @@ void BlobDataGridFactory::findAllRowCharacteristics(BlobDataGrid* const blobData
       if(!words[j]->wordstr()) {
         continue;
       }
-      if(blobDataGrid->getTessBaseAPI()->IsValidWord(words[j]->wordstr())) {
+      if(words[j]->getIsValidTessWord()) {
         ++valid_words_cur_row;
       }
     }
@@ -559,7 +632,7 @@ void BlobDataGridFactory::findAllRowCharacteristics(BlobDataGrid* const blobData
         std::cout << row->getRowText() << std::endl;
         if(row->getRowText().empty())
           std::cout << "NULL\n";
-        M_Utils::dispHlTBoxRegion(row->row()->bounding_box(), blobDataGrid->getImage());
+        M_Utils::dispHlTBoxRegion(row->getBoundingBox(), blobDataGrid->getImage());
         M_Utils::waitForInput();
 #endif
         row->setIsConsideredNormal(false);
@@ -587,7 +660,7 @@ void BlobDataGridFactory::findAllRowCharacteristics(BlobDataGrid* const blobData
         std::cout << row->getRowText() << std::endl;
         std::cout << "above deviation: " << above_deviation << std::endl;
         std::cout << "vert space standard deviation: " << vert_space_std_dev << std::endl;
-        M_Utils::dispHlTBoxRegion(row->row()->bounding_box(), blobDataGrid->getImage());
+        M_Utils::dispHlTBoxRegion(row->getBoundingBox(), blobDataGrid->getImage());
         M_Utils::waitForInput();
 #endif
         row->setIsConsideredNormal(true);
@@ -607,11 +680,11 @@ void BlobDataGridFactory::dbgDisplayHierarchy(
     TesseractCharData* tesseractCharData,
     BlobData* blob,
     Pix* image) {
-  TBOX blockbox = tesseractBlockData->getBlockRes()->block->bounding_box();
+  TBOX blockbox = tesseractBlockData->getBoundingBox();
   std::cout << "Showing the block.\n";
   M_Utils::dispRegion(M_Utils::tessTBoxToImBox(&blockbox, image), image);
   M_Utils::waitForInput();
-  TBOX rowbox = (tesseractRowData->rowRes->row->bounding_box());
+  TBOX rowbox = tesseractRowData->getBoundingBox();
   std::cout << "Showing the row.\n";
   M_Utils::dispRegion(M_Utils::tessTBoxToImBox(&rowbox, image), image);
   M_Utils::waitForInput();
@@ -641,3 +714,15 @@ void BlobDataGridFactory::deleteMarkedEntries(
   }
 }
 
+int BlobDataGridFactory::chooseGridCellSize(Boxa* const blobCoords) {
+  std::vector<int> heights;
+  for(int i = 0; i < blobCoords->n; ++i) {
+    heights.push_back(blobCoords->box[i]->h);
+  }
+  if(heights.empty()) {
+    return 1;
+  }
+  std::nth_element(heights.begin(), heights.begin() + heights.size() / 2,
+      heights.end());
+  return std::max(1, heights[heights.size() / 2]);
+}
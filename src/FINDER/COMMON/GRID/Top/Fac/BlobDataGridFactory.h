@@ -18,10 +18,24 @@ class TesseractBlockData;
 class TesseractWordData;
 class TesseractCharData;
 class BlobData;
+struct OcrPageResult;
 
 class BlobDataGridFactory {
  public:
 
+  /**
+   * Creates grids whose cell size is chosen from each page's connected
+   * components (see chooseGridCellSize)
+   */
+  BlobDataGridFactory();
+
+  /**
+   * Creates grids with the given cell size (in pixels) on every page. The
+   * searches return the same results whatever the cell size, it only
+   * affects how much memory the grid takes and how fast it is to search.
+   */
+  BlobDataGridFactory(const int& gridCellSize);
+
   /**
    * Runs Tesseract's recognition on the given image with auto page segmentation,
    * inserts the raw connected components of the image into the grid, finds the
@@ -29,18 +43,22 @@ class BlobDataGridFactory {
    * inserting them into their appropriate entry in the grid, and returns the
    * created grid. The grid created is owned by the caller who should delete its
    * memory when finished with it. The parameters passed into this factory are
-   * also owned by the caller.
+   * also owned by the caller. The api must already be initialized. The
+   * recognition results are copied into the grid (or, with USE_OCR_CACHE,
+   * read from the OCR result cache if the page has been recognized before
+   * with the same configuration, see OcrResultCache), so the api can be reused once this returns. It must
+   * outlive the grid though, since the grid still uses it for dictionary
+   * lookups.
    */
   BlobDataGrid* createBlobDataGrid(Pix* image,
       tesseract::TessBaseAPI* tessBaseApi, const std::string imageName);
 
  private:
 
-  // Returns the recognized word if theres a 'valid' one on the row,
-  // otherwise returns NULL
-  char* getRowValidTessWord(
-      TesseractRowData* const rowData,
-      tesseract::TessBaseAPI* const tessBaseApi);
+  // Copies everything the grid needs out of the api's results for the page
+  // it just recognized
+  void readPageResults(tesseract::TessBaseAPI* const api,
+      OcrPageResult& pageResult);
 
   // Determines some basic characteristics for each Tesseract row based on an
   // analysis of all the rows on the page. A row can then be considered as
@@ -56,6 +74,12 @@ class BlobDataGridFactory {
       BlobData* blob, Pix* image);
 
   void deleteMarkedEntries(BlobDataGrid* const blobDataGrid);
+
+  // Picks a cell size around the height of a typical character on the page:
+  // the median height of its connected components (at least 1 pixel).
+  int chooseGridCellSize(Boxa* const blobCoords);
+
+  int gridCellSize; // 0 if chosen per page
 };
 
 
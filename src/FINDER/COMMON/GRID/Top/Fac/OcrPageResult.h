@@ -0,0 +1,77 @@
+/*
+ * OcrPageResult.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef OCRPAGERESULT_H_
+#define OCRPAGERESULT_H_
+
+#include <host.h>
+#include <rect.h>
+
+#include <allheaders.h>
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * Everything the BlobDataGridFactory uses from Tesseract's recognition of a
+ * page, copied out of the page's PAGE_RES so that it can be written to and
+ * read back from the OCR result cache. The grid is built from this the same
+ * way whether it came from running recognition or from the cache, so none
+ * of it refers back to Tesseract's own results.
+ */
+struct OcrCharResult {
+  OcrCharResult() : hasChoice(false), certainty(0) {}
+  TBOX boundingBox; // the character's box within its word
+  std::string unicode;
+  bool hasChoice; // false if Tesseract didn't have a choice for the character
+  float certainty;
+};
+
+struct OcrWordResult {
+  OcrWordResult() : hasText(false), certainty(0), hasFontInfo(false),
+      fontProperties(0), isValidWord(false) {}
+  TBOX boundingBox;
+  bool hasText; // false if Tesseract's best choice has no string at all
+  std::string text;
+  float certainty;
+  bool hasFontInfo;
+  std::string fontName;
+  uinT32 fontProperties; // italic, bold, etc. (see FontInfo)
+  bool isValidWord; // true if the text is a valid word according to Tesseract
+  std::vector<OcrCharResult> chars;
+};
+
+struct OcrRowResult {
+  TBOX boundingBox;
+  // the row's baseline at each x coordinate from the left of the row's
+  // bounding box to its right (inclusive)
+  std::vector<float> baseline;
+  std::vector<OcrWordResult> words;
+};
+
+struct OcrBlockResult {
+  TBOX boundingBox;
+  std::vector<OcrRowResult> rows;
+};
+
+struct OcrPageResult {
+  OcrPageResult() : thresholdedImage(NULL) {}
+  ~OcrPageResult() {
+    pixDestroy(&thresholdedImage);
+  }
+
+  std::vector<OcrBlockResult> blocks;
+  Pix* thresholdedImage; // the page after being thresholded by Tesseract
+
+ private:
+  OcrPageResult(const OcrPageResult&);
+  OcrPageResult& operator=(const OcrPageResult&);
+};
+
+
+#endif /* OCRPAGERESULT_H_ */
@@ -0,0 +1,415 @@
+/*
+ * OcrResultCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#include <OcrResultCache.h>
+
+#include <OcrPageResult.h>
+#include <TessParamManager.h>
+#include <Utils.h>
+
+#include <baseapi.h>
+#include <rect.h>
+#include <tesseractclass.h>
+
+#include <allheaders.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+const char OcrResultCache::magic[8] = {'M', 'F', 'O', 'C', 'R', 'R', 'E', 'S'};
+const inT32 OcrResultCache::version;
+
+OcrResultCache::OcrResultCache(const std::string& cacheDirPath)
+: cacheDirPath(Utils::checkTrailingSlash(cacheDirPath)) {}
+
+bool OcrResultCache::read(Pix* image, tesseract::TessBaseAPI* const api,
+    OcrPageResult& result) {
+  const std::string config = getConfig(api);
+  const unsigned long long imageHash = hashImage(image);
+  const std::string path = getPath(config, imageHash);
+  std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+  if(!file.is_open()) {
+    return false;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  file.close();
+  const std::string buffer = contents.str();
+
+  size_t pos = 0;
+  bool valid = buffer.size() >= sizeof(magic)
+      && memcmp(buffer.data(), magic, sizeof(magic)) == 0;
+  pos += sizeof(magic);
+  inT32 fileVersion = 0;
+  std::string fileConfig;
+  inT32 width = 0, height = 0, depth = 0;
+  valid = valid && readInt(buffer, pos, fileVersion) && fileVersion == version
+      && readString(buffer, pos, fileConfig) && fileConfig == config
+      && readInt(buffer, pos, width) && width == pixGetWidth(image)
+      && readInt(buffer, pos, height) && height == pixGetHeight(image)
+      && readInt(buffer, pos, depth) && depth == pixGetDepth(image)
+      && pos + sizeof(imageHash) <= buffer.size()
+      && memcmp(buffer.data() + pos, &imageHash, sizeof(imageHash)) == 0;
+  pos += sizeof(imageHash);
+
+  // the thresholded image
+  inT32 xres = 0, yres = 0, wpl = 0;
+  valid = valid && readInt(buffer, pos, width) && readInt(buffer, pos, height)
+      && readInt(buffer, pos, depth) && readInt(buffer, pos, xres)
+      && readInt(buffer, pos, yres) && readInt(buffer, pos, wpl)
+      && width > 0 && height > 0 && wpl > 0
+      && (depth == 1 || depth == 2 || depth == 4 || depth == 8
+          || depth == 16 || depth == 32)
+      && (size_t)wpl * height * sizeof(l_uint32) <= buffer.size() - pos;
+  if(valid) {
+    result.thresholdedImage = pixCreate(width, height, depth);
+    valid = result.thresholdedImage != NULL
+        && pixGetWpl(result.thresholdedImage) == wpl;
+  }
+  if(valid) {
+    const size_t dataSize = (size_t)wpl * height * sizeof(l_uint32);
+    memcpy(pixGetData(result.thresholdedImage), buffer.data() + pos, dataSize);
+    pos += dataSize;
+    pixSetResolution(result.thresholdedImage, xres, yres);
+  }
+
+  valid = valid && readBlocks(buffer, pos, result) && pos == buffer.size();
+  if(!valid) {
+    std::cout << "WARNING: The cached OCR results at " << path
+        << " couldn't be read. Running Tesseract's recognition instead.\n";
+    result.blocks.clear();
+    pixDestroy(&result.thresholdedImage);
+    return false;
+  }
+  return true;
+}
+
+void OcrResultCache::write(Pix* image, tesseract::TessBaseAPI* const api,
+    const OcrPageResult& result) {
+  Pix* const thresholded = result.thresholdedImage;
+  if(thresholded == NULL) {
+    std::cout << "WARNING: No thresholded image to cache, so the OCR results "
+        << "won't be cached.\n";
+    return;
+  }
+  const std::string config = getConfig(api);
+  const unsigned long long imageHash = hashImage(image);
+
+  std::string buffer(magic, sizeof(magic));
+  appendInt(buffer, version);
+  appendString(buffer, config);
+  appendInt(buffer, pixGetWidth(image));
+  appendInt(buffer, pixGetHeight(image));
+  appendInt(buffer, pixGetDepth(image));
+  buffer.append((const char*)&imageHash, sizeof(imageHash));
+
+  appendInt(buffer, pixGetWidth(thresholded));
+  appendInt(buffer, pixGetHeight(thresholded));
+  appendInt(buffer, pixGetDepth(thresholded));
+  appendInt(buffer, pixGetXRes(thresholded));
+  appendInt(buffer, pixGetYRes(thresholded));
+  appendInt(buffer, pixGetWpl(thresholded));
+  buffer.append((const char*)pixGetData(thresholded),
+      (size_t)pixGetWpl(thresholded) * pixGetHeight(thresholded)
+      * sizeof(l_uint32));
+
+  appendInt(buffer, result.blocks.size());
+  for(int i = 0; i < result.blocks.size(); ++i) {
+    const OcrBlockResult& block = result.blocks[i];
+    appendBox(buffer, block.boundingBox);
+    appendInt(buffer, block.rows.size());
+    for(int j = 0; j < block.rows.size(); ++j) {
+      const OcrRowResult& row = block.rows[j];
+      appendBox(buffer, row.boundingBox);
+      appendInt(buffer, row.baseline.size());
+      for(int k = 0; k < row.baseline.size(); ++k) {
+        appendFloat(buffer, row.baseline[k]);
+      }
+      appendInt(buffer, row.words.size());
+      for(int k = 0; k < row.words.size(); ++k) {
+        const OcrWordResult& word = row.words[k];
+        appendBox(buffer, word.boundingBox);
+        appendInt(buffer, word.hasText);
+        appendString(buffer, word.text);
+        appendFloat(buffer, word.certainty);
+        appendInt(buffer, word.hasFontInfo);
+        appendString(buffer, word.fontName);
+        appendInt(buffer, word.fontProperties);
+        appendInt(buffer, word.isValidWord);
+        appendInt(buffer, word.chars.size());
+        for(int l = 0; l < word.chars.size(); ++l) {
+          const OcrCharResult& character = word.chars[l];
+          appendBox(buffer, character.boundingBox);
+          appendString(buffer, character.unicode);
+          appendInt(buffer, character.hasChoice);
+          appendFloat(buffer, character.certainty);
+        }
+      }
+    }
+  }
+
+  if(!Utils::existsDirectory(cacheDirPath)) {
+    Utils::exec("mkdir -p " + cacheDirPath);
+  }
+  const std::string path = getPath(config, imageHash);
+  std::stringstream tmpPath;
+  tmpPath << path << ".tmp" << getpid() << "_" << (unsigned long)pthread_self();
+  std::ofstream file(tmpPath.str().c_str(),
+      std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!file.is_open()) {
+    std::cout << "WARNING: Couldn't open " << tmpPath.str()
+        << " to cache the OCR results.\n";
+    return;
+  }
+  file.write(buffer.data(), buffer.size());
+  file.close();
+  if(file.fail() || rename(tmpPath.str().c_str(), path.c_str()) != 0) {
+    std::cout << "WARNING: Couldn't cache the OCR results at " << path << ".\n";
+    remove(tmpPath.str().c_str());
+  }
+}
+
+std::string OcrResultCache::getConfig(tesseract::TessBaseAPI* const api) {
+  std::stringstream config;
+  const char* const languages = api->GetInitLanguagesAsString();
+  config << "tesseract " << tesseract::TessBaseAPI::Version() << " "
+      << (languages != NULL ? languages : "") << " psm "
+      << (int)api->GetPageSegMode() << " cache " << version;
+
+  // The language data, identified by each traineddata file's path, size and
+  // modification time so that retraining or replacing one is noticed
+  const std::string datadir = api->tesseract() != NULL ?
+      api->tesseract()->datadir.string() : "";
+  GenericVector<STRING> loadedLanguages;
+  api->GetLoadedLanguagesAsVector(&loadedLanguages);
+  for(int i = 0; i < loadedLanguages.size(); ++i) {
+    const std::string traineddata = datadir
+        + loadedLanguages[i].string() + ".traineddata";
+    struct stat info;
+    config << " " << traineddata;
+    if(stat(traineddata.c_str(), &info) == 0) {
+      config << " " << (long long)info.st_size
+          << " " << (long long)info.st_mtime;
+    } else {
+      config << " missing";
+    }
+  }
+
+  // The parameters MathFinder changes
+  std::vector<std::string> params =
+      TesseractParamManager(api).getParamNames();
+  params.push_back("save_blob_choices");
+  for(int i = 0; i < params.size(); ++i) {
+    STRING value;
+    if(api->GetVariableAsString(params[i].c_str(), &value)) {
+      config << " " << params[i] << "=" << value.string();
+    }
+  }
+  return config.str();
+}
+
+std::string OcrResultCache::getPath(const std::string& config,
+    const unsigned long long& imageHash) {
+  char name[64];
+  snprintf(name, sizeof(name), "%016llx_%016llx.ocr", imageHash,
+      hashString(config));
+  return cacheDirPath + name;
+}
+
+unsigned long long OcrResultCache::hashImage(Pix* image) {
+  const unsigned long long prime = 1099511628211ULL;
+  unsigned long long hash = 14695981039346656037ULL;
+  const int width = pixGetWidth(image);
+  const int height = pixGetHeight(image);
+  const int depth = pixGetDepth(image);
+  const int wpl = pixGetWpl(image);
+  const l_uint32* const data = pixGetData(image);
+  const long bitsPerLine = (long)width * depth;
+  const int fullWords = bitsPerLine / 32;
+  const int extraBits = bitsPerLine % 32;
+  for(int y = 0; y < height; ++y) {
+    const l_uint32* const line = data + (long)y * wpl;
+    for(int i = 0; i < fullWords + (extraBits > 0 ? 1 : 0); ++i) {
+      // pixels are packed from the most significant bit, so the padding is
+      // in the low bits of the last word
+      const l_uint32 word = (i < fullWords) ? line[i]
+          : line[i] & (0xffffffffU << (32 - extraBits));
+      for(int b = 0; b < 4; ++b) {
+        hash ^= (word >> (b * 8)) & 0xff;
+        hash *= prime;
+      }
+    }
+  }
+  PIXCMAP* const colormap = pixGetColormap(image);
+  if(colormap != NULL) {
+    for(int i = 0; i < pixcmapGetCount(colormap); ++i) {
+      l_int32 r = 0, g = 0, b = 0;
+      pixcmapGetColor(colormap, i, &r, &g, &b);
+      const l_int32 rgb[3] = {r, g, b};
+      for(int c = 0; c < 3; ++c) {
+        hash ^= rgb[c] & 0xff;
+        hash *= prime;
+      }
+    }
+  }
+  return hash;
+}
+
+unsigned long long OcrResultCache::hashString(const std::string& str) {
+  unsigned long long hash = 14695981039346656037ULL;
+  for(int i = 0; i < str.size(); ++i) {
+    hash ^= (unsigned char)str[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void OcrResultCache::appendInt(std::string& buffer, const inT32& value) {
+  buffer.append((const char*)&value, sizeof(inT32));
+}
+
+void OcrResultCache::appendFloat(std::string& buffer, const float& value) {
+  buffer.append((const char*)&value, sizeof(float));
+}
+
+void OcrResultCache::appendString(std::string& buffer, const std::string& str) {
+  appendInt(buffer, str.size());
+  buffer.append(str);
+}
+
+void OcrResultCache::appendBox(std::string& buffer, const TBOX& box) {
+  appendInt(buffer, box.left());
+  appendInt(buffer, box.bottom());
+  appendInt(buffer, box.right());
+  appendInt(buffer, box.top());
+}
+
+bool OcrResultCache::readInt(const std::string& buffer, size_t& pos,
+    inT32& value) {
+  if(buffer.size() < pos + sizeof(inT32)) {
+    return false;
+  }
+  memcpy(&value, buffer.data() + pos, sizeof(inT32));
+  pos += sizeof(inT32);
+  return true;
+}
+
+bool OcrResultCache::readFloat(const std::string& buffer, size_t& pos,
+    float& value) {
+  if(buffer.size() < pos + sizeof(float)) {
+    return false;
+  }
+  memcpy(&value, buffer.data() + pos, sizeof(float));
+  pos += sizeof(float);
+  return true;
+}
+
+bool OcrResultCache::readString(const std::string& buffer, size_t& pos,
+    std::string& str) {
+  inT32 size = 0;
+  if(!readCount(buffer, pos, size)) {
+    return false;
+  }
+  str.assign(buffer, pos, size);
+  pos += size;
+  return true;
+}
+
+bool OcrResultCache::readBox(const std::string& buffer, size_t& pos,
+    TBOX& box) {
+  inT32 left = 0, bottom = 0, right = 0, top = 0;
+  if(!(readInt(buffer, pos, left) && readInt(buffer, pos, bottom)
+      && readInt(buffer, pos, right) && readInt(buffer, pos, top))) {
+    return false;
+  }
+  box = TBOX(left, bottom, right, top);
+  return true;
+}
+
+bool OcrResultCache::readCount(const std::string& buffer, size_t& pos,
+    inT32& count) {
+  return readInt(buffer, pos, count) && count >= 0
+      && (size_t)count <= buffer.size() - pos;
+}
+
+bool OcrResultCache::readBlocks(const std::string& buffer, size_t& pos,
+    OcrPageResult& result) {
+  inT32 numBlocks = 0;
+  if(!readCount(buffer, pos, numBlocks)) {
+    return false;
+  }
+  result.blocks.resize(numBlocks);
+  for(int i = 0; i < numBlocks; ++i) {
+    OcrBlockResult& block = result.blocks[i];
+    inT32 numRows = 0;
+    if(!(readBox(buffer, pos, block.boundingBox)
+        && readCount(buffer, pos, numRows))) {
+      return false;
+    }
+    block.rows.resize(numRows);
+    for(int j = 0; j < numRows; ++j) {
+      OcrRowResult& row = block.rows[j];
+      inT32 numSamples = 0;
+      if(!(readBox(buffer, pos, row.boundingBox)
+          && readCount(buffer, pos, numSamples))) {
+        return false;
+      }
+      row.baseline.resize(numSamples);
+      for(int k = 0; k < numSamples; ++k) {
+        if(!readFloat(buffer, pos, row.baseline[k])) {
+          return false;
+        }
+      }
+      inT32 numWords = 0;
+      if(!readCount(buffer, pos, numWords)) {
+        return false;
+      }
+      row.words.resize(numWords);
+      for(int k = 0; k < numWords; ++k) {
+        OcrWordResult& word = row.words[k];
+        inT32 hasText = 0, hasFontInfo = 0, fontProperties = 0,
+            isValidWord = 0, numChars = 0;
+        if(!(readBox(buffer, pos, word.boundingBox)
+            && readInt(buffer, pos, hasText)
+            && readString(buffer, pos, word.text)
+            && readFloat(buffer, pos, word.certainty)
+            && readInt(buffer, pos, hasFontInfo)
+            && readString(buffer, pos, word.fontName)
+            && readInt(buffer, pos, fontProperties)
+            && readInt(buffer, pos, isValidWord)
+            && readCount(buffer, pos, numChars))) {
+          return false;
+        }
+        word.hasText = hasText != 0;
+        word.hasFontInfo = hasFontInfo != 0;
+        word.fontProperties = (uinT32)fontProperties;
+        word.isValidWord = isValidWord != 0;
+        word.chars.resize(numChars);
+        for(int l = 0; l < numChars; ++l) {
+          OcrCharResult& character = word.chars[l];
+          inT32 hasChoice = 0;
+          if(!(readBox(buffer, pos, character.boundingBox)
+              && readString(buffer, pos, character.unicode)
+              && readInt(buffer, pos, hasChoice)
+              && readFloat(buffer, pos, character.certainty))) {
+            return false;
+          }
+          character.hasChoice = hasChoice != 0;
+        }
+      }
+    }
+  }
+  return true;
+}
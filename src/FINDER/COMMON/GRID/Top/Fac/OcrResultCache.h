@@ -0,0 +1,110 @@
+/*
+ * OcrResultCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: jake
+ */
+
+#ifndef OCRRESULTCACHE_H_
+#define OCRRESULTCACHE_H_
+
+#include <OcrPageResult.h>
+
+#include <baseapi.h>
+
+#include <allheaders.h>
+
+#include <string>
+
+/**
+ * Saves the results of running Tesseract's recognition on a page to disk so
+ * that the page's BlobDataGrid can be built again later (when retraining,
+ * changing features, or evaluating another finder on the same pages)
+ * without recognizing it again. There's one file per page, named by a hash
+ * of the page's pixels and of Tesseract's configuration: its version,
+ * languages, tessdata path, the size and modification time of each loaded
+ * traineddata file, and the values of the parameters MathFinder changes
+ * (those managed by TesseractParamManager and save_blob_choices). The file
+ * repeats the configuration and the page's size, and these are checked when
+ * it's read. Anything else that changes Tesseract's output (e.g., a config
+ * file setting some other parameter) isn't noticed, so the cache should be
+ * cleared by hand after such a change.
+ *
+ * Nothing is ever evicted, so the cache is only used when USE_OCR_CACHE is
+ * defined in BlobDataGridFactory.cpp.
+ *
+ * Each file holds, in the byte order of the machine that wrote it:
+ *
+ *   header            - magic, version, the configuration, and the page's
+ *                       width, height, depth and hash
+ *   thresholded image - width, height, depth, resolution, words per line,
+ *                       then the image's raw data
+ *   blocks            - for each block its box and rows, for each row its
+ *                       box, baseline and words, for each word its box,
+ *                       text, certainty, font, validity and characters, and
+ *                       for each character its box, unicode and certainty
+ *
+ * The files are written to a temporary file first and then renamed, so
+ * several threads (or processes) can share the cache.
+ */
+class OcrResultCache {
+ public:
+
+  /**
+   * Cache in the directory at the given path (created when first written to)
+   */
+  OcrResultCache(const std::string& cacheDirPath);
+
+  /**
+   * Reads in the results of recognizing the image with the api's current
+   * configuration. Returns false if they haven't been cached (or the cached
+   * file can't be read), in which case the result is left empty.
+   */
+  bool read(Pix* image, tesseract::TessBaseAPI* const api,
+      OcrPageResult& result);
+
+  /**
+   * Saves the results of recognizing the image with the api's current
+   * configuration
+   */
+  void write(Pix* image, tesseract::TessBaseAPI* const api,
+      const OcrPageResult& result);
+
+ private:
+
+  std::string getConfig(tesseract::TessBaseAPI* const api);
+  std::string getPath(const std::string& config,
+      const unsigned long long& imageHash);
+
+  // FNV-1a over the image's pixels (ignoring the padding at the end of
+  // each line)
+  static unsigned long long hashImage(Pix* image);
+  static unsigned long long hashString(const std::string& str);
+
+  static void appendInt(std::string& buffer, const inT32& value);
+  static void appendFloat(std::string& buffer, const float& value);
+  static void appendString(std::string& buffer, const std::string& str);
+  static void appendBox(std::string& buffer, const TBOX& box);
+
+  // reads from the buffer at the position (advancing it), returning false
+  // if the buffer ends first
+  static bool readInt(const std::string& buffer, size_t& pos, inT32& value);
+  static bool readFloat(const std::string& buffer, size_t& pos, float& value);
+  static bool readString(const std::string& buffer, size_t& pos,
+      std::string& str);
+  static bool readBox(const std::string& buffer, size_t& pos, TBOX& box);
+  // reads in a count, also returning false if it's negative or larger than
+  // what's left of the buffer (i.e., the file is corrupted)
+  static bool readCount(const std::string& buffer, size_t& pos, inT32& count);
+
+  static bool readBlocks(const std::string& buffer, size_t& pos,
+      OcrPageResult& result);
+
+  static const char magic[8];
+  static const inT32 version = 2;
+
+  std::string cacheDirPath;
+};
+
+
+#endif /* OCRRESULTCACHE_H_ */
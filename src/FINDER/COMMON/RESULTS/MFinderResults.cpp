@@ -20,6 +20,10 @@
 #include <vector>
 #include <stddef.h>
 
+// saves the colored images used for evaluation to the coloredEval subdir (the
+// evaluator colors these itself from results.rect so they're just for debugging)
+//#define SAVE_COLORED_EVAL_IMAGES
+
 /**
  * Constructor (only invoked by builder)
  */
@@ -93,6 +97,17 @@ void MathExpressionFinderResults::displaySegmentationResults() {
 void MathExpressionFinderResults::printResultsToFiles(
     const std::vector<MathExpressionFinderResults*>& results,
     const std::string& resultsDirPath_) {
+  std::ofstream rectstream;
+  const std::string resultsDirPath = createResultsFiles(resultsDirPath_, rectstream);
+  for(int i = 0; i < results.size(); ++i) {
+    results[i]->printToFiles(rectstream, resultsDirPath);
+  }
+  rectstream.close();
+}
+
+std::string MathExpressionFinderResults::createResultsFiles(
+    const std::string& resultsDirPath_,
+    std::ofstream& rectstream) {
 
   // Clear existing results directory and make new one to put results in
   if(Utils::existsDirectory(resultsDirPath_)) {
@@ -102,49 +117,50 @@ void MathExpressionFinderResults::printResultsToFiles(
   std::cout << "Creating results directory at " << resultsDirPath_ << std::endl;
 
   const std::string resultsDirPath = Utils::checkTrailingSlash(resultsDirPath_);
+#ifdef SAVE_COLORED_EVAL_IMAGES
+  Utils::exec(std::string("mkdir -p ") + resultsDirPath + std::string("coloredEval/"));
+#endif
   const std::string rectfile = resultsDirPath + std::string("results.rect");
   // save the results for all images into a file in the following format:
-   // #.ext type left top right bottom
-   std::ofstream rectstream(rectfile.c_str());
-
-  for(int i = 0; i < results.size(); ++i) {
-
-    MathExpressionFinderResults* const imageResults = results[i];
-
-    const std::string imgname = resultsDirPath + imageResults->getResultsName();
-
-    // make sure no duplicate regions in segmentation results (sanity check)
-    imageResults->ensureNoDuplicates();
-
-    // print the segmentation results to the rect file
-    GenericVector<Segmentation*> segmentationResults = imageResults->getSegmentationResults();
-    for(int j = 0; j < segmentationResults.length(); ++j) {
-      const Segmentation* seg = segmentationResults[j];
-      BOX* bbox = M_Utils::tessTBoxToImBox(seg->box, imageResults->getVisualResultsDisplay());
-      const RESULT_TYPE restype = seg->res;
-      rectstream << imageResults->getResultsName() << " " <<
-          ((restype == DISPLAYED) ? "displayed" : (restype == EMBEDDED)
-              ? "embedded" : "label") << " " << bbox->x << " " << bbox->y
-              << " " << bbox->x + bbox->w << " " << bbox->y + bbox->h << std::endl;
-      boxDestroy(&bbox);
-    }
-
-    // save the images
-    pixWrite((imgname + (std::string)".png").c_str(),
-        imageResults->getVisualResultsDisplay(),
-        IFF_PNG);
-    const std::string evalColoredDir = resultsDirPath + std::string("coloredEval/");
-    Utils::exec(std::string("mkdir -p ") + evalColoredDir);
-    const std::string evalColoredIm = evalColoredDir + imageResults->getResultsName();
-    pixWrite((evalColoredIm + (std::string)".png").c_str(),
-        imageResults->getVisualResultsEvalDisplay(),
-        IFF_PNG);
-
-    // flush file stream
-    rectstream.flush();
+  // #.ext type left top right bottom
+  rectstream.open(rectfile.c_str());
+  return resultsDirPath;
+}
+
+void MathExpressionFinderResults::printToFiles(
+    std::ofstream& rectstream,
+    const std::string& resultsDirPath) {
+
+  const std::string imgname = resultsDirPath + resultsName;
+
+  // make sure no duplicate regions in segmentation results (sanity check)
+  ensureNoDuplicates();
+
+  // print the segmentation results to the rect file
+  for(int j = 0; j < segmentationResults.length(); ++j) {
+    const Segmentation* seg = segmentationResults[j];
+    BOX* bbox = M_Utils::tessTBoxToImBox(seg->box, visualResultsDisplay);
+    const RESULT_TYPE restype = seg->res;
+    rectstream << resultsName << " " <<
+        ((restype == DISPLAYED) ? "displayed" : (restype == EMBEDDED)
+            ? "embedded" : "label") << " " << bbox->x << " " << bbox->y
+            << " " << bbox->x + bbox->w << " " << bbox->y + bbox->h << std::endl;
+    boxDestroy(&bbox);
   }
 
-  rectstream.close();
+  // save the images
+  pixWrite((imgname + (std::string)".png").c_str(),
+      visualResultsDisplay,
+      IFF_PNG);
+#ifdef SAVE_COLORED_EVAL_IMAGES
+  const std::string evalColoredIm = resultsDirPath + std::string("coloredEval/") + resultsName;
+  pixWrite((evalColoredIm + (std::string)".png").c_str(),
+      visualResultsEvalDisplay,
+      IFF_PNG);
+#endif
+
+  // flush file stream
+  rectstream.flush();
 }
 
 
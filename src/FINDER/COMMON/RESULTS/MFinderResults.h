@@ -16,6 +16,7 @@
 
 #include <string>
 #include <vector>
+#include <fstream>
 
 /**
  * Specifies how the application is run. If in "DETECT" mode
@@ -67,6 +68,19 @@ class MathExpressionFinderResults {
       const std::vector<MathExpressionFinderResults*>& results,
       const std::string& resultsDirName);
 
+  // creates a fresh results directory at the given path (removing any existing
+  // one) and opens the rect file in it that each image's results are printed to.
+  // returns the directory path with a trailing slash
+  static std::string createResultsFiles(
+      const std::string& resultsDirName,
+      std::ofstream& rectstream);
+
+  // prints just these results (one image) to the rect file and saves its images
+  // into the results directory created by createResultsFiles
+  void printToFiles(
+      std::ofstream& rectstream,
+      const std::string& resultsDirPath);
+
  private:
   void ensureNoDuplicates();
 
@@ -192,6 +192,17 @@ void TesseractParamManager::setPageSegmentationMode(const tesseract::PageSegMode
   assert(psm == mode);
 }
 
+/****************************************************************************
+ * The names of all the parameters managed here (bool, int, and the page
+ * segmentation mode)
+ ****************************************************************************/
+std::vector<std::string> TesseractParamManager::getParamNames() const {
+  std::vector<std::string> names(boolparams);
+  names.insert(names.end(), intparams.begin(), intparams.end());
+  names.push_back(page_seg_mode);
+  return names;
+}
+
 void TesseractParamManager::tessParamError(std::string str) {
   std::cout << "ERROR " << str << std::endl;
 }
@@ -78,6 +78,12 @@ public:
    ****************************************************************************/
   void setPageSegmentationMode(const tesseract::PageSegMode mode);
 
+  /****************************************************************************
+   * The names of all the parameters managed here (bool, int, and the page
+   * segmentation mode)
+   ****************************************************************************/
+  std::vector<std::string> getParamNames() const;
+
  private:
 
   void init();
@@ -30,6 +30,7 @@
 #include <baseapi.h>
 #include <iomanip>
 #include <locale.h>
+#include <unistd.h>
 
 // convert integer to string
 std::string Utils::intToString(int i) {
@@ -393,6 +394,11 @@ bool Utils::existsDirectory(const std::string& dirname) {
   return false;
 }
 
+int Utils::getNumProcessors() {
+  const long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+  return (numProcessors < 1) ? 1 : (int)numProcessors;
+}
+
 bool Utils::promptYesNo() {
   std::string input = "";
   while(input != "y" && input != "Y"
@@ -474,6 +480,10 @@ std::string Utils::getGroundtruthRoot() {
   return checkTrailingSlash(getHomeDir()) + std::string(".mathfinder/groundtruth/");
 }
 
+std::string Utils::getOcrCacheRoot() {
+  return checkTrailingSlash(getHomeDir()) + std::string(".mathfinder/ocrcache/");
+}
+
 std::string Utils::getNameFromPath(const std::string& path) {
   const std::string::size_type dotIndex = path.find_last_of(".");
   const std::string::size_type slashIndex = path.find_last_of("/");
@@ -156,11 +156,18 @@ namespace Utils {
   std::string getTrainingRoot();
   std::string getGroundtruthRoot();
 
+  // where Tesseract's recognition results are cached (see OcrResultCache)
+  std::string getOcrCacheRoot();
+
   // pulls out the name from the full path which includes an extension
   // so for instance, passing in "/home/bob/imname.jpg" would output
   // "imname".
   std::string getNameFromPath(const std::string& path);
 
+  // number of processors that are currently online (at least 1), used as
+  // the number of threads to run when nothing else limits it
+  int getNumProcessors();
+
   /*****************************************
    * Console interface utilities           *
    ****************************************/
@@ -2242,7 +2242,7 @@ void TessBaseAPI::setEquationDetector(EquationDetectBase* equ_detect) {
   equ_detect_ = equ_detect;
 }
 
-const PAGE_RES* TessBaseAPI::extGetPageResults() {
+PAGE_RES* TessBaseAPI::extGetPageResults() {
   return page_res_;
 }
 
@@ -687,7 +687,7 @@ class TESS_API TessBaseAPI {
     return equ_detect_;
   }
 
-  const PAGE_RES* extGetPageResults();
+  PAGE_RES* extGetPageResults();
 
   inline GenericVector<ParagraphModel*>* getParagraphModels() {
     return paragraph_models_;